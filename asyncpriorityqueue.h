@@ -0,0 +1,406 @@
+// ============================================================================
+// File: asyncpriorityqueue.h
+// ============================================================================
+// Header file for the AsyncPriorityQueue class, a heap that coroutines can
+// wait on:
+//
+//      std::optional<Job> job = co_await queue.Pop();
+//
+// suspends the calling coroutine, not its thread, while the queue is empty.
+// A waiter is an awaiter object linked into an intrusive list inside the
+// waiting coroutine's frame, so thousands of waiting consumers cost no
+// threads and no allocations beyond their frames.
+//
+// Push wakes the oldest waiter through the queue's executor and reserves an
+// item for it, but the waiter takes the item only when it runs: it gets
+// the best item available at that moment. Waiters resumed one after another
+// therefore receive items in priority order, whatever order the items were
+// pushed in. Pop returns no value once the queue is closed and drained.
+//
+// All members may be called from any thread. The queue must outlive its
+// waiters; Close resumes them all. Requires C++20.
+// ============================================================================
+#ifndef ASYNCPRIORITYQUEUE_H
+#define ASYNCPRIORITYQUEUE_H
+
+#if (__cplusplus < 202002L) && !(defined(_MSVC_LANG) && (_MSVC_LANG >= 202002L))
+#error "asyncpriorityqueue.h requires C++20 coroutines (compile with -std=c++20 or later)"
+#endif
+
+#include    <coroutine>
+#include    <mutex>
+#include    <optional>
+#include    <utility>
+#include    "casyncexecutor.h"
+#include    "cmaxminheap.h"
+
+
+// class declaration
+template <class HeapItemType, class HeapType = CMaxMinHeap<HeapItemType>>
+class   AsyncPriorityQueue
+{
+public:
+    // awaitable returned by Pop
+    class   CPopAwaiter
+    {
+    public:
+        bool                        await_ready(void) const noexcept { return false; }
+        bool                        await_suspend(std::coroutine_handle<> handle);
+        std::optional<HeapItemType> await_resume(void);
+
+    private:
+        friend class AsyncPriorityQueue;
+
+        CPopAwaiter(AsyncPriorityQueue *queue)
+                  : m_queue(queue), m_next(NULL), m_reserved(false) {}
+
+        AsyncPriorityQueue          *m_queue;   // the queue awaited
+        CPopAwaiter                 *m_next;    // next waiter in the list
+        std::coroutine_handle<>     m_handle;   // the waiting coroutine
+        bool                        m_reserved; // an item is held for it
+        std::optional<HeapItemType> m_item;     // taken without suspending
+    };
+
+    // constructor and destructor
+    AsyncPriorityQueue(CAsyncExecutor &executor, int heapType = MAX);
+    virtual ~AsyncPriorityQueue();
+
+    // member functions
+    bool            Push(const HeapItemType  &newItem);
+    CPopAwaiter     Pop(void) { return CPopAwaiter(this); }
+    std::optional<HeapItemType> TryPop(void);
+    void            Close(void);
+
+    // Helper functions
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    int             GetNumWaiters(void) const;
+    bool            IsClosed(void) const;
+
+private:
+    // data members
+    CAsyncExecutor      *m_executor;        // resumes woken waiters
+    mutable std::mutex  m_lock;             // guards the members below
+    HeapType            m_heap;             // the items, in heap order
+    int                 m_numReserved;      // items held for woken waiters
+    CPopAwaiter         *m_firstWaiter;     // oldest waiter
+    CPopAwaiter         *m_lastWaiter;      // newest waiter
+    int                 m_numWaiters;       // length of the waiter list
+    bool                m_closed;           // set by Close
+
+    // no copying: waiters point at the queue
+    AsyncPriorityQueue(const AsyncPriorityQueue &);
+    AsyncPriorityQueue&     operator=(const AsyncPriorityQueue &);
+
+    // utility functions
+    CPopAwaiter*    UnlinkFirstWaiter(void);
+};
+
+
+// ==== AsyncPriorityQueue::AsyncPriorityQueue ================================
+//
+// This is the constructor.
+//
+// Input:
+//      executor    -- [IN]: resumes the waiters that Push and Close wake
+//      heapType    -- [IN]: MAX or MIN
+//
+// ============================================================================
+template <class HeapItemType, class HeapType>
+AsyncPriorityQueue<HeapItemType, HeapType>::AsyncPriorityQueue(CAsyncExecutor &executor,
+                                                               int heapType)
+: m_executor(&executor), m_heap(heapType), m_numReserved(0),
+  m_firstWaiter(NULL), m_lastWaiter(NULL), m_numWaiters(0), m_closed(false)
+{
+}
+// end of AsyncPriorityQueue::AsyncPriorityQueue()
+
+
+// ==== AsyncPriorityQueue::~AsyncPriorityQueue ===============================
+//
+// This is the destructor. Waiters still suspended are not resumed; Close
+// the queue and let them run first.
+//
+// ============================================================================
+template <class HeapItemType, class HeapType>
+AsyncPriorityQueue<HeapItemType, HeapType>::~AsyncPriorityQueue()
+{
+}
+// end of AsyncPriorityQueue::~AsyncPriorityQueue()
+
+
+// ==== AsyncPriorityQueue::UnlinkFirstWaiter =================================
+//
+// This function removes the oldest waiter from the list. The lock must be
+// held.
+//
+// Input:
+//      void
+//
+// Output:
+//      CPopAwaiter* -- [OUT]: the waiter, NULL if there is none
+// ============================================================================
+template <class HeapItemType, class HeapType>
+typename AsyncPriorityQueue<HeapItemType, HeapType>::CPopAwaiter*
+AsyncPriorityQueue<HeapItemType, HeapType>::UnlinkFirstWaiter(void)
+{
+    CPopAwaiter *waiter = m_firstWaiter;
+
+    if (waiter != NULL)
+    {
+        m_firstWaiter = waiter->m_next;
+        if (m_firstWaiter == NULL)
+        {
+            m_lastWaiter = NULL;
+        }
+        --m_numWaiters;
+    }
+
+    return waiter;
+}
+// end of AsyncPriorityQueue::UnlinkFirstWaiter()
+
+
+// ==== AsyncPriorityQueue::Push ==============================================
+//
+// This function inserts an element and, if a coroutine is waiting, reserves
+// an item for the oldest waiter and posts it to the executor.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if the queue is closed; the heap's exceptions
+//              are passed on
+// ============================================================================
+template <class HeapItemType, class HeapType>
+bool AsyncPriorityQueue<HeapItemType, HeapType>::Push(const HeapItemType  &newItem)
+{
+    std::coroutine_handle<> handle;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if (m_closed)
+        {
+            return false;
+        }
+
+        m_heap.Insert(newItem);
+
+        CPopAwaiter *waiter = UnlinkFirstWaiter();
+        if (waiter == NULL)
+        {
+            return true;
+        }
+
+        waiter->m_reserved = true;
+        ++m_numReserved;
+        handle = waiter->m_handle;
+    }
+
+    m_executor->Post(handle);
+
+    return true;
+}
+// end of AsyncPriorityQueue::Push()
+
+
+// ==== AsyncPriorityQueue::TryPop ============================================
+//
+// This function removes the top element without waiting. Items reserved
+// for woken waiters are not available.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no
+//                                     value if none is available
+// ============================================================================
+template <class HeapItemType, class HeapType>
+std::optional<HeapItemType> AsyncPriorityQueue<HeapItemType, HeapType>::TryPop(void)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    HeapItemType item;
+
+    if (m_heap.GetNumItems() <= m_numReserved)
+    {
+        return std::nullopt;
+    }
+
+    m_heap.Remove(item);
+
+    return item;
+}
+// end of AsyncPriorityQueue::TryPop()
+
+
+// ==== AsyncPriorityQueue::Close =============================================
+//
+// This function closes the queue: Push fails from now on, and every waiter
+// is resumed with no value. Items already queued can still be popped.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapType>
+void AsyncPriorityQueue<HeapItemType, HeapType>::Close(void)
+{
+    CPopAwaiter *waiters = NULL;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_closed = true;
+        waiters = m_firstWaiter;
+        m_firstWaiter = m_lastWaiter = NULL;
+        m_numWaiters = 0;
+    }
+
+    // a resumed waiter may finish and free its frame at once, so read the
+    // link before posting
+    while (waiters != NULL)
+    {
+        CPopAwaiter *next = waiters->m_next;
+        m_executor->Post(waiters->m_handle);
+        waiters = next;
+    }
+}
+// end of AsyncPriorityQueue::Close()
+
+
+// ==== AsyncPriorityQueue::CPopAwaiter::await_suspend ========================
+//
+// This function takes an available item without suspending, or links the
+// coroutine into the waiter list.
+//
+// Input:
+//      handle  -- [IN]: the awaiting coroutine
+//
+// Output:
+//      bool -- [OUT]: true if the coroutine stays suspended
+// ============================================================================
+template <class HeapItemType, class HeapType>
+bool AsyncPriorityQueue<HeapItemType, HeapType>::CPopAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> guard(m_queue->m_lock);
+
+    if (m_queue->m_heap.GetNumItems() > m_queue->m_numReserved)
+    {
+        HeapItemType item;
+        m_queue->m_heap.Remove(item);
+        m_item = std::move(item);
+        return false;
+    }
+
+    if (m_queue->m_closed)
+    {
+        return false;
+    }
+
+    // once the lock is released another thread may resume the coroutine
+    // and free this awaiter, so nothing below may touch it
+    m_handle = handle;
+    if (m_queue->m_lastWaiter == NULL)
+    {
+        m_queue->m_firstWaiter = this;
+    }
+    else
+    {
+        m_queue->m_lastWaiter->m_next = this;
+    }
+    m_queue->m_lastWaiter = this;
+    ++m_queue->m_numWaiters;
+
+    return true;
+}
+// end of AsyncPriorityQueue::CPopAwaiter::await_suspend()
+
+
+// ==== AsyncPriorityQueue::CPopAwaiter::await_resume =========================
+//
+// This function delivers the item to the resumed coroutine. A waiter woken
+// by Push takes the best item in the queue now, not the one pushed.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the item, or no value if the
+//                                     queue was closed and empty
+// ============================================================================
+template <class HeapItemType, class HeapType>
+std::optional<HeapItemType> AsyncPriorityQueue<HeapItemType, HeapType>::CPopAwaiter::await_resume(void)
+{
+    if (m_reserved)
+    {
+        std::lock_guard<std::mutex> guard(m_queue->m_lock);
+        HeapItemType item;
+
+        m_queue->m_heap.Remove(item);
+        --m_queue->m_numReserved;
+
+        return item;
+    }
+
+    return std::move(m_item);
+}
+// end of AsyncPriorityQueue::CPopAwaiter::await_resume()
+
+
+// ==== AsyncPriorityQueue::GetHeapType =======================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType, class HeapType>
+int AsyncPriorityQueue<HeapItemType, HeapType>::GetHeapType(void) const
+{
+    return m_heap.GetHeapType();
+}
+// end of AsyncPriorityQueue::GetHeapType()
+
+
+// ==== AsyncPriorityQueue::GetNumItems =======================================
+//
+// This function returns the number of items available to new Pops.
+// ============================================================================
+template <class HeapItemType, class HeapType>
+int AsyncPriorityQueue<HeapItemType, HeapType>::GetNumItems(void) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    return m_heap.GetNumItems() - m_numReserved;
+}
+// end of AsyncPriorityQueue::GetNumItems()
+
+
+// ==== AsyncPriorityQueue::GetNumWaiters =====================================
+//
+// This function returns the number of suspended Pops.
+// ============================================================================
+template <class HeapItemType, class HeapType>
+int AsyncPriorityQueue<HeapItemType, HeapType>::GetNumWaiters(void) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    return m_numWaiters;
+}
+// end of AsyncPriorityQueue::GetNumWaiters()
+
+
+// ==== AsyncPriorityQueue::IsClosed ==========================================
+//
+// This function returns a boolean value if the queue is closed.
+// ============================================================================
+template <class HeapItemType, class HeapType>
+bool AsyncPriorityQueue<HeapItemType, HeapType>::IsClosed(void) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    return m_closed;
+}
+// end of AsyncPriorityQueue::IsClosed()
+
+#endif // ASYNCPRIORITYQUEUE_H
@@ -0,0 +1,298 @@
+// ============================================================================
+// File: asyncqueuetest.cpp
+// ============================================================================
+// This is a driver that checks AsyncPriorityQueue with both executors:
+// waiters woken in priority order whatever the push order, Pop without
+// suspending, TryPop skipping reserved items, Close waking every waiter,
+// MIN queues, and many consumers and producers on a CThreadPoolExecutor.
+// It needs C++20 (compile with -std=c++20).
+//
+//      asyncqueuetest
+//              runs every check; prints the failures and exits with 1 if
+//              there are any
+// ============================================================================
+
+#include    <iostream>
+#include    <atomic>
+#include    <optional>
+#include    <thread>
+#include    <vector>
+using namespace std;
+#include    "asyncpriorityqueue.h"
+
+// constants
+const   int     NUM_POOL_THREADS = 4;
+const   int     NUM_POOL_WORKERS = 100;     // consumer coroutines on the pool
+const   int     NUM_PRODUCERS = 4;
+const   int     ITEMS_PER_PRODUCER = 10000;
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== PopOnce ===============================================================
+//
+// This coroutine pops one item and appends it to popped, -1 if the queue
+// was closed.
+//
+// Input:
+//      queue       -- [IN/OUT]: the queue
+//      popped      -- [OUT]: receives the item
+//
+// Output:
+//      CAsyncTask -- [OUT]: the detached coroutine
+// ============================================================================
+CAsyncTask  PopOnce(AsyncPriorityQueue<int> &queue, vector<int> &popped)
+{
+    optional<int> item = co_await queue.Pop();
+
+    popped.push_back(item ? *item : -1);
+}
+// end of PopOnce()
+
+
+// ==== PopUntilClosed ========================================================
+//
+// This coroutine moves onto the pool and then pops items until the queue is
+// closed and drained, adding them up.
+//
+// Input:
+//      pool        -- [IN]: the executor to run on
+//      queue       -- [IN/OUT]: the queue
+//      sum         -- [OUT]: the sum of the items popped
+//      numDone     -- [OUT]: counts the coroutines that saw the close
+//
+// Output:
+//      CAsyncTask -- [OUT]: the detached coroutine
+// ============================================================================
+CAsyncTask  PopUntilClosed(CThreadPoolExecutor &pool, AsyncPriorityQueue<int> &queue,
+                           atomic<long long> &sum, atomic<int> &numDone)
+{
+    co_await pool.Schedule();
+
+    for (;;)
+    {
+        optional<int> item = co_await queue.Pop();
+        if (!item)
+        {
+            break;
+        }
+        sum += *item;
+    }
+    ++numDone;
+}
+// end of PopUntilClosed()
+
+
+// ==== CheckPriorityWakeups ==================================================
+//
+// This function suspends consumers on an empty queue, pushes items out of
+// order and checks the consumers, resumed oldest first, get them best first.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckPriorityWakeups(void)
+{
+    CSingleThreadExecutor       executor;
+    AsyncPriorityQueue<int>     queue(executor);
+    vector<int>                 popped;
+
+    for (int index = 0; index < 3; ++index)
+    {
+        PopOnce(queue, popped);
+    }
+    Check(queue.GetNumWaiters() == 3, "Pop on an empty queue suspends");
+
+    queue.Push(5);
+    queue.Push(1);
+    queue.Push(9);
+    Check((queue.GetNumItems() == 0) && !queue.TryPop(),
+          "items pushed for waiters are reserved");
+    Check(popped.empty(), "a woken waiter runs on its executor, not in Push");
+
+    Check(executor.Run() == 3, "every woken waiter is resumed");
+    Check(popped == vector<int>({ 9, 5, 1 }), "waiters get the items best first");
+
+    for (int index = 0; index < 5000; ++index)
+    {
+        PopOnce(queue, popped);
+    }
+    for (int item = 0; item < 4000; ++item)
+    {
+        queue.Push(item);
+    }
+    executor.Run();
+
+    bool inOrder = (popped.size() == 4003);
+    for (size_t index = 4; inOrder && (index < popped.size()); ++index)
+    {
+        inOrder = (popped[index] < popped[index - 1]);
+    }
+    Check(inOrder && (popped[3] == 3999), "thousands of waiters wake best first");
+    Check(queue.GetNumWaiters() == 1000, "the waiters left over keep waiting");
+
+    queue.Close();
+    executor.Run();
+    Check((popped.size() == 5003) && (popped.back() == -1),
+          "Close wakes every waiter with no value");
+}
+// end of CheckPriorityWakeups()
+
+
+// ==== CheckPopPushClose =====================================================
+//
+// This function checks Pop on a queue with items, TryPop, a MIN queue, and
+// Push and Pop on a closed queue.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckPopPushClose(void)
+{
+    CSingleThreadExecutor       executor;
+    AsyncPriorityQueue<int>     queue(executor, MIN);
+    vector<int>                 popped;
+
+    Check(queue.GetHeapType() == MIN, "the queue keeps its heap type");
+    Check(queue.Push(3) && queue.Push(2) && queue.Push(7), "Push on an open queue");
+    Check(queue.GetNumItems() == 3, "the queue counts its items");
+
+    PopOnce(queue, popped);
+    Check((popped.size() == 1) && (popped[0] == 2) && (executor.Run() == 0),
+          "Pop with items ready does not suspend");
+
+    optional<int> item = queue.TryPop();
+    Check(item && (*item == 3), "TryPop takes the best item");
+
+    queue.Close();
+    Check(queue.IsClosed() && !queue.Push(1), "Push on a closed queue fails");
+
+    PopOnce(queue, popped);
+    PopOnce(queue, popped);
+    Check((popped.size() == 3) && (popped[1] == 7) && (popped[2] == -1),
+          "a closed queue is drained, then Pop returns no value");
+    Check(queue.GetNumWaiters() == 0, "Pop on a closed queue does not wait");
+}
+// end of CheckPopPushClose()
+
+
+// ==== CheckThreadPool =======================================================
+//
+// This function runs many consumer coroutines on a CThreadPoolExecutor
+// while producer threads push, and checks every item is popped exactly once
+// and Close lets every consumer finish.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckThreadPool(void)
+{
+    for (int round = 0; round < 10; ++round)
+    {
+        atomic<long long>       sum(0);
+        atomic<int>             numDone(0);
+        CThreadPoolExecutor     pool(NUM_POOL_THREADS);
+        AsyncPriorityQueue<int> queue(pool);
+        vector<thread>          producers;
+
+        for (int index = 0; index < NUM_POOL_WORKERS; ++index)
+        {
+            PopUntilClosed(pool, queue, sum, numDone);
+        }
+        for (int index = 0; index < NUM_PRODUCERS; ++index)
+        {
+            producers.emplace_back([&queue]
+                                   {
+                                       for (int item = 1;
+                                            item <= ITEMS_PER_PRODUCER; ++item)
+                                       {
+                                           queue.Push(item);
+                                       }
+                                   });
+        }
+        for (thread &producer : producers)
+        {
+            producer.join();
+        }
+
+        // Close only once every item has been taken
+        while ((queue.GetNumItems() > 0)
+               || (queue.GetNumWaiters() < NUM_POOL_WORKERS))
+        {
+            this_thread::yield();
+        }
+        queue.Close();
+        while (numDone < NUM_POOL_WORKERS)
+        {
+            this_thread::yield();
+        }
+
+        long long expected = static_cast<long long>(NUM_PRODUCERS)
+                             * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2;
+        if (!Check(sum == expected, "the pool pops every item exactly once"))
+        {
+            return;
+        }
+    }
+}
+// end of CheckThreadPool()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(void)
+{
+    CheckPriorityWakeups();
+    CheckPopPushClose();
+    CheckThreadPool();
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all async queue checks passed" << endl;
+    return 0;
+}
+// end of main()
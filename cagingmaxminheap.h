@@ -0,0 +1,313 @@
+// ============================================================================
+// File: cagingmaxminheap.h
+// ============================================================================
+// Header file for the CAgingMaxMinHeap class, a heap whose elements gain
+// priority while they wait.
+//
+// The effective priority of an element is
+//
+//      MAX heap:   priority + agingRate * (epoch - enqueueEpoch)
+//      MIN heap:   priority - agingRate * (epoch - enqueueEpoch)
+//
+// where epoch is a counter advanced by Tick. Every element ages at the same
+// rate, so the order of two elements never changes with time: the heap
+// stores the time-independent key
+//
+//      MAX heap:   priority - agingRate * enqueueEpoch
+//      MIN heap:   priority + agingRate * enqueueEpoch
+//
+// and the effective priority is the key plus (or minus) agingRate * epoch.
+// Tick is therefore O(1) and the heap is never rebuilt.
+//
+// Keys are long long for integral priorities and double for floating point
+// ones; agingRate * epoch must stay within the range of the key type.
+// ============================================================================
+#ifndef CAGINGMAXMINHEAP_H
+#define CAGINGMAXMINHEAP_H
+
+#include    <type_traits>
+#include    "cmaxminheap.h"
+#include    "heapkey.h"
+
+
+// an element with its aging key
+template <class HeapItemType, class KeyType>
+struct  CAgingEntry
+{
+    KeyType         m_key;  // time-independent ordering key
+    HeapItemType    m_item; // the element
+};
+
+template <class HeapItemType, class KeyType>
+bool operator<(const CAgingEntry<HeapItemType, KeyType> &lhs,
+               const CAgingEntry<HeapItemType, KeyType> &rhs)
+{
+    return (lhs.m_key < rhs.m_key);
+}
+
+template <class HeapItemType, class KeyType>
+bool operator>(const CAgingEntry<HeapItemType, KeyType> &lhs,
+               const CAgingEntry<HeapItemType, KeyType> &rhs)
+{
+    return (lhs.m_key > rhs.m_key);
+}
+
+template <class HeapItemType, class KeyType>
+bool operator==(const CAgingEntry<HeapItemType, KeyType> &lhs,
+                const CAgingEntry<HeapItemType, KeyType> &rhs)
+{
+    return (lhs.m_key == rhs.m_key);
+}
+
+
+// class declaration
+template <class HeapItemType, class PriorityOf = CDefaultPriorityOf>
+class   CAgingMaxMinHeap
+{
+public:
+    // priority and key types
+    typedef typename std::decay<decltype(std::declval<PriorityOf>()(
+                     std::declval<const HeapItemType &>()))>::type PriorityType;
+    typedef typename std::conditional<std::is_floating_point<PriorityType>::value,
+                                      double, long long>::type     KeyType;
+
+    // constructor and destructor
+    CAgingMaxMinHeap(int heapType = MAX, KeyType agingRate = 1,
+                     PriorityOf priorityOf = PriorityOf());
+    virtual ~CAgingMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+    KeyType         PeekTopPriority(void) const;
+    void            Tick(long long numTicks = 1);
+
+    // Helper functions
+    long long       GetEpoch(void) const;
+    KeyType         GetAgingRate(void) const;
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    typedef CAgingEntry<HeapItemType, KeyType>  EntryType;
+
+    // data members
+    int                     m_heapType;     // MAX or MIN
+    KeyType                 m_agingRate;    // priority gained per tick
+    long long               m_epoch;        // ticks so far
+    PriorityOf              m_priorityOf;   // element -> base priority
+    CMaxMinHeap<EntryType>  m_heap;         // entries ordered by key
+};
+
+
+// ==== CAgingMaxMinHeap::CAgingMaxMinHeap ====================================
+//
+// This is the constructor.
+//
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+CAgingMaxMinHeap<HeapItemType, PriorityOf>::CAgingMaxMinHeap(int heapType,
+                                                             KeyType agingRate,
+                                                             PriorityOf priorityOf)
+: m_heapType(heapType), m_agingRate(agingRate), m_epoch(0),
+  m_priorityOf(priorityOf), m_heap(heapType)
+{
+}
+// end of CAgingMaxMinHeap::CAgingMaxMinHeap()
+
+
+// ==== CAgingMaxMinHeap::~CAgingMaxMinHeap ===================================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+CAgingMaxMinHeap<HeapItemType, PriorityOf>::~CAgingMaxMinHeap()
+{
+}
+// end of CAgingMaxMinHeap::~CAgingMaxMinHeap()
+
+
+// ==== CAgingMaxMinHeap::Insert ==============================================
+//
+// This function inserts an element, enqueued at the current epoch.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true when the item was inserted
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+bool CAgingMaxMinHeap<HeapItemType, PriorityOf>::Insert(const HeapItemType  &newItem)
+{
+    EntryType entry;
+    KeyType priority = static_cast<KeyType>(m_priorityOf(newItem));
+    KeyType aging = m_agingRate * static_cast<KeyType>(m_epoch);
+
+    entry.m_key = (m_heapType == MAX) ? (priority - aging) : (priority + aging);
+    entry.m_item = newItem;
+
+    return m_heap.Insert(entry);
+}
+// end of CAgingMaxMinHeap::Insert()
+
+
+// ==== CAgingMaxMinHeap::Remove ==============================================
+//
+// This function removes the element with the highest effective priority.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true when an element was removed
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+bool CAgingMaxMinHeap<HeapItemType, PriorityOf>::Remove(HeapItemType &item)
+{
+    EntryType entry;
+
+    m_heap.Remove(entry);
+    item = std::move(entry.m_item);
+
+    return true;
+}
+// end of CAgingMaxMinHeap::Remove()
+
+
+// ==== CAgingMaxMinHeap::PeekTop =============================================
+//
+// This function peeks the element with the highest effective priority.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+HeapItemType CAgingMaxMinHeap<HeapItemType, PriorityOf>::PeekTop(void) const
+{
+    const EntryType *top = m_heap.TryPeek();
+
+    if (top == NULL)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return top->m_item;
+}
+// end of CAgingMaxMinHeap::PeekTop()
+
+
+// ==== CAgingMaxMinHeap::PeekTopPriority =====================================
+//
+// This function returns the effective priority of the top element at the
+// current epoch.
+//
+// Input:
+//      void
+//
+// Output:
+//      KeyType -- [OUT]: the effective priority
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+typename CAgingMaxMinHeap<HeapItemType, PriorityOf>::KeyType
+CAgingMaxMinHeap<HeapItemType, PriorityOf>::PeekTopPriority(void) const
+{
+    const EntryType *top = m_heap.TryPeek();
+
+    if (top == NULL)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    KeyType aging = m_agingRate * static_cast<KeyType>(m_epoch);
+
+    return (m_heapType == MAX) ? (top->m_key + aging) : (top->m_key - aging);
+}
+// end of CAgingMaxMinHeap::PeekTopPriority()
+
+
+// ==== CAgingMaxMinHeap::Tick ================================================
+//
+// This function advances the epoch, aging every element in O(1).
+//
+// Input:
+//      numTicks    -- [IN]: the number of ticks to advance
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+void CAgingMaxMinHeap<HeapItemType, PriorityOf>::Tick(long long numTicks)
+{
+    m_epoch += numTicks;
+}
+// end of CAgingMaxMinHeap::Tick()
+
+
+// ==== CAgingMaxMinHeap::GetEpoch ============================================
+//
+// This function returns the number of ticks so far.
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+long long CAgingMaxMinHeap<HeapItemType, PriorityOf>::GetEpoch(void) const
+{
+    return m_epoch;
+}
+// end of CAgingMaxMinHeap::GetEpoch()
+
+
+// ==== CAgingMaxMinHeap::GetAgingRate ========================================
+//
+// This function returns the priority an element gains per tick.
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+typename CAgingMaxMinHeap<HeapItemType, PriorityOf>::KeyType
+CAgingMaxMinHeap<HeapItemType, PriorityOf>::GetAgingRate(void) const
+{
+    return m_agingRate;
+}
+// end of CAgingMaxMinHeap::GetAgingRate()
+
+
+// ==== CAgingMaxMinHeap::GetHeapType =========================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+int CAgingMaxMinHeap<HeapItemType, PriorityOf>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of CAgingMaxMinHeap::GetHeapType()
+
+
+// ==== CAgingMaxMinHeap::GetNumItems =========================================
+//
+// This function returns the number of elements.
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+int CAgingMaxMinHeap<HeapItemType, PriorityOf>::GetNumItems(void) const
+{
+    return m_heap.GetNumItems();
+}
+// end of CAgingMaxMinHeap::GetNumItems()
+
+
+// ==== CAgingMaxMinHeap::IsEmpty =============================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType, class PriorityOf>
+bool CAgingMaxMinHeap<HeapItemType, PriorityOf>::IsEmpty(void) const
+{
+    return m_heap.IsEmpty();
+}
+// end of CAgingMaxMinHeap::IsEmpty()
+
+#endif // CAGINGMAXMINHEAP_H
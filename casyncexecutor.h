@@ -0,0 +1,319 @@
+// ============================================================================
+// File: casyncexecutor.h
+// ============================================================================
+// Header file for the coroutine executors used with AsyncPriorityQueue:
+//
+//      CAsyncExecutor          -- the interface: Post a coroutine to resume
+//      CSingleThreadExecutor   -- resumes posted coroutines on the thread
+//                                 that calls Run, for deterministic tests
+//      CThreadPoolExecutor     -- resumes them on a fixed set of threads
+//      CAsyncTask              -- a detached coroutine, the return type for
+//                                 producers and consumers
+//
+// A suspended coroutine costs its frame and nothing else; no thread waits
+// for it. Requires C++20.
+// ============================================================================
+#ifndef CASYNCEXECUTOR_H
+#define CASYNCEXECUTOR_H
+
+#if (__cplusplus < 202002L) && !(defined(_MSVC_LANG) && (_MSVC_LANG >= 202002L))
+#error "casyncexecutor.h requires C++20 coroutines (compile with -std=c++20 or later)"
+#endif
+
+#include    <condition_variable>
+#include    <coroutine>
+#include    <deque>
+#include    <exception>
+#include    <mutex>
+#include    <thread>
+#include    <vector>
+
+
+// ==== CAsyncExecutor ========================================================
+//
+// Resumes coroutines handed to Post, on a thread of its choosing. Post may be
+// called from any thread. Schedule returns an awaitable that moves the
+// awaiting coroutine onto the executor.
+//
+// ============================================================================
+class   CAsyncExecutor
+{
+public:
+    // awaitable returned by Schedule
+    struct  CScheduleAwaiter
+    {
+        CAsyncExecutor  *m_executor;
+
+        bool await_ready(void) const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const
+        {
+            m_executor->Post(handle);
+        }
+        void await_resume(void) const noexcept {}
+    };
+
+    // destructor
+    virtual ~CAsyncExecutor() {}
+
+    // member functions
+    virtual void        Post(std::coroutine_handle<> handle) = 0;
+    CScheduleAwaiter    Schedule(void) { return CScheduleAwaiter{this}; }
+};
+
+
+// ==== CSingleThreadExecutor =================================================
+//
+// Queues posted coroutines and resumes them, in posting order, when the owner
+// calls RunOne or Run. Nothing runs in the background.
+//
+// ============================================================================
+class   CSingleThreadExecutor : public CAsyncExecutor
+{
+public:
+    // member functions
+    void        Post(std::coroutine_handle<> handle) override;
+    bool        RunOne(void);
+    int         Run(void);
+
+private:
+    // data members
+    std::mutex                          m_lock;     // guards m_ready
+    std::deque<std::coroutine_handle<>> m_ready;    // posted, not resumed
+};
+
+
+// ==== CSingleThreadExecutor::Post ===========================================
+//
+// This function queues a coroutine to be resumed by Run.
+//
+// Input:
+//      handle  -- [IN]: the suspended coroutine
+//
+// Output:
+//      void
+// ============================================================================
+inline void CSingleThreadExecutor::Post(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_ready.push_back(handle);
+}
+// end of CSingleThreadExecutor::Post()
+
+
+// ==== CSingleThreadExecutor::RunOne =========================================
+//
+// This function resumes the oldest queued coroutine.
+//
+// Input:
+//      void
+//
+// Output:
+//      bool -- [OUT]: false if nothing was queued
+// ============================================================================
+inline bool CSingleThreadExecutor::RunOne(void)
+{
+    std::coroutine_handle<> handle;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if (m_ready.empty())
+        {
+            return false;
+        }
+        handle = m_ready.front();
+        m_ready.pop_front();
+    }
+
+    handle.resume();
+
+    return true;
+}
+// end of CSingleThreadExecutor::RunOne()
+
+
+// ==== CSingleThreadExecutor::Run ============================================
+//
+// This function resumes queued coroutines until none is left, including the
+// ones they post while running.
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: the number of coroutines resumed
+// ============================================================================
+inline int CSingleThreadExecutor::Run(void)
+{
+    int numResumed = 0;
+
+    while (RunOne())
+    {
+        ++numResumed;
+    }
+
+    return numResumed;
+}
+// end of CSingleThreadExecutor::Run()
+
+
+// ==== CThreadPoolExecutor ===================================================
+//
+// Resumes posted coroutines on numThreads worker threads, oldest first. The
+// destructor stops the workers once the coroutines already posted have run.
+//
+// ============================================================================
+class   CThreadPoolExecutor : public CAsyncExecutor
+{
+public:
+    // constructor and destructor
+    CThreadPoolExecutor(int numThreads);
+    virtual ~CThreadPoolExecutor();
+
+    // member functions
+    void        Post(std::coroutine_handle<> handle) override;
+
+    // Helper functions
+    int         GetNumThreads(void) const
+                { return static_cast<int>(m_threads.size()); }
+
+private:
+    // data members
+    std::mutex                          m_lock;     // guards the rest
+    std::condition_variable             m_wakeup;   // signals m_ready/m_stop
+    std::deque<std::coroutine_handle<>> m_ready;    // posted, not resumed
+    bool                                m_stop;     // set by the destructor
+    std::vector<std::thread>            m_threads;  // the workers
+
+    // no copying: the pool owns its threads
+    CThreadPoolExecutor(const CThreadPoolExecutor &);
+    CThreadPoolExecutor&    operator=(const CThreadPoolExecutor &);
+
+    // utility functions
+    void        WorkerLoop(void);
+};
+
+
+// ==== CThreadPoolExecutor::CThreadPoolExecutor ==============================
+//
+// This is the constructor. It starts the worker threads.
+//
+// Input:
+//      numThreads  -- [IN]: the number of workers, at least one
+//
+// ============================================================================
+inline CThreadPoolExecutor::CThreadPoolExecutor(int numThreads)
+: m_stop(false)
+{
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+
+    m_threads.reserve(numThreads);
+    for (int index = 0; index < numThreads; ++index)
+    {
+        m_threads.emplace_back(&CThreadPoolExecutor::WorkerLoop, this);
+    }
+}
+// end of CThreadPoolExecutor::CThreadPoolExecutor()
+
+
+// ==== CThreadPoolExecutor::~CThreadPoolExecutor =============================
+//
+// This is the destructor. The workers drain the coroutines already posted,
+// then exit and are joined.
+//
+// ============================================================================
+inline CThreadPoolExecutor::~CThreadPoolExecutor()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+
+    for (std::thread &worker : m_threads)
+    {
+        worker.join();
+    }
+}
+// end of CThreadPoolExecutor::~CThreadPoolExecutor()
+
+
+// ==== CThreadPoolExecutor::Post =============================================
+//
+// This function queues a coroutine for the next free worker.
+//
+// Input:
+//      handle  -- [IN]: the suspended coroutine
+//
+// Output:
+//      void
+// ============================================================================
+inline void CThreadPoolExecutor::Post(std::coroutine_handle<> handle)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_ready.push_back(handle);
+    }
+    m_wakeup.notify_one();
+}
+// end of CThreadPoolExecutor::Post()
+
+
+// ==== CThreadPoolExecutor::WorkerLoop =======================================
+//
+// This function is the body of every worker thread.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+inline void CThreadPoolExecutor::WorkerLoop(void)
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    for (;;)
+    {
+        m_wakeup.wait(guard, [this] { return m_stop || !m_ready.empty(); });
+
+        if (m_ready.empty())
+        {
+            return;
+        }
+
+        std::coroutine_handle<> handle = m_ready.front();
+        m_ready.pop_front();
+
+        guard.unlock();
+        handle.resume();
+        guard.lock();
+    }
+}
+// end of CThreadPoolExecutor::WorkerLoop()
+
+
+// ==== CAsyncTask ============================================================
+//
+// Return type for a detached coroutine: it starts running at once, on the
+// caller's thread, and frees its own frame when it finishes. An exception
+// escaping the coroutine terminates the program.
+//
+// ============================================================================
+struct  CAsyncTask
+{
+    struct  promise_type
+    {
+        CAsyncTask          get_return_object(void) noexcept { return CAsyncTask(); }
+        std::suspend_never  initial_suspend(void) const noexcept { return {}; }
+        std::suspend_never  final_suspend(void) const noexcept { return {}; }
+        void                return_void(void) const noexcept {}
+        void                unhandled_exception(void) const noexcept
+                            { std::terminate(); }
+    };
+};
+
+#endif // CASYNCEXECUTOR_H
@@ -0,0 +1,505 @@
+// ============================================================================
+// File: ccowmaxminheap.h
+// ============================================================================
+// Header file for the CCowMaxMinHeap class, a CMaxMinHeap with copy-on-write
+// storage, and for CMaxMinHeapSnapshot, a read-only view of it.
+//
+// Snapshot() is O(1): it shares the heap storage with the snapshot instead of
+// copying it. A writer clones the storage only when it is about to change it
+// while a snapshot is still alive, so the producer/consumer path pays for a
+// copy at most once per snapshot, and nothing at all when no one is looking.
+//
+// CCowMaxMinHeap itself is used like CMaxMinHeap: its member functions,
+// Snapshot() included, must be serialized by the caller. A snapshot never
+// changes and may be read from any number of threads without locking.
+// ============================================================================
+#ifndef CCOWMAXMINHEAP_H
+#define CCOWMAXMINHEAP_H
+
+#include    <atomic>
+#include    <memory>
+#include    <optional>
+#include    "cmaxminheap.h"
+
+
+// ==== CMaxMinHeapSnapshot ===================================================
+//
+// A consistent, immutable view of a CCowMaxMinHeap at the time it was taken.
+//
+// ============================================================================
+template <class HeapItemType>
+class   CMaxMinHeapSnapshot
+{
+public:
+    // constructor
+    CMaxMinHeapSnapshot(std::shared_ptr<const CMaxMinHeap<HeapItemType> > heap)
+                      : m_heap(heap) {}
+
+    // member functions
+    HeapItemType        PeekTop(void) const;
+    const HeapItemType* TryPeek(void) const noexcept;
+    template <class OutputIt>
+    int                 TopN(int count, OutputIt out) const;
+    template <class Function>
+    void                ForEach(Function visit) const;
+
+    // Helper functions
+    int                 GetHeapType(void) const;
+    int                 GetNumItems(void) const;
+    bool                IsEmpty(void) const;
+
+private:
+    // data members
+    std::shared_ptr<const CMaxMinHeap<HeapItemType> >  m_heap; // shared storage
+};
+
+
+// class declaration
+template <class HeapItemType>
+class   CCowMaxMinHeap
+{
+public:
+    // constructor and destructor
+    CCowMaxMinHeap(int heapType = MAX);
+    virtual ~CCowMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+    template <class Predicate>
+    int             RemoveIf(Predicate removeItem);
+
+    // exception-free versions of Insert, Remove and PeekTop
+    bool                        TryPush(const HeapItemType  &newItem) noexcept;
+    std::optional<HeapItemType> TryPop(void) noexcept;
+    const HeapItemType*         TryPeek(void) const noexcept;
+
+    // O(1) read-only view
+    CMaxMinHeapSnapshot<HeapItemType>   Snapshot(void) const;
+
+    // Helper functions
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+    bool            IsShared(void) const;
+
+private:
+    // data members
+    std::shared_ptr<CMaxMinHeap<HeapItemType> >  m_heap; // current storage
+
+    // utility functions
+    CMaxMinHeap<HeapItemType>&  GetWritableHeap(void);
+};
+
+
+// ==== CMaxMinHeapSnapshot::PeekTop ==========================================
+//
+// This function returns the top element at the time of the snapshot.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element, or CMaxMinHeapException
+//                      (HEAP_EMPTY) is thrown
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CMaxMinHeapSnapshot<HeapItemType>::PeekTop(void) const
+{
+    return m_heap->PeekTop();
+}
+// end of CMaxMinHeapSnapshot::PeekTop()
+
+
+// ==== CMaxMinHeapSnapshot::TryPeek ==========================================
+//
+// This function returns the top element without copying it.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the top element, NULL if empty. It stays
+//                             valid as long as the snapshot does.
+// ============================================================================
+template <class HeapItemType>
+const HeapItemType* CMaxMinHeapSnapshot<HeapItemType>::TryPeek(void) const
+noexcept
+{
+    return m_heap->TryPeek();
+}
+// end of CMaxMinHeapSnapshot::TryPeek()
+
+
+// ==== CMaxMinHeapSnapshot::TopN =============================================
+//
+// This function copies the count highest priority elements, in priority
+// order, to an output iterator in O(count log count). The snapshot is not
+// changed.
+//
+// Input:
+//      count   -- [IN]: the number of elements wanted
+//      out     -- [IN]: where to write them
+//
+// Output:
+//      int -- [OUT]: the number of elements written (at most GetNumItems())
+// ============================================================================
+template <class HeapItemType>
+template <class OutputIt>
+int CMaxMinHeapSnapshot<HeapItemType>::TopN(int count, OutputIt out) const
+{
+    auto view = m_heap->TopView(count);
+    int numWritten = 0;
+
+    for (const HeapItemType &item : view)
+    {
+        *out++ = item;
+        ++numWritten;
+    }
+
+    return numWritten;
+}
+// end of CMaxMinHeapSnapshot::TopN()
+
+
+// ==== CMaxMinHeapSnapshot::ForEach ==========================================
+//
+// This function calls a function once for every element, in storage (heap)
+// order. It is meant for summaries such as a priority distribution.
+//
+// Input:
+//      visit   -- [IN]: a function object taking a const HeapItemType&
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+template <class Function>
+void CMaxMinHeapSnapshot<HeapItemType>::ForEach(Function visit) const
+{
+    const HeapItemType *items = m_heap->GetItemArray();
+    int numItems = m_heap->GetNumItems();
+
+    for (int index = 0; index < numItems; ++index)
+    {
+        visit(items[index]);
+    }
+}
+// end of CMaxMinHeapSnapshot::ForEach()
+
+
+// ==== CMaxMinHeapSnapshot::GetHeapType ======================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType>
+int CMaxMinHeapSnapshot<HeapItemType>::GetHeapType(void) const
+{
+    return m_heap->GetHeapType();
+}
+// end of CMaxMinHeapSnapshot::GetHeapType()
+
+
+// ==== CMaxMinHeapSnapshot::GetNumItems ======================================
+//
+// This function returns the number of elements at the time of the snapshot.
+// ============================================================================
+template <class HeapItemType>
+int CMaxMinHeapSnapshot<HeapItemType>::GetNumItems(void) const
+{
+    return m_heap->GetNumItems();
+}
+// end of CMaxMinHeapSnapshot::GetNumItems()
+
+
+// ==== CMaxMinHeapSnapshot::IsEmpty ==========================================
+//
+// This function returns a boolean value if the snapshot is empty.
+// ============================================================================
+template <class HeapItemType>
+bool CMaxMinHeapSnapshot<HeapItemType>::IsEmpty(void) const
+{
+    return m_heap->IsEmpty();
+}
+// end of CMaxMinHeapSnapshot::IsEmpty()
+
+
+// ==== CCowMaxMinHeap::CCowMaxMinHeap ========================================
+//
+// This is the constructor.
+//
+// ============================================================================
+template <class HeapItemType>
+CCowMaxMinHeap<HeapItemType>::CCowMaxMinHeap(int heapType)
+: m_heap(std::make_shared<CMaxMinHeap<HeapItemType> >(heapType))
+{
+}
+// end of CCowMaxMinHeap::CCowMaxMinHeap()
+
+
+// ==== CCowMaxMinHeap::~CCowMaxMinHeap =======================================
+//
+// This is the destructor. Live snapshots keep their storage.
+//
+// ============================================================================
+template <class HeapItemType>
+CCowMaxMinHeap<HeapItemType>::~CCowMaxMinHeap()
+{
+}
+// end of CCowMaxMinHeap::~CCowMaxMinHeap()
+
+
+// ==== CCowMaxMinHeap::GetWritableHeap =======================================
+//
+// This function returns storage that no snapshot refers to, cloning the
+// current storage first if a snapshot still shares it.
+//
+// Input:
+//      void
+//
+// Output:
+//      CMaxMinHeap<HeapItemType>& -- [OUT]: the heap to change
+// ============================================================================
+template <class HeapItemType>
+CMaxMinHeap<HeapItemType>& CCowMaxMinHeap<HeapItemType>::GetWritableHeap(void)
+{
+    if (m_heap.use_count() > 1)
+    {
+        m_heap = std::make_shared<CMaxMinHeap<HeapItemType> >(*m_heap);
+    }
+    else
+    {
+        // pairs with the release of the last snapshot's reference, so the
+        // reader is done with the storage before it is changed in place
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    return *m_heap;
+}
+// end of CCowMaxMinHeap::GetWritableHeap()
+
+
+// ==== CCowMaxMinHeap::Snapshot ==============================================
+//
+// This function returns a read-only view of the heap in O(1).
+//
+// Input:
+//      void
+//
+// Output:
+//      CMaxMinHeapSnapshot<HeapItemType> -- [OUT]: the snapshot
+// ============================================================================
+template <class HeapItemType>
+CMaxMinHeapSnapshot<HeapItemType> CCowMaxMinHeap<HeapItemType>::Snapshot(void)
+const
+{
+    return CMaxMinHeapSnapshot<HeapItemType>(m_heap);
+}
+// end of CCowMaxMinHeap::Snapshot()
+
+
+// ==== CCowMaxMinHeap::Insert ================================================
+//
+// This function inserts an element.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_FULL) is thrown
+// ============================================================================
+template <class HeapItemType>
+bool CCowMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
+{
+    return GetWritableHeap().Insert(newItem);
+}
+// end of CCowMaxMinHeap::Insert()
+
+
+// ==== CCowMaxMinHeap::Remove ================================================
+//
+// This function removes the top element.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_EMPTY) is thrown
+// ============================================================================
+template <class HeapItemType>
+bool CCowMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
+{
+    if (m_heap->IsEmpty())
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return GetWritableHeap().Remove(item);
+}
+// end of CCowMaxMinHeap::Remove()
+
+
+// ==== CCowMaxMinHeap::PeekTop ===============================================
+//
+// This function peeks the top element. It never clones.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CCowMaxMinHeap<HeapItemType>::PeekTop(void) const
+{
+    return m_heap->PeekTop();
+}
+// end of CCowMaxMinHeap::PeekTop()
+
+
+// ==== CCowMaxMinHeap::RemoveIf ==============================================
+//
+// This function removes every item for which the predicate returns true.
+//
+// Input:
+//      Predicate removeItem -- [IN]: returns true for the items to remove
+//
+// Output:
+//      int -- [OUT]: the number of items removed
+// ============================================================================
+template <class HeapItemType>
+template <class Predicate>
+int CCowMaxMinHeap<HeapItemType>::RemoveIf(Predicate removeItem)
+{
+    return GetWritableHeap().RemoveIf(removeItem);
+}
+// end of CCowMaxMinHeap::RemoveIf()
+
+
+// ==== CCowMaxMinHeap::TryPush ===============================================
+//
+// This function inserts an element without throwing.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if there was no memory for the item (or for the
+//              clone of a shared heap)
+// ============================================================================
+template <class HeapItemType>
+bool CCowMaxMinHeap<HeapItemType>::TryPush(const HeapItemType  &newItem)
+noexcept
+{
+    try
+    {
+        return GetWritableHeap().TryPush(newItem);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+// end of CCowMaxMinHeap::TryPush()
+
+
+// ==== CCowMaxMinHeap::TryPop ================================================
+//
+// This function removes the top element without throwing.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no
+//                                     value if the heap is empty
+// ============================================================================
+template <class HeapItemType>
+std::optional<HeapItemType> CCowMaxMinHeap<HeapItemType>::TryPop(void) noexcept
+{
+    if (m_heap->IsEmpty())
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        return GetWritableHeap().TryPop();
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+}
+// end of CCowMaxMinHeap::TryPop()
+
+
+// ==== CCowMaxMinHeap::TryPeek ===============================================
+//
+// This function peeks the top element without copying it.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the top element, NULL if empty. It is
+//                             valid until the heap is next changed.
+// ============================================================================
+template <class HeapItemType>
+const HeapItemType* CCowMaxMinHeap<HeapItemType>::TryPeek(void) const noexcept
+{
+    return m_heap->TryPeek();
+}
+// end of CCowMaxMinHeap::TryPeek()
+
+
+// ==== CCowMaxMinHeap::GetHeapType ===========================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType>
+int CCowMaxMinHeap<HeapItemType>::GetHeapType(void) const
+{
+    return m_heap->GetHeapType();
+}
+// end of CCowMaxMinHeap::GetHeapType()
+
+
+// ==== CCowMaxMinHeap::GetNumItems ===========================================
+//
+// This function returns the number of elements.
+// ============================================================================
+template <class HeapItemType>
+int CCowMaxMinHeap<HeapItemType>::GetNumItems(void) const
+{
+    return m_heap->GetNumItems();
+}
+// end of CCowMaxMinHeap::GetNumItems()
+
+
+// ==== CCowMaxMinHeap::IsEmpty ===============================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType>
+bool CCowMaxMinHeap<HeapItemType>::IsEmpty(void) const
+{
+    return m_heap->IsEmpty();
+}
+// end of CCowMaxMinHeap::IsEmpty()
+
+
+// ==== CCowMaxMinHeap::IsShared ==============================================
+//
+// This function returns true while a snapshot shares the storage, that is,
+// when the next change will clone it.
+// ============================================================================
+template <class HeapItemType>
+bool CCowMaxMinHeap<HeapItemType>::IsShared(void) const
+{
+    return (m_heap.use_count() > 1);
+}
+// end of CCowMaxMinHeap::IsShared()
+
+#endif // CCOWMAXMINHEAP_H
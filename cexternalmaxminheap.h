@@ -0,0 +1,842 @@
+// ============================================================================
+// File: cexternalmaxminheap.h
+// ============================================================================
+// Header file for the CExternalMaxMinHeap class, a priority queue for more
+// items than fit in memory.
+//
+// New items go into an in-memory CMaxMinHeap (the insertion heap). When it
+// holds memoryItems items it is drained in priority order into a sorted run
+// file. Remove takes the better of the insertion heap top and the heads of
+// the runs, which are kept in a second, small CMaxMinHeap. Runs are read and
+// written sequentially through buffers of bufferItems items, and when there
+// are maxRuns runs the smaller half of them is merged into one. Runs of
+// similar size are thus merged together, as in a tiered merge, and an item
+// is rewritten about log(n / memoryItems) / log(maxRuns / 2) times instead
+// of once per merge. Each open run holds a stdio buffer and a read buffer of
+// bufferItems items each, and a merge keeps the old runs open until its new
+// run has both buffers, so memory stays below
+//
+//      memoryItems + (2 * maxRuns + 2) * bufferItems    items
+//
+// A spill sorts the insertion heap in place, so it needs no second copy of
+// it. The insertion heap is reserved at its full size up front, so it never
+// grows past memoryItems.
+//
+// Run files are created in runDirectory and unlinked right away, so they go
+// away with the object (or the process) without any cleanup.
+// ============================================================================
+#ifndef CEXTERNALMAXMINHEAP_H
+#define CEXTERNALMAXMINHEAP_H
+
+#include    <algorithm>
+#include    <cstdio>
+#include    <cstdlib>
+#include    <string>
+#include    <type_traits>
+#include    <vector>
+#include    <unistd.h>
+#include    "cmaxminheap.h"
+
+// constants
+const   int EXTERNAL_HEAP_MEMORY_ITEMS = 1 << 20;   // insertion heap size
+const   int EXTERNAL_HEAP_BUFFER_ITEMS = 1 << 12;   // items per run buffer
+const   int EXTERNAL_HEAP_MAX_RUNS = 64;            // runs before a merge
+
+// enumerate list for CExternalHeapException class
+enum    CExternalHeapExceptionType  { EXTERNAL_HEAP_IO_ERROR,
+                                      EXTERNAL_HEAP_EMPTY
+                                    };
+
+
+// exception class for CExternalMaxMinHeap
+class CExternalHeapException
+{
+public:
+    // constructor
+    CExternalHeapException(CExternalHeapExceptionType   exceptType)
+            : m_exceptType(exceptType) {}
+
+    // member function
+    CExternalHeapExceptionType GetException() const {return m_exceptType;}
+
+private:
+    CExternalHeapExceptionType  m_exceptType;
+};
+
+
+// the next unread item of a run, ordered by the item only
+template <class HeapItemType>
+struct  CExternalRunHead
+{
+    HeapItemType    m_item; // the item
+    int             m_run;  // index of the run it was read from
+};
+
+template <class HeapItemType>
+bool operator<(const CExternalRunHead<HeapItemType> &lhs,
+               const CExternalRunHead<HeapItemType> &rhs)
+{
+    return (lhs.m_item < rhs.m_item);
+}
+
+template <class HeapItemType>
+bool operator>(const CExternalRunHead<HeapItemType> &lhs,
+               const CExternalRunHead<HeapItemType> &rhs)
+{
+    return (lhs.m_item > rhs.m_item);
+}
+
+template <class HeapItemType>
+bool operator==(const CExternalRunHead<HeapItemType> &lhs,
+                const CExternalRunHead<HeapItemType> &rhs)
+{
+    return (lhs.m_item == rhs.m_item);
+}
+
+
+// a sorted run file and its read buffer
+template <class HeapItemType>
+struct  CExternalRun
+{
+    FILE            *m_file;        // NULL once the run is used up
+    HeapItemType    *m_buffer;      // bufferItems items read ahead
+    int             m_bufferPos;    // next item to hand out
+    int             m_bufferCount;  // items in the buffer
+    long long       m_remaining;    // items not yet handed out
+};
+
+
+// class declaration
+template <class HeapItemType>
+class   CExternalMaxMinHeap
+{
+    static_assert(std::is_trivially_copyable<HeapItemType>::value,
+                  "CExternalMaxMinHeap writes items to run files as raw bytes");
+
+public:
+    // constructor and destructor
+    CExternalMaxMinHeap(const char *runDirectory, int heapType = MAX,
+                        int memoryItems = EXTERNAL_HEAP_MEMORY_ITEMS,
+                        int bufferItems = EXTERNAL_HEAP_BUFFER_ITEMS,
+                        int maxRuns = EXTERNAL_HEAP_MAX_RUNS);
+    virtual ~CExternalMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+
+    // Helper functions
+    long long       GetNumItems(void) const;
+    int             GetNumRuns(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    // run files cannot be shared by two objects
+    CExternalMaxMinHeap(const CExternalMaxMinHeap &otherObj);
+    CExternalMaxMinHeap& operator=(const CExternalMaxMinHeap &rhs);
+
+    // data members
+    std::string     m_runDirectory; // where the run files are created
+    int             m_heapType;     // MAX or MIN
+    int             m_memoryItems;  // insertion heap limit
+    int             m_bufferItems;  // items per run buffer
+    int             m_maxRuns;      // runs kept before merging them
+    int             m_numActiveRuns;// runs with items left
+    long long       m_numItems;     // items in memory and on disk
+
+    CMaxMinHeap<HeapItemType>                       m_memoryHeap;
+    CMaxMinHeap<CExternalRunHead<HeapItemType> >    m_runHeads;
+    std::vector<CExternalRun<HeapItemType> >        m_runs;
+
+    // utility functions
+    bool    Before(const HeapItemType &lhs, const HeapItemType &rhs) const;
+    FILE*   CreateRunFile(void);
+    void    WriteItem(FILE *file, const HeapItemType &item);
+    void    OpenRun(FILE *file, long long numItems,
+                    CExternalRun<HeapItemType> &run,
+                    CExternalRunHead<HeapItemType> &head);
+    void    AddRun(const CExternalRun<HeapItemType> &run,
+                   CExternalRunHead<HeapItemType> head);
+    bool    ReadRun(CExternalRun<HeapItemType> &run, HeapItemType &item);
+    void    ReleaseRunIfDone(int run);
+    bool    AdvanceRun(int run, HeapItemType &item);
+    void    CloseRuns(void);
+    void    MergeRuns(void);
+    void    SpillMemoryHeap(void);
+};
+
+
+// ==== CExternalMaxMinHeap::CExternalMaxMinHeap ==============================
+//
+// This is the constructor. It reserves the insertion heap; nothing is written
+// to runDirectory until that heap fills up for the first time.
+//
+// ============================================================================
+template <class HeapItemType>
+CExternalMaxMinHeap<HeapItemType>::CExternalMaxMinHeap(const char *runDirectory,
+                                                       int heapType,
+                                                       int memoryItems,
+                                                       int bufferItems,
+                                                       int maxRuns)
+: m_runDirectory(runDirectory), m_heapType(heapType),
+  m_memoryItems(memoryItems > 0 ? memoryItems : 1),
+  m_bufferItems(bufferItems > 0 ? bufferItems : 1),
+  m_maxRuns(maxRuns > 1 ? maxRuns : 2), m_numActiveRuns(0), m_numItems(0),
+  m_memoryHeap(heapType), m_runHeads(heapType)
+{
+    m_memoryHeap.Reserve(m_memoryItems);
+}
+// end of CExternalMaxMinHeap::CExternalMaxMinHeap()
+
+
+// ==== CExternalMaxMinHeap::~CExternalMaxMinHeap() ===========================
+//
+// This is the destructor. Closing a run file releases it on disk.
+//
+// ============================================================================
+template <class HeapItemType>
+CExternalMaxMinHeap<HeapItemType>::~CExternalMaxMinHeap()
+{
+    CloseRuns();
+}
+// end of CExternalMaxMinHeap::~CExternalMaxMinHeap()
+
+
+// ==== CExternalMaxMinHeap::Before() =========================================
+//
+// This function returns true if lhs has to come out of the heap before rhs.
+//
+// Input:
+//      lhs, rhs    -- [IN]: the items to compare
+//
+// Output:
+//      bool        -- [OUT]: true when lhs comes first
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::Before(const HeapItemType &lhs,
+                                               const HeapItemType &rhs) const
+{
+    return ((m_heapType == MAX) ? (lhs > rhs) : (lhs < rhs));
+}
+// end of CExternalMaxMinHeap::Before()
+
+
+// ==== CExternalMaxMinHeap::CreateRunFile() ==================================
+//
+// This function creates an anonymous run file in the run directory. The file
+// is unlinked as soon as it is open.
+//
+// Input:
+//      void
+//
+// Output:
+//      FILE*   -- [OUT]: the run file, opened for writing and reading
+// ============================================================================
+template <class HeapItemType>
+FILE* CExternalMaxMinHeap<HeapItemType>::CreateRunFile(void)
+{
+    std::string pathName = m_runDirectory + "/cmmheap-run-XXXXXX";
+    std::vector<char> pathBuffer(pathName.begin(), pathName.end());
+    pathBuffer.push_back('\0');
+
+    int fileDesc = mkstemp(&pathBuffer[0]);
+    if (fileDesc < 0)
+    {
+        throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+    }
+    unlink(&pathBuffer[0]);
+
+    FILE *file = fdopen(fileDesc, "w+b");
+    if (file == NULL)
+    {
+        close(fileDesc);
+        throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+    }
+
+    // one large stdio buffer keeps the writes sequential and few
+    setvbuf(file, NULL, _IOFBF, m_bufferItems * sizeof(HeapItemType));
+
+    return file;
+}
+// end of CExternalMaxMinHeap::CreateRunFile()
+
+
+// ==== CExternalMaxMinHeap::WriteItem() ======================================
+//
+// This function appends one item to a run file through its stdio buffer.
+//
+// Input:
+//      file    -- [IN]: the run file
+//      item    -- [IN]: the item to append
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::WriteItem(FILE *file,
+                                                  const HeapItemType &item)
+{
+    if (fwrite(&item, sizeof(HeapItemType), 1, file) != 1)
+    {
+        throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+    }
+}
+// end of CExternalMaxMinHeap::WriteItem()
+
+
+// ==== CExternalMaxMinHeap::OpenRun() ========================================
+//
+// This function flushes and rewinds a freshly written run file and reads its
+// first item, without registering the run yet. On failure the caller still
+// owns the file and nothing else is left behind.
+//
+// Input:
+//      file        -- [IN]: the run file, positioned at its end
+//      numItems    -- [IN]: the number of items written to it, at least one
+//      run         -- [OUT]: the run, its buffer allocated
+//      head        -- [OUT]: the first item of the run
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::OpenRun(FILE *file, long long numItems,
+                                        CExternalRun<HeapItemType> &run,
+                                        CExternalRunHead<HeapItemType> &head)
+{
+    if ((fflush(file) != 0) || (fseek(file, 0, SEEK_SET) != 0))
+    {
+        throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+    }
+
+    run.m_file = file;
+    run.m_buffer = new HeapItemType[m_bufferItems];
+    run.m_bufferPos = 0;
+    run.m_bufferCount = 0;
+    run.m_remaining = numItems;
+
+    try
+    {
+        ReadRun(run, head.m_item);
+    }
+    catch (...)
+    {
+        delete [] run.m_buffer;
+        run.m_buffer = NULL;
+        throw;
+    }
+}
+// end of CExternalMaxMinHeap::OpenRun()
+
+
+// ==== CExternalMaxMinHeap::AddRun() =========================================
+//
+// This function registers a run prepared by OpenRun and pushes its first
+// item onto the run heads heap.
+//
+// Input:
+//      run     -- [IN]: the run
+//      head    -- [IN]: its first item
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::AddRun(
+                                        const CExternalRun<HeapItemType> &run,
+                                        CExternalRunHead<HeapItemType> head)
+{
+    m_runs.push_back(run);
+    m_numActiveRuns++;
+
+    head.m_run = static_cast<int>(m_runs.size()) - 1;
+    m_runHeads.Insert(head);
+    ReleaseRunIfDone(head.m_run);
+}
+// end of CExternalMaxMinHeap::AddRun()
+
+
+// ==== CExternalMaxMinHeap::ReadRun() ========================================
+//
+// This function hands out the next item of a run, refilling the run buffer
+// with one sequential read when it is used up. A failed read leaves the run
+// as it was.
+//
+// Input:
+//      run     -- [IN/OUT]: the run
+//      item    -- [OUT]: receives the next item
+//
+// Output:
+//      bool    -- [OUT]: false if the run had no items left
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::ReadRun(CExternalRun<HeapItemType> &run,
+                                                HeapItemType &item)
+{
+    if (run.m_remaining == 0)
+    {
+        return false;
+    }
+
+    // refill the buffer
+    if (run.m_bufferPos == run.m_bufferCount)
+    {
+        size_t wanted = (run.m_remaining < m_bufferItems)
+                        ? static_cast<size_t>(run.m_remaining)
+                        : static_cast<size_t>(m_bufferItems);
+
+        if (fread(run.m_buffer, sizeof(HeapItemType), wanted,
+                  run.m_file) != wanted)
+        {
+            throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+        }
+        run.m_bufferPos = 0;
+        run.m_bufferCount = static_cast<int>(wanted);
+    }
+
+    item = run.m_buffer[run.m_bufferPos++];
+    run.m_remaining--;
+
+    return true;
+}
+// end of CExternalMaxMinHeap::ReadRun()
+
+
+// ==== CExternalMaxMinHeap::ReleaseRunIfDone() ===============================
+//
+// This function closes a run as soon as its last item is out.
+//
+// Input:
+//      run     -- [IN]: the index of the run
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::ReleaseRunIfDone(int run)
+{
+    CExternalRun<HeapItemType> &current = m_runs[run];
+
+    if ((current.m_remaining == 0) && (current.m_file != NULL))
+    {
+        fclose(current.m_file);
+        delete [] current.m_buffer;
+        current.m_file = NULL;
+        current.m_buffer = NULL;
+        m_numActiveRuns--;
+    }
+}
+// end of CExternalMaxMinHeap::ReleaseRunIfDone()
+
+
+// ==== CExternalMaxMinHeap::AdvanceRun() =====================================
+//
+// This function hands out the next item of a registered run and releases
+// the run once it is used up.
+//
+// Input:
+//      run     -- [IN]: the index of the run
+//      item    -- [OUT]: receives the next item
+//
+// Output:
+//      bool    -- [OUT]: false if the run had no items left
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::AdvanceRun(int run, HeapItemType &item)
+{
+    if (!ReadRun(m_runs[run], item))
+    {
+        return false;
+    }
+
+    ReleaseRunIfDone(run);
+
+    return true;
+}
+// end of CExternalMaxMinHeap::AdvanceRun()
+
+
+// ==== CExternalMaxMinHeap::CloseRuns() ======================================
+//
+// This function closes every run that still has items and forgets all runs.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::CloseRuns(void)
+{
+    for (size_t run = 0; run < m_runs.size(); ++run)
+    {
+        if (m_runs[run].m_file != NULL)
+        {
+            fclose(m_runs[run].m_file);
+            delete [] m_runs[run].m_buffer;
+        }
+    }
+
+    m_runs.clear();
+    m_numActiveRuns = 0;
+}
+// end of CExternalMaxMinHeap::CloseRuns()
+
+
+// ==== CExternalMaxMinHeap::MergeRuns() ======================================
+//
+// This function merges the remaining items of the smaller half of the open
+// runs (by items left, with the head each has in m_runHeads) into a single
+// new run, reading and writing each file sequentially. Merging only the
+// smallest runs keeps the big ones from being rewritten by every merge. The
+// merged runs are closed only once the new one is on disk and readable; if
+// anything fails first, they are rewound to where the merge started and the
+// error is rethrown.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::MergeRuns(void)
+{
+    typedef CExternalRunHead<HeapItemType>  HeadType;
+
+    // pick the open runs with the fewest items left; a run whose file is
+    // used up has only its head left and holds no buffers
+    std::vector<HeadType> heads;
+    const HeadType *runHeads = m_runHeads.GetItemArray();
+
+    for (int index = 0; index < m_runHeads.GetNumItems(); ++index)
+    {
+        if (m_runs[runHeads[index].m_run].m_file != NULL)
+        {
+            heads.push_back(runHeads[index]);
+        }
+    }
+
+    int numMerged = std::max(2, m_maxRuns / 2);
+
+    if (numMerged > static_cast<int>(heads.size()))
+    {
+        numMerged = static_cast<int>(heads.size());
+    }
+    std::nth_element(heads.begin(), heads.begin() + (numMerged - 1), heads.end(),
+                     [this](const HeadType &lhs, const HeadType &rhs)
+                     {
+                         return (m_runs[lhs.m_run].m_remaining
+                                 < m_runs[rhs.m_run].m_remaining);
+                     });
+    heads.resize(numMerged);
+
+    std::vector<char> isMerged(m_runs.size(), 0);
+    for (const HeadType &head : heads)
+    {
+        isMerged[head.m_run] = 1;
+    }
+
+    // remember where each merged run's unread items start
+    std::vector<long> unreadOffsets(m_runs.size(), 0);
+    std::vector<long long> unreadCounts(m_runs.size(), 0);
+
+    for (size_t run = 0; run < m_runs.size(); ++run)
+    {
+        const CExternalRun<HeapItemType> &current = m_runs[run];
+
+        if (isMerged[run] && (current.m_file != NULL))
+        {
+            long offset = ftell(current.m_file);
+            if (offset < 0)
+            {
+                throw CExternalHeapException(EXTERNAL_HEAP_IO_ERROR);
+            }
+            unreadOffsets[run] = offset - static_cast<long>(
+                (current.m_bufferCount - current.m_bufferPos)
+                * sizeof(HeapItemType));
+            unreadCounts[run] = current.m_remaining;
+        }
+    }
+
+    CMaxMinHeap<HeadType> mergeHeads(m_heapType, numMerged);
+    for (const HeadType &head : heads)
+    {
+        mergeHeads.AppendUnordered() = head;
+    }
+    mergeHeads.Heapify();
+
+    // AddRun must not fail once the merged runs are closed
+    m_runs.reserve(m_runs.size() + 1);
+
+    FILE *mergedFile = CreateRunFile();
+    long long numWritten = 0;
+    CExternalRun<HeapItemType> mergedRun;
+    HeadType head;
+
+    try
+    {
+        // the runs stay open until the merged run has been read back
+        while (!mergeHeads.IsEmpty())
+        {
+            mergeHeads.Remove(head);
+            WriteItem(mergedFile, head.m_item);
+            numWritten++;
+
+            if (ReadRun(m_runs[head.m_run], head.m_item))
+            {
+                mergeHeads.Insert(head);
+            }
+        }
+
+        OpenRun(mergedFile, numWritten, mergedRun, head);
+    }
+    catch (...)
+    {
+        fclose(mergedFile);
+
+        for (size_t run = 0; run < m_runs.size(); ++run)
+        {
+            CExternalRun<HeapItemType> &current = m_runs[run];
+
+            if (isMerged[run] && (current.m_file != NULL))
+            {
+                fseek(current.m_file, unreadOffsets[run], SEEK_SET);
+                current.m_bufferPos = 0;
+                current.m_bufferCount = 0;
+                current.m_remaining = unreadCounts[run];
+            }
+        }
+        throw;
+    }
+
+    // the merged runs are used up; their heads now live in the new run
+    m_runHeads.RemoveIf([&isMerged](const HeadType &runHead)
+                        {
+                            return (isMerged[runHead.m_run] != 0);
+                        });
+    for (size_t run = 0; run < m_runs.size(); ++run)
+    {
+        if (isMerged[run])
+        {
+            ReleaseRunIfDone(static_cast<int>(run));
+        }
+    }
+    AddRun(mergedRun, head);
+}
+// end of CExternalMaxMinHeap::MergeRuns()
+
+
+// ==== CExternalMaxMinHeap::SpillMemoryHeap() ================================
+//
+// This function writes the insertion heap, in priority order, to a new
+// sorted run. The heap is sorted in place, which leaves it a valid heap, and
+// is emptied only once the run is on disk and readable, so a write error
+// loses nothing. Runs are merged first if there are already maxRuns.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CExternalMaxMinHeap<HeapItemType>::SpillMemoryHeap(void)
+{
+    if (m_numActiveRuns >= m_maxRuns)
+    {
+        MergeRuns();
+    }
+
+    // once no run has a head left, the old runs are all used up
+    if (m_runHeads.IsEmpty())
+    {
+        CloseRuns();
+    }
+
+    m_memoryHeap.SortItems();
+
+    const HeapItemType *items = m_memoryHeap.GetItemArray();
+    int numItems = m_memoryHeap.GetNumItems();
+    FILE *runFile = CreateRunFile();
+    CExternalRun<HeapItemType> run;
+    CExternalRunHead<HeapItemType> head;
+
+    try
+    {
+        for (int index = 0; index < numItems; ++index)
+        {
+            WriteItem(runFile, items[index]);
+        }
+
+        OpenRun(runFile, numItems, run, head);
+    }
+    catch (...)
+    {
+        fclose(runFile);
+        throw;
+    }
+
+    AddRun(run, head);
+
+    // the storage is kept for the next items
+    m_memoryHeap.RemoveIf([](const HeapItemType &) { return true; });
+}
+// end of CExternalMaxMinHeap::SpillMemoryHeap()
+
+
+// ==== CExternalMaxMinHeap::Insert() =========================================
+//
+// This function inserts an element. The insertion heap is spilled to a run
+// first when it is full.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true when the item was inserted
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
+{
+    if (m_memoryHeap.GetNumItems() >= m_memoryItems)
+    {
+        SpillMemoryHeap();
+    }
+
+    m_memoryHeap.Insert(newItem);
+    m_numItems++;
+
+    return true;
+}
+// end of CExternalMaxMinHeap::Insert()
+
+
+// ==== CExternalMaxMinHeap::Remove() =========================================
+//
+// This function removes the top element: the better of the insertion heap
+// top and the best run head. Taking a run head reads the next item of that
+// run, so the runs are merged lazily as items are removed.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true when an element was removed
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
+{
+    if (IsEmpty())
+    {
+        throw CExternalHeapException(EXTERNAL_HEAP_EMPTY);
+    }
+
+    if (m_runHeads.IsEmpty()
+        || (!m_memoryHeap.IsEmpty()
+            && !Before(m_runHeads.PeekTop().m_item, m_memoryHeap.PeekTop())))
+    {
+        m_memoryHeap.Remove(item);
+    }
+    else
+    {
+        CExternalRunHead<HeapItemType> head;
+
+        m_runHeads.Remove(head);
+        item = head.m_item;
+
+        // a failed read leaves the run as it was, so put the head back
+        try
+        {
+            if (AdvanceRun(head.m_run, head.m_item))
+            {
+                m_runHeads.Insert(head);
+            }
+        }
+        catch (CExternalHeapException &)
+        {
+            head.m_item = item;
+            m_runHeads.Insert(head);
+            throw;
+        }
+    }
+
+    m_numItems--;
+
+    return true;
+}
+// end of CExternalMaxMinHeap::Remove()
+
+
+// ==== CExternalMaxMinHeap::PeekTop() ========================================
+//
+// This function peeks the top element without reading from disk.
+// Input:
+//    void
+//
+// Output:
+//      HeapItemType --[OUT] the top element
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CExternalMaxMinHeap<HeapItemType>::PeekTop(void) const
+{
+    if (IsEmpty())
+    {
+        throw CExternalHeapException(EXTERNAL_HEAP_EMPTY);
+    }
+
+    if (m_runHeads.IsEmpty())
+    {
+        return m_memoryHeap.PeekTop();
+    }
+    if (m_memoryHeap.IsEmpty())
+    {
+        return m_runHeads.PeekTop().m_item;
+    }
+
+    HeapItemType memoryTop = m_memoryHeap.PeekTop();
+    HeapItemType runTop = m_runHeads.PeekTop().m_item;
+
+    return (Before(runTop, memoryTop) ? runTop : memoryTop);
+}
+// end of CExternalMaxMinHeap::PeekTop()
+
+
+// ==== CExternalMaxMinHeap::GetNumItems() ====================================
+//
+// This function returns the number of items in memory and on disk.
+// ============================================================================
+template <class HeapItemType>
+long long CExternalMaxMinHeap<HeapItemType>::GetNumItems(void) const
+{
+    return m_numItems;
+}
+// end of CExternalMaxMinHeap::GetNumItems()
+
+
+// ==== CExternalMaxMinHeap::GetNumRuns() =====================================
+//
+// This function returns the number of run files that still hold items.
+// ============================================================================
+template <class HeapItemType>
+int CExternalMaxMinHeap<HeapItemType>::GetNumRuns(void) const
+{
+    return m_numActiveRuns;
+}
+// end of CExternalMaxMinHeap::GetNumRuns()
+
+
+// ==== CExternalMaxMinHeap::IsEmpty() ========================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType>
+bool CExternalMaxMinHeap<HeapItemType>::IsEmpty(void) const
+{
+    return (m_numItems == 0);
+}
+// end of CExternalMaxMinHeap::IsEmpty()
+
+#endif // CEXTERNALMAXMINHEAP_H
@@ -2,10 +2,30 @@
 // File: clist.h
 // ============================================================================
 // Header file for the CList
+//
+// The placement of the item array is a storage policy (ListStorage). The
+// default, CListLineStorage, starts the array on a cache line boundary; for
+// items whose size divides the line, it shifts the array by one item so
+// that item 1 (and with it every heap sibling pair 2i+1, 2i+2) begins a
+// line: a sift-down then loads both children of a node from a single line.
+// CListPageStorage starts the array one item past a virtual memory page
+// boundary, for the B-heap layout (see heaplayout.h).
+//
+// Requires C++17: the aligned storage uses ::operator new(size, align_val_t),
+// and CMaxMinHeap's TryPop returns std::optional.
 // ============================================================================
 #ifndef DYNAMIC_CLIST_HEADER
 #define DYNAMIC_CLIST_HEADER
 
+#if (__cplusplus < 201703L) && !(defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#error "the heap headers require C++17 (compile with -std=c++17 or later)"
+#endif
+
+#include    <cstring>
+#include    <iostream>
+#include    <new>
+#include    <type_traits>
+#include    <utility>
 
 // type definitions
 enum    CListExceptionType  { CLIST_FULL,
@@ -18,6 +38,51 @@ enum    CListExceptionType  { CLIST_FULL,
 
 // constant(s)
 const   int     MAX_ITEMS = 5;
+const   int     CLIST_CACHE_LINE = 64;  // bytes per cache line
+const   int     CLIST_VM_PAGE = 4096;   // bytes per virtual memory page
+
+
+// ==== CListLineStorage ======================================================
+//
+// The default storage policy: a cache line aligned array, shifted by one
+// line minus one item when the item size divides the line, so that item 1
+// starts a line.
+//
+// ============================================================================
+struct  CListLineStorage
+{
+    static const int ALIGNMENT = CLIST_CACHE_LINE;
+
+    template <class ListItemType>
+    static constexpr int GetLeadBytes(void)
+    {
+        return ((sizeof(ListItemType) < CLIST_CACHE_LINE)
+                && (CLIST_CACHE_LINE % sizeof(ListItemType) == 0))
+               ? CLIST_CACHE_LINE - static_cast<int>(sizeof(ListItemType))
+               : 0;
+    }
+};
+
+
+// ==== CListPageStorage ======================================================
+//
+// A page aligned array with one unused item in front of item 0, so that
+// item i sits (i + 1) items past a page boundary. This is the unused slot 0
+// of Varnish's 1-based B-heap: a B-heap page of 2^PageShift items whose
+// size is a multiple or a divisor of CLIST_VM_PAGE then covers whole pages,
+// or lies within one, instead of straddling two.
+//
+// ============================================================================
+struct  CListPageStorage
+{
+    static const int ALIGNMENT = CLIST_VM_PAGE;
+
+    template <class ListItemType>
+    static constexpr int GetLeadBytes(void)
+    {
+        return static_cast<int>(sizeof(ListItemType));
+    }
+};
 
 
 // exception class for CList
@@ -38,7 +103,7 @@ private:
 
 
 // CList Class declaration
-template <class ListItemType>
+template <class ListItemType, class ListStorage = CListLineStorage>
 class   CList
 {
 public:
@@ -49,12 +114,12 @@ public:
 
     // member functions
     void            DestroyList();
-    ListItemType    GetItem(int  index) const throw (CListException);
+    ListItemType    GetItem(int  index) const;
     int             GetNumItems() const;
-    void            Insert(const ListItemType  &newItem) throw (CListException);
+    void            Insert(const ListItemType  &newItem);
     bool            IsEmpty() const;
     bool            IsFull() const;
-    void            Remove(const ListItemType  &value) throw (CListException);
+    void            Remove(const ListItemType  &value);
     void            SetListSize(int num);
     void            Clear();
 
@@ -63,10 +128,18 @@ public:
     void            CListDisplay(void) const;
     void            CopyCMaxMinHeapConstructorHelper(const CList &otherObj);
     void            Swap(int target, int source);
+    void            RemoveLast(void);
+    const ListItemType* GetItemArray(void) const;
+    ListItemType*   GetItemArray(void);
+    int             GetListSize(void) const;
+    ListItemType&   AppendItem(void);
+
+    template <class Predicate>
+    int             RemoveIf(Predicate removeItem);
 
 
     // overloaded operator(s)
-    CList<ListItemType>&      operator=(const CList &rhs);
+    CList<ListItemType, ListStorage>&      operator=(const CList &rhs);
     ListItemType&             operator[](const int index);
 
 
@@ -79,15 +152,24 @@ private:
 
     // member functions
     int         MoveItems(int  index, char  direction);
+    void        RelocateItems(ListItemType *newItems, int count);
+    void        RelocateItems(ListItemType *newItems, int count,
+                              std::true_type trivialItems);
+    void        RelocateItems(ListItemType *newItems, int count,
+                              std::false_type trivialItems);
     int         CopyList(const CList &otherList);
-    bool        ItemExists(int &index, const ListItemType &item) throw (CListException);
+    bool        ItemExists(int &index, const ListItemType &item);
+
+    // storage functions
+    static int          GetLeadBytes(void);
+    static ListItemType* AllocateItems(int num);
+    static void         FreeItems(ListItemType *items, int num);
 };
 
 
 // include implementation file since it is a template
 
 // #include    "clist.tpp"
-#endif // DYNAMIC_CLIST_HEADER
 
 
 // ==== CList::CList (Default) ================================================
@@ -95,9 +177,9 @@ private:
 // This is the default constructor that initializes the variable m_numItems.
 //
 // ============================================================================
-template <class ListItemType>
-CList<ListItemType>::CList(): m_currSize(MAX_ITEMS), m_numItems(0),
-m_items (new ListItemType[m_currSize])
+template <class ListItemType, class ListStorage>
+CList<ListItemType, ListStorage>::CList(): m_currSize(MAX_ITEMS), m_numItems(0),
+m_items (AllocateItems(m_currSize))
 {
 }
 // end of CList::CList(Default Constructor)
@@ -107,10 +189,10 @@ m_items (new ListItemType[m_currSize])
 // This is the copy constructor.
 //
 // ============================================================================
-template <class ListItemType>
-CList<ListItemType>::CList(const CList   &object)
+template <class ListItemType, class ListStorage>
+CList<ListItemType, ListStorage>::CList(const CList   &object)
 {
-    m_items = new ListItemType[object.m_currSize];
+    m_items = AllocateItems(object.m_currSize);
 
     //update variables
     m_numItems = object.m_numItems;
@@ -129,8 +211,8 @@ CList<ListItemType>::CList(const CList   &object)
 // This is the destructor, which calls the DestroyList function.
 //
 // ============================================================================
-template <class ListItemType>
-CList<ListItemType>::~CList()
+template <class ListItemType, class ListStorage>
+CList<ListItemType, ListStorage>::~CList()
 {
     DestroyList();
 }
@@ -147,13 +229,14 @@ CList<ListItemType>::~CList()
 //      void
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::DestroyList()
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::DestroyList()
 {
+    FreeItems(m_items, m_currSize);
+
     m_numItems = 0;
     m_currSize = 0;
-
-    delete []m_items;
+    m_items = NULL;
 
 }
 // end of CList::DestoryList()
@@ -172,8 +255,8 @@ void CList<ListItemType>::DestroyList()
 //      item    -- a ListItemType object.
 //
 // ============================================================================
-template <class ListItemType>
-ListItemType CList<ListItemType>::GetItem(int  index) const throw (CListException)
+template <class ListItemType, class ListStorage>
+ListItemType CList<ListItemType, ListStorage>::GetItem(int  index) const
 {
     // case #1: Empty List
     if (IsEmpty())
@@ -202,8 +285,8 @@ ListItemType CList<ListItemType>::GetItem(int  index) const throw (CListExceptio
 //      A int value.
 //
 // ============================================================================
-template <class ListItemType>
-int CList<ListItemType>::GetNumItems() const
+template <class ListItemType, class ListStorage>
+int CList<ListItemType, ListStorage>::GetNumItems() const
 {
     return (m_numItems);
 } // end of CList::GetNumItems
@@ -220,8 +303,8 @@ int CList<ListItemType>::GetNumItems() const
 //      void
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::Insert(const ListItemType  &newItem) throw (CListException)
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::Insert(const ListItemType  &newItem)
 {
     // case #1: the list is full
     if (IsFull())
@@ -252,8 +335,8 @@ void CList<ListItemType>::Insert(const ListItemType  &newItem) throw (CListExcep
 //      A boolean value. True if list is empty, false otherwise.
 //
 // ============================================================================
-template <class ListItemType>
-bool CList<ListItemType>::IsEmpty() const
+template <class ListItemType, class ListStorage>
+bool CList<ListItemType, ListStorage>::IsEmpty() const
 {
     return (m_numItems == 0);
 }
@@ -270,8 +353,8 @@ bool CList<ListItemType>::IsEmpty() const
 //      A boolean value. True if list is full, false otherwise.
 //
 // ============================================================================
-template <class ListItemType>
-bool CList<ListItemType>::IsFull() const
+template <class ListItemType, class ListStorage>
+bool CList<ListItemType, ListStorage>::IsFull() const
 {
     return (m_numItems == m_currSize);
 } // end of CList::IsFull()
@@ -297,8 +380,8 @@ bool CList<ListItemType>::IsFull() const
 //      void
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::Remove(const ListItemType  &value) throw (CListException)
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::Remove(const ListItemType  &value)
 {
     int index;
     bool funcStatus;
@@ -346,29 +429,35 @@ void CList<ListItemType>::Remove(const ListItemType  &value) throw (CListExcepti
 //      void
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::SetListSize(int num)
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::SetListSize(int num)
 {
     // create a pointer to hold new list size
-    ListItemType *newItems = new ListItemType[num];
-    int i = 0; // counter
+    ListItemType *newItems = AllocateItems(num);
     int stopVal;
 
     // check if the list is getting smaller or larger to appropriate resize
     stopVal = (m_numItems > num) ? num : m_numItems;
 
-    for ( i = 0; i < stopVal; i++)
+    // a throwing move or copy leaves the old array in place
+    try
     {
-        newItems[i] = m_items[i];
+        RelocateItems(newItems, stopVal);
+    }
+    catch (...)
+    {
+        FreeItems(newItems, num);
+        throw;
     }
-    // update data members
-    m_currSize = num;
-    m_numItems = stopVal;
 
     // delete old pointer and update
-    delete [] m_items;
+    FreeItems(m_items, m_currSize);
     m_items = newItems;
 
+    // update data members
+    m_currSize = num;
+    m_numItems = stopVal;
+
 }// end of CList::SetListSize()
 
 
@@ -383,8 +472,8 @@ void CList<ListItemType>::SetListSize(int num)
 //      void
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::Clear()
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::Clear()
 {
     // set m_numItems to zero
     m_numItems = 0;
@@ -404,8 +493,8 @@ void CList<ListItemType>::Clear()
 //      A reference to the calling object.
 //
 // ============================================================================
-template <class ListItemType>
-CList<ListItemType>& CList<ListItemType>::operator=(const CList &rhs)
+template <class ListItemType, class ListStorage>
+CList<ListItemType, ListStorage>& CList<ListItemType, ListStorage>::operator=(const CList &rhs)
 {
     // case #1 self assigning guard
     // check the case assigning the object to itself
@@ -432,8 +521,8 @@ CList<ListItemType>& CList<ListItemType>::operator=(const CList &rhs)
 //      A reference to the calling object.
 //
 // ============================================================================
-template<class ListItemType>
-ListItemType& CList<ListItemType>::operator[](const int index)
+template <class ListItemType, class ListStorage>
+ListItemType& CList<ListItemType, ListStorage>::operator[](const int index)
 {
     if ((index < 0 ) || (index > (m_numItems - 1 )))
     {
@@ -474,8 +563,8 @@ ListItemType& CList<ListItemType>::operator[](const int index)
 //      An integer reporting the number of items moved.
 //
 // ============================================================================
-template <class ListItemType>
-int CList<ListItemType>::MoveItems(int  index, char  direction)
+template <class ListItemType, class ListStorage>
+int CList<ListItemType, ListStorage>::MoveItems(int  index, char  direction)
 {
     int finalLocation;
     int shiftSize;
@@ -526,6 +615,159 @@ int CList<ListItemType>::MoveItems(int  index, char  direction)
 
 // end of CList::MoveItems()
 
+// ==== CList::RelocateItems ==================================================
+//
+// This function moves the first count elements of the list into a newly
+// allocated array. Trivially copyable elements are moved with one memcpy;
+// other elements are move-assigned, so a resize does not copy their
+// resources (such as the characters of a std::string).
+//
+// Input:
+//      newItems    -- the new array, with room for at least count elements
+//      count       -- the number of elements to move
+//
+// Output:
+//      void
+//
+// ============================================================================
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::RelocateItems(ListItemType *newItems, int count)
+{
+    RelocateItems(newItems, count,
+                  std::integral_constant<bool,
+                      std::is_trivially_copyable<ListItemType>::value>());
+}
+
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::RelocateItems(ListItemType *newItems, int count,
+                                        std::true_type)
+{
+    if (count > 0)
+    {
+        std::memcpy(static_cast<void *>(newItems), m_items,
+                    count * sizeof(ListItemType));
+    }
+}
+
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::RelocateItems(ListItemType *newItems, int count,
+                                        std::false_type)
+{
+    for (int i = 0; i < count; i++)
+    {
+        newItems[i] = std::move(m_items[i]);
+    }
+}
+// end of CList::RelocateItems()
+
+
+// ==== CList::GetLeadBytes ===================================================
+//
+// This function returns the number of bytes between the start of the
+// aligned allocation and item 0, as set by the storage policy.
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: the lead in bytes
+//
+// ============================================================================
+template <class ListItemType, class ListStorage>
+int CList<ListItemType, ListStorage>::GetLeadBytes(void)
+{
+    return ListStorage::template GetLeadBytes<ListItemType>();
+}
+// end of CList::GetLeadBytes()
+
+
+// ==== CList::AllocateItems ==================================================
+//
+// This function allocates an aligned array of num default initialized
+// items, laid out as described by the storage policy.
+//
+// Input:
+//      num     -- the number of items
+//
+// Output:
+//      ListItemType* -- the first item; std::bad_alloc is thrown on failure
+//
+// ============================================================================
+template <class ListItemType, class ListStorage>
+ListItemType* CList<ListItemType, ListStorage>::AllocateItems(int num)
+{
+    const std::size_t alignment =
+        (alignof(ListItemType) > ListStorage::ALIGNMENT)
+        ? alignof(ListItemType) : ListStorage::ALIGNMENT;
+    std::size_t numBytes = GetLeadBytes() + num * sizeof(ListItemType);
+    char *storage = static_cast<char *>(
+                        ::operator new(numBytes, std::align_val_t(alignment)));
+    ListItemType *items = reinterpret_cast<ListItemType *>(storage
+                                                           + GetLeadBytes());
+
+    if (!std::is_trivially_default_constructible<ListItemType>::value)
+    {
+        int i = 0;
+        try
+        {
+            for (; i < num; i++)
+            {
+                new (static_cast<void *>(items + i)) ListItemType;
+            }
+        }
+        catch (...)
+        {
+            while (i > 0)
+            {
+                items[--i].~ListItemType();
+            }
+            ::operator delete(storage, std::align_val_t(alignment));
+            throw;
+        }
+    }
+
+    return items;
+}
+// end of CList::AllocateItems()
+
+
+// ==== CList::FreeItems ======================================================
+//
+// This function destroys and frees an array made by AllocateItems.
+//
+// Input:
+//      items   -- the first item, or NULL
+//      num     -- the number of items it was allocated with
+//
+// Output:
+//      void
+//
+// ============================================================================
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::FreeItems(ListItemType *items, int num)
+{
+    if (items == NULL)
+    {
+        return;
+    }
+
+    const std::size_t alignment =
+        (alignof(ListItemType) > ListStorage::ALIGNMENT)
+        ? alignof(ListItemType) : ListStorage::ALIGNMENT;
+
+    if (!std::is_trivially_destructible<ListItemType>::value)
+    {
+        for (int i = 0; i < num; i++)
+        {
+            items[i].~ListItemType();
+        }
+    }
+
+    ::operator delete(reinterpret_cast<char *>(items) - GetLeadBytes(),
+                      std::align_val_t(alignment));
+}
+// end of CList::FreeItems()
+
 // ==== CList::CopyList =======================================================
 //
 // This function copies the contents of one CList object to another CList
@@ -540,12 +782,13 @@ int CList<ListItemType>::MoveItems(int  index, char  direction)
 //      destination object.
 //
 // ============================================================================
-template <class ListItemType>
-int CList<ListItemType>::CopyList(const CList &otherList)
+template <class ListItemType, class ListStorage>
+int CList<ListItemType, ListStorage>::CopyList(const CList &otherList)
 {
     // delete the pre-exsiting data and allocate space
-    delete [] m_items;
-    m_items = new ListItemType[otherList.m_currSize];
+    ListItemType *newItems = AllocateItems(otherList.m_currSize);
+    FreeItems(m_items, m_currSize);
+    m_items = newItems;
 
     // update variables
     m_numItems = otherList.m_numItems;
@@ -578,9 +821,8 @@ int CList<ListItemType>::CopyList(const CList &otherList)
 //      bool (true when found, false otherwise)
 //
 // ============================================================================
-template <class ListItemType>
-bool CList<ListItemType>::ItemExists(int &index, const ListItemType &item)
-throw (CListException)
+template <class ListItemType, class ListStorage>
+bool CList<ListItemType, ListStorage>::ItemExists(int &index, const ListItemType &item)
 {
     // case #1: Empty List
     if (IsEmpty())
@@ -623,11 +865,11 @@ throw (CListException)
 //      destination object.
 //
 // ============================================================================
-template<class ListItemType>
-void CList<ListItemType>::CopyCMaxMinHeapConstructorHelper(const CList &otherObj)
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::CopyCMaxMinHeapConstructorHelper(const CList &otherObj)
 {
     // allocate space
-    m_items = new ListItemType[otherObj.m_currSize];
+    m_items = AllocateItems(otherObj.m_currSize);
 
     // update variables
     m_numItems = otherObj.m_numItems;
@@ -654,8 +896,8 @@ void CList<ListItemType>::CopyCMaxMinHeapConstructorHelper(const CList &otherObj
 // Output:
 //      the function swaps the elements of the CList objects.
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::Swap(int target, int source)
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::Swap(int target, int source)
 {
     // Swap the elements
     ListItemType temp = m_items[target];
@@ -666,6 +908,176 @@ void CList<ListItemType>::Swap(int target, int source)
 // end of CList::Swap()
 
 
+// ==== RemoveLast ============================================================
+//
+// This function removes the last element of the list without searching for
+// it, which lets the child class drop an element it has just swapped to the
+// end of the array.
+//
+// The function throws error codes from the class CListException
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::RemoveLast(void)
+{
+    if (IsEmpty())
+    {
+        throw CListException(CLIST_EMPTY);
+    }
+
+    --m_numItems;
+}
+// end of CList::RemoveLast()
+
+
+// ==== GetItemArray ==========================================================
+//
+// This function gives the child class read-only access to the item array, so
+// the items can be written out in their array order without copying them one
+// by one through GetItem
+//
+// Input:
+//      void
+//
+// Output:
+//      A const pointer to the first element of the array
+// ============================================================================
+template <class ListItemType, class ListStorage>
+const ListItemType* CList<ListItemType, ListStorage>::GetItemArray(void) const
+{
+    return m_items;
+}
+// end of CList::GetItemArray()
+
+
+// ==== GetItemArray ==========================================================
+//
+// This function gives the child class write access to the item array, so it
+// can reorder the items in place (for example to build a heap in one pass)
+//
+// Input:
+//      void
+//
+// Output:
+//      A pointer to the first element of the array
+// ============================================================================
+template <class ListItemType, class ListStorage>
+ListItemType* CList<ListItemType, ListStorage>::GetItemArray(void)
+{
+    return m_items;
+}
+// end of CList::GetItemArray()
+
+
+// ==== GetListSize ===========================================================
+//
+// This function returns the allocated array size (the number of items that
+// fit before the list is full)
+//
+// Input:
+//      void
+//
+// Output:
+//      A int value.
+// ============================================================================
+template <class ListItemType, class ListStorage>
+int CList<ListItemType, ListStorage>::GetListSize(void) const
+{
+    return m_currSize;
+}
+// end of CList::GetListSize()
+
+
+// ==== AppendItem ============================================================
+//
+// This function adds one element at the end of the list and returns it, so
+// the caller can fill it in place instead of building an item and copying it
+// in through Insert. If the list is full, the function will throw an error.
+//
+// Input:
+//      void
+//
+// Output:
+//      A reference to the new (default constructed) element
+// ============================================================================
+template <class ListItemType, class ListStorage>
+ListItemType& CList<ListItemType, ListStorage>::AppendItem(void)
+{
+    if (IsFull())
+    {
+        throw CListException(CLIST_FULL);
+    }
+
+    return m_items[m_numItems++];
+}
+// end of CList::AppendItem()
+
+
+// ==== RemoveIf ==============================================================
+//
+// This function removes every element for which the predicate returns true,
+// in one pass over the array. The remaining elements are moved towards the
+// front and keep their relative order. If the predicate throws, the
+// elements it has not yet been asked about are kept and moved down behind
+// the kept ones before the exception is passed on, so no moved-from element
+// is left inside the list.
+//
+// Input:
+//      removeItem  -- a function object taking a const ListItemType& and
+//                     returning true for the elements to remove
+//
+// Output:
+//      The number of elements removed
+// ============================================================================
+template <class ListItemType, class ListStorage>
+template <class Predicate>
+int CList<ListItemType, ListStorage>::RemoveIf(Predicate removeItem)
+{
+    int keptItems = 0;
+    int i = 0;
+
+    try
+    {
+        for (; i < m_numItems; i++)
+        {
+            if (!removeItem(static_cast<const ListItemType &>(m_items[i])))
+            {
+                if (keptItems != i)
+                {
+                    m_items[keptItems] = std::move(m_items[i]);
+                }
+                keptItems++;
+            }
+        }
+    }
+    catch (...)
+    {
+        // keep the unvisited tail
+        for (; i < m_numItems; i++)
+        {
+            if (keptItems != i)
+            {
+                m_items[keptItems] = std::move(m_items[i]);
+            }
+            keptItems++;
+        }
+        m_numItems = keptItems;
+        throw;
+    }
+
+    int removedItems = m_numItems - keptItems;
+    m_numItems = keptItems;
+
+    return removedItems;
+}
+// end of CList::RemoveIf()
+
+
 // ==== CListDisplay ========================================================
 //
 // The function displays each element of the CList object
@@ -676,8 +1088,8 @@ void CList<ListItemType>::Swap(int target, int source)
 //      The function displays each element of the CList object
 //
 // ============================================================================
-template <class ListItemType>
-void CList<ListItemType>::CListDisplay(void) const
+template <class ListItemType, class ListStorage>
+void CList<ListItemType, ListStorage>::CListDisplay(void) const
 {
     // display each element
     for (int i = 0; i < m_numItems; i++)
@@ -687,4 +1099,4 @@ void CList<ListItemType>::CListDisplay(void) const
 }
 // end of CList::CListDisplay()
 
-
+#endif // DYNAMIC_CLIST_HEADER
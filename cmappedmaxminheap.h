@@ -0,0 +1,639 @@
+// ============================================================================
+// File: cmappedmaxminheap.h
+// ============================================================================
+// Header file for the CMappedMaxMinHeap class, a heap of trivially copyable
+// items that lives in a memory-mapped file.
+//
+// The file holds a fixed size header followed by the items in the same array
+// order CList uses for a CMaxMinHeap. Reopening a file therefore needs no
+// parsing and no re-heapify: the array is used in place and only the pages
+// that a PeekTop, Insert or Remove touches are read from disk.
+//
+// SaveHeapSnapshot writes an in-memory CMaxMinHeap in this format, so a queue
+// can be saved on shutdown and reopened through CMappedMaxMinHeap on restart.
+//
+// The kernel writes dirty pages back whenever it likes, so a crash in the
+// middle of an Insert or Remove can leave any mix of old and new pages in
+// the file. The header therefore carries a dirty flag: it is set, and
+// synced to disk, before the first change after an open or a Checkpoint,
+// and only a waiting Checkpoint clears it. Opening a file whose flag is set
+// rebuilds the heap order with HeapBuild. Items that a cut-short operation
+// was moving may be lost or stored twice; the rest are kept.
+//
+// File layout (version 1):
+//      bytes [0, 64)   -- CMappedHeapHeader
+//      bytes [64, ...) -- m_capacity items, the first m_numItems in use
+// ============================================================================
+#ifndef CMAPPEDMAXMINHEAP_H
+#define CMAPPEDMAXMINHEAP_H
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <cstdio>
+#include    <cstring>
+#include    <string>
+#include    <type_traits>
+#include    <fcntl.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+#include    "cmaxminheap.h"
+#include    "heapsift.h"
+
+// constants
+const   char        MAPPED_HEAP_MAGIC[8] = "CMMHEAP";
+const   uint32_t    MAPPED_HEAP_VERSION = 1;
+
+// enumerate list for CMappedHeapException class
+enum    CMappedHeapExceptionType  { MAPPED_HEAP_OPEN_FAILED,
+                                    MAPPED_HEAP_BAD_FORMAT,
+                                    MAPPED_HEAP_IO_ERROR,
+                                    MAPPED_HEAP_EMPTY
+                                  };
+
+
+// exception class for CMappedMaxMinHeap
+class CMappedHeapException
+{
+public:
+    // constructor
+    CMappedHeapException(CMappedHeapExceptionType   exceptType)
+            : m_exceptType(exceptType) {}
+
+    // member function
+    CMappedHeapExceptionType GetException() const {return m_exceptType;}
+
+private:
+    CMappedHeapExceptionType  m_exceptType;
+};
+
+
+// file header, padded to 64 bytes so the item array starts on a cache line
+struct  CMappedHeapHeader
+{
+    char        m_magic[8];     // MAPPED_HEAP_MAGIC
+    uint32_t    m_version;      // MAPPED_HEAP_VERSION
+    uint32_t    m_itemSize;     // sizeof(HeapItemType) of the writer
+    uint32_t    m_heapType;     // MAX or MIN
+    uint32_t    m_dirty;        // changed since the last Checkpoint
+    uint64_t    m_numItems;     // number of items in use
+    uint64_t    m_capacity;     // number of item slots in the file
+    char        m_padding[24];
+};
+
+static_assert(sizeof(CMappedHeapHeader) == 64,
+              "CMappedHeapHeader must stay 64 bytes (file format)");
+
+
+// class declaration
+template <class HeapItemType>
+class   CMappedMaxMinHeap
+{
+    static_assert(std::is_trivially_copyable<HeapItemType>::value,
+                  "CMappedMaxMinHeap items are stored as raw bytes");
+
+public:
+    // constructor and destructor
+    CMappedMaxMinHeap(const char *fileName, int heapType = MAX,
+                      int numItems = HEAP_MAX_ITEMS);
+    virtual ~CMappedMaxMinHeap();
+
+    // member functions
+    void            Checkpoint(bool waitForDisk = true);
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+
+    // Helper functions
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    // a mapping cannot be shared by two objects
+    CMappedMaxMinHeap(const CMappedMaxMinHeap &otherObj);
+    CMappedMaxMinHeap& operator=(const CMappedMaxMinHeap &rhs);
+
+    // data members
+    int                 m_fileDesc; // file descriptor of the heap file
+    size_t              m_mapSize;  // number of bytes mapped
+    CMappedHeapHeader   *m_header;  // start of the mapping
+
+    // utility functions
+    HeapItemType*   GetItems(void) const;
+    void            MapFile(size_t numBytes);
+    void            UnmapFile(void);
+    void            MarkDirty(void);
+    void            Rebuild(void);
+};
+
+
+// ==== MappedHeapFileSize ====================================================
+//
+// This function returns the file size needed for a number of item slots.
+//
+// Input:
+//      capacity    -- [IN]: the number of item slots
+//      itemSize    -- [IN]: the size of one item in bytes
+//
+// Output:
+//      size_t      -- [OUT]: the size of the file in bytes
+// ============================================================================
+inline size_t MappedHeapFileSize(uint64_t capacity, size_t itemSize)
+{
+    return (sizeof(CMappedHeapHeader) + static_cast<size_t>(capacity) * itemSize);
+}
+// end of MappedHeapFileSize()
+
+
+// ==== CMappedMaxMinHeap::CMappedMaxMinHeap ==================================
+//
+// This constructor opens the heap file, or creates it when it does not exist
+// yet. An existing file keeps its own heap type; heapType and numItems are
+// only used for a new file.
+//
+// ============================================================================
+template <class HeapItemType>
+CMappedMaxMinHeap<HeapItemType>::CMappedMaxMinHeap(const char *fileName,
+                                                   int heapType, int numItems)
+: m_fileDesc(-1), m_mapSize(0), m_header(NULL)
+{
+    struct stat fileStatus;
+
+    m_fileDesc = open(fileName, O_RDWR | O_CREAT, 0644);
+    if ((m_fileDesc < 0) || (fstat(m_fileDesc, &fileStatus) != 0))
+    {
+        if (m_fileDesc >= 0)
+        {
+            close(m_fileDesc);
+        }
+        throw CMappedHeapException(MAPPED_HEAP_OPEN_FAILED);
+    }
+
+    // case #1: a new file, write an empty heap
+    if (fileStatus.st_size == 0)
+    {
+        uint64_t capacity = (numItems > 0) ? numItems : HEAP_MAX_ITEMS;
+        size_t fileSize = MappedHeapFileSize(capacity, sizeof(HeapItemType));
+
+        if (ftruncate(m_fileDesc, fileSize) != 0)
+        {
+            close(m_fileDesc);
+            throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+        }
+        try
+        {
+            MapFile(fileSize);
+        }
+        catch (...)
+        {
+            close(m_fileDesc);
+            throw;
+        }
+
+        std::memcpy(m_header->m_magic, MAPPED_HEAP_MAGIC, sizeof(m_header->m_magic));
+        m_header->m_version = MAPPED_HEAP_VERSION;
+        m_header->m_itemSize = sizeof(HeapItemType);
+        m_header->m_heapType = heapType;
+        m_header->m_dirty = 0;
+        m_header->m_numItems = 0;
+        m_header->m_capacity = capacity;
+        return;
+    }
+
+    // case #2: an existing file, validate the header before using the items
+    if (static_cast<size_t>(fileStatus.st_size) < sizeof(CMappedHeapHeader))
+    {
+        close(m_fileDesc);
+        throw CMappedHeapException(MAPPED_HEAP_BAD_FORMAT);
+    }
+    try
+    {
+        MapFile(fileStatus.st_size);
+    }
+    catch (...)
+    {
+        close(m_fileDesc);
+        throw;
+    }
+
+    if ((std::memcmp(m_header->m_magic, MAPPED_HEAP_MAGIC,
+                     sizeof(m_header->m_magic)) != 0)
+        || (m_header->m_version != MAPPED_HEAP_VERSION)
+        || (m_header->m_itemSize != sizeof(HeapItemType))
+        || ((m_header->m_heapType != MAX) && (m_header->m_heapType != MIN))
+        || (m_header->m_capacity == 0)
+        || (m_header->m_numItems > m_header->m_capacity)
+        || (MappedHeapFileSize(m_header->m_capacity, sizeof(HeapItemType))
+            > m_mapSize))
+    {
+        UnmapFile();
+        close(m_fileDesc);
+        throw CMappedHeapException(MAPPED_HEAP_BAD_FORMAT);
+    }
+
+    // case #3: the last writer did not checkpoint, restore the heap order
+    if (m_header->m_dirty != 0)
+    {
+        Rebuild();
+    }
+}
+// end of CMappedMaxMinHeap::CMappedMaxMinHeap()
+
+
+// ==== CMappedMaxMinHeap::~CMappedMaxMinHeap() ===============================
+//
+// This is the destructor. It releases the mapping without waiting for the
+// disk; call Checkpoint first when the file must be durable.
+//
+// ============================================================================
+template <class HeapItemType>
+CMappedMaxMinHeap<HeapItemType>::~CMappedMaxMinHeap()
+{
+    UnmapFile();
+    close(m_fileDesc);
+}
+// end of CMappedMaxMinHeap::~CMappedMaxMinHeap()
+
+
+// ==== CMappedMaxMinHeap::MapFile() ==========================================
+//
+// This function maps the first numBytes of the heap file, replacing any
+// existing mapping. The old mapping is kept if the new one fails.
+//
+// Input:
+//      numBytes    -- [IN]: the number of bytes to map
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CMappedMaxMinHeap<HeapItemType>::MapFile(size_t numBytes)
+{
+    void *address = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         m_fileDesc, 0);
+    if (address == MAP_FAILED)
+    {
+        throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+    }
+
+    UnmapFile();
+    m_header = static_cast<CMappedHeapHeader *>(address);
+    m_mapSize = numBytes;
+}
+// end of CMappedMaxMinHeap::MapFile()
+
+
+// ==== CMappedMaxMinHeap::UnmapFile() ========================================
+//
+// This function releases the current mapping, if any.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CMappedMaxMinHeap<HeapItemType>::UnmapFile(void)
+{
+    if (m_header != NULL)
+    {
+        munmap(m_header, m_mapSize);
+        m_header = NULL;
+        m_mapSize = 0;
+    }
+}
+// end of CMappedMaxMinHeap::UnmapFile()
+
+
+// ==== CMappedMaxMinHeap::GetItems() =========================================
+//
+// This function returns the item array that follows the header.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType* -- [OUT]: the first item slot
+// ============================================================================
+template <class HeapItemType>
+HeapItemType* CMappedMaxMinHeap<HeapItemType>::GetItems(void) const
+{
+    return reinterpret_cast<HeapItemType *>(m_header + 1);
+}
+// end of CMappedMaxMinHeap::GetItems()
+
+
+// ==== CMappedMaxMinHeap::MarkDirty() ========================================
+//
+// This function sets the dirty flag before the first change after an open or
+// a Checkpoint. The header is synced at once, so no page written back later
+// can reach the disk ahead of the flag.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CMappedMaxMinHeap<HeapItemType>::MarkDirty(void)
+{
+    if (m_header->m_dirty == 0)
+    {
+        m_header->m_dirty = 1;
+        if (msync(m_header, sizeof(CMappedHeapHeader), MS_SYNC) != 0)
+        {
+            throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+        }
+    }
+}
+// end of CMappedMaxMinHeap::MarkDirty()
+
+
+// ==== CMappedMaxMinHeap::Rebuild() ==========================================
+//
+// This function restores the heap order of a file that was not closed after
+// a Checkpoint.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CMappedMaxMinHeap<HeapItemType>::Rebuild(void)
+{
+    int numItems = static_cast<int>(m_header->m_numItems);
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapBuild(GetItems(), numItems, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapBuild(GetItems(), numItems, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CMappedMaxMinHeap::Rebuild()
+
+
+// ==== CMappedMaxMinHeap::Checkpoint() =======================================
+//
+// This function flushes the mapping to disk with msync. A waiting checkpoint
+// then clears the dirty flag, so the file reopens without a rebuild as long
+// as it is not changed again before it is closed.
+//
+// Input:
+//      waitForDisk -- [IN]: true waits for the write (MS_SYNC) and clears
+//                     the dirty flag, false only schedules it (MS_ASYNC)
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CMappedMaxMinHeap<HeapItemType>::Checkpoint(bool waitForDisk)
+{
+    if (msync(m_header, m_mapSize, waitForDisk ? MS_SYNC : MS_ASYNC) != 0)
+    {
+        throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+    }
+
+    if (waitForDisk && (m_header->m_dirty != 0))
+    {
+        m_header->m_dirty = 0;
+        if (msync(m_header, sizeof(CMappedHeapHeader), MS_SYNC) != 0)
+        {
+            throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+        }
+    }
+}
+// end of CMappedMaxMinHeap::Checkpoint()
+
+
+// ==== CMappedMaxMinHeap::Insert() ===========================================
+//
+// This function inserts an element into the heap. When the file is full, it
+// is doubled in size and mapped again.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true when the item was inserted
+// ============================================================================
+template <class HeapItemType>
+bool CMappedMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
+{
+    MarkDirty();
+
+    // case #1: the file is full, grow it
+    if (m_header->m_numItems == m_header->m_capacity)
+    {
+        uint64_t capacity = m_header->m_capacity * 2;
+        size_t fileSize = MappedHeapFileSize(capacity, sizeof(HeapItemType));
+
+        if (ftruncate(m_fileDesc, fileSize) != 0)
+        {
+            throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+        }
+        MapFile(fileSize);
+        m_header->m_capacity = capacity;
+    }
+
+    // case #2: add the item at the end and heapify up
+    HeapItemType *items = GetItems();
+    int newIndex = static_cast<int>(m_header->m_numItems);
+
+    items[newIndex] = newItem;
+    m_header->m_numItems++;
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapSiftUp(items, newIndex, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftUp(items, newIndex, CHeapMinOrder<HeapItemType>());
+    }
+
+    return true;
+}
+// end of CMappedMaxMinHeap::Insert()
+
+
+// ==== CMappedMaxMinHeap::Remove() ===========================================
+//
+// This function removes the top element of the heap.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true when an element was removed
+// ============================================================================
+template <class HeapItemType>
+bool CMappedMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
+{
+    if (IsEmpty())
+    {
+        throw CMappedHeapException(MAPPED_HEAP_EMPTY);
+    }
+
+    MarkDirty();
+
+    HeapItemType *items = GetItems();
+    int lastIndex = static_cast<int>(m_header->m_numItems) - 1;
+
+    // move the last element to the root and heapify down
+    item = items[0];
+    items[0] = items[lastIndex];
+    m_header->m_numItems--;
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapSiftDown(items, lastIndex, 0, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftDown(items, lastIndex, 0, CHeapMinOrder<HeapItemType>());
+    }
+
+    return true;
+}
+// end of CMappedMaxMinHeap::Remove()
+
+
+// ==== CMappedMaxMinHeap::PeekTop() ==========================================
+//
+// This function peeks the first element of the heap.
+// Input:
+//    void
+//
+// Output:
+//      HeapItemType --[OUT] the first element of the heap
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CMappedMaxMinHeap<HeapItemType>::PeekTop(void) const
+{
+    if (IsEmpty())
+    {
+        throw CMappedHeapException(MAPPED_HEAP_EMPTY);
+    }
+
+    return GetItems()[0];
+}
+// end of CMappedMaxMinHeap::PeekTop()
+
+
+// ==== CMappedMaxMinHeap::GetHeapType() ======================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType>
+int CMappedMaxMinHeap<HeapItemType>::GetHeapType(void) const
+{
+    return static_cast<int>(m_header->m_heapType);
+}
+// end of CMappedMaxMinHeap::GetHeapType()
+
+
+// ==== CMappedMaxMinHeap::GetNumItems() ======================================
+//
+// This function returns the number of items stored in the heap.
+// ============================================================================
+template <class HeapItemType>
+int CMappedMaxMinHeap<HeapItemType>::GetNumItems(void) const
+{
+    return static_cast<int>(m_header->m_numItems);
+}
+// end of CMappedMaxMinHeap::GetNumItems()
+
+
+// ==== CMappedMaxMinHeap::IsEmpty() ==========================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType>
+bool CMappedMaxMinHeap<HeapItemType>::IsEmpty(void) const
+{
+    return (m_header->m_numItems == 0);
+}
+// end of CMappedMaxMinHeap::IsEmpty()
+
+
+// ==== SaveHeapSnapshot ======================================================
+//
+// This function writes a CMaxMinHeap to a heap file that CMappedMaxMinHeap
+// can open. The items are written in their array order, so the file is a
+// valid heap as is. The data goes to "<fileName>.tmp" first and is renamed
+// over fileName once it is on disk, so a crash never leaves a torn snapshot.
+//
+// Input:
+//      heap        -- [IN]: the heap to save
+//      fileName    -- [IN]: the snapshot file
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void SaveHeapSnapshot(const CMaxMinHeap<HeapItemType> &heap,
+                      const char *fileName)
+{
+    static_assert(std::is_trivially_copyable<HeapItemType>::value,
+                  "heap snapshots store items as raw bytes");
+
+    std::string tempName = std::string(fileName) + ".tmp";
+    CMappedHeapHeader header;
+    int numItems = heap.GetNumItems();
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.m_magic, MAPPED_HEAP_MAGIC, sizeof(header.m_magic));
+    header.m_version = MAPPED_HEAP_VERSION;
+    header.m_itemSize = sizeof(HeapItemType);
+    header.m_heapType = heap.GetHeapType();
+    header.m_numItems = numItems;
+    header.m_capacity = (numItems > 0) ? numItems : HEAP_MAX_ITEMS;
+
+    int fileDesc = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fileDesc < 0)
+    {
+        throw CMappedHeapException(MAPPED_HEAP_OPEN_FAILED);
+    }
+
+    // write the header and the items, then size the file to the capacity
+    const char *chunks[2] = { reinterpret_cast<const char *>(&header),
+                              reinterpret_cast<const char *>(heap.GetItemArray()) };
+    size_t chunkSizes[2] = { sizeof(header),
+                             static_cast<size_t>(numItems) * sizeof(HeapItemType) };
+    bool success = true;
+
+    for (int chunk = 0; (chunk < 2) && success; ++chunk)
+    {
+        size_t written = 0;
+        while ((written < chunkSizes[chunk]) && success)
+        {
+            ssize_t result = write(fileDesc, chunks[chunk] + written,
+                                   chunkSizes[chunk] - written);
+            success = (result > 0);
+            written += (result > 0) ? result : 0;
+        }
+    }
+
+    success = success
+              && (ftruncate(fileDesc, MappedHeapFileSize(header.m_capacity,
+                                                         sizeof(HeapItemType))) == 0)
+              && (fsync(fileDesc) == 0);
+    close(fileDesc);
+
+    if (!success || (std::rename(tempName.c_str(), fileName) != 0))
+    {
+        unlink(tempName.c_str());
+        throw CMappedHeapException(MAPPED_HEAP_IO_ERROR);
+    }
+}
+// end of SaveHeapSnapshot()
+
+#endif // CMAPPEDMAXMINHEAP_H
@@ -5,7 +5,15 @@
 // ============================================================================
 #ifndef CMAXMINHEAP_H
 #define CMAXMINHEAP_H
+#include    <algorithm>
+#include    <iterator>
+#include    <optional>
+#include    <type_traits>
+#include    <utility>
+#include    <vector>
 #include    "clist.h"
+#include    "heapsift.h"
+#include    "heaptopview.h"
 
 // constants
 const   int HEAP_MAX_ITEMS = MAX_ITEMS; // same value from "clist.h"
@@ -28,15 +36,33 @@ public:
             : m_exceptType(exceptType) {}
 
     // member function
-    CMaxMinHeapException GetException() const {return m_exceptType;}
+    CMaxMinHeapExceptionType GetException() const {return m_exceptType;}
 
 private:
     CMaxMinHeapExceptionType  m_exceptType;
 };
 
+// storage policy of the item array for each heap layout: the B-heap wants
+// its pages on virtual memory pages, the implicit heap its sibling pairs on
+// cache lines (see clist.h)
+template <class HeapLayout>
+struct  CHeapListStorage : CListLineStorage
+{
+};
+
+template <int PageShift>
+struct  CHeapListStorage<CBHeapLayout<PageShift>> : CListPageStorage
+{
+};
+
 // class declaration
-template <class HeapItemType>
-class   CMaxMinHeap : private CList<HeapItemType>
+// HeapLayout is a heaplayout.h policy: CImplicitHeapLayout (2i+1, 2i+2) or
+// a CBHeapLayout for heaps much larger than the caches and the TLB reach.
+// KeyOf is a heapkey.h projection; the heap compares the keys it returns.
+template <class HeapItemType, class HeapLayout = CImplicitHeapLayout,
+          class KeyOf = CHeapIdentityKey>
+class   CMaxMinHeap
+        : private CList<HeapItemType, CHeapListStorage<HeapLayout>>
 {
 public:
     // constructors and destructor
@@ -47,16 +73,61 @@ public:
 
     // member functions
     void            DestroyHeap();
-    bool            Remove(HeapItemType &item) throw (CMaxMinHeapException);
-    bool            Insert(const HeapItemType  &newItem) throw (CMaxMinHeapException);
-    HeapItemType    PeekTop(void) const throw (CMaxMinHeapException);
+    bool            Remove(HeapItemType &item);
+    bool            Insert(const HeapItemType  &newItem);
+    HeapItemType    PeekTop(void) const;
+
+    // exception-free versions of Insert, Remove and PeekTop; a copy that
+    // throws is reported as failure, but they are noexcept only for items
+    // whose moves cannot throw (see NOTHROW_SIFT)
+    bool                        TryPush(const HeapItemType  &newItem)
+                                                    noexcept(NOTHROW_SIFT);
+    std::optional<HeapItemType> TryPop(void) noexcept(NOTHROW_SIFT);
+    bool                        TryPop(std::optional<HeapItemType> &item)
+                                                    noexcept(NOTHROW_SIFT);
+    const HeapItemType*         TryPeek(void) const noexcept;
+
+    // bulk loading: reserve, append every item unordered, then heapify once
+    void            Reserve(int numItems);
+    HeapItemType&   AppendUnordered(void);
+    void            Heapify(void);
+
+    // in-place sort into priority order, which is still a valid heap
+    void            SortItems(void);
+
+    // bulk removal: one compaction pass, then one O(n) heapify
+    template <class Predicate>
+    int             RemoveIf(Predicate removeItem);
+    template <class Predicate>
+    int             Retain(Predicate keepItem);
+
+    // batch removal: the first count items in priority order, in one call
+    template <class OutputIt>
+    int             PopN(int count, OutputIt output);
+
+    // non-destructive walk over the first count items in priority order
+    CHeapTopView<HeapItemType, HeapLayout, KeyOf>  TopView(int count) const;
 
 
     // Helper functions
     bool            IsLeaf(int index);
     void            Display(void) const;
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+    const HeapItemType* GetItemArray(void) const;
 
 private:
+    typedef CList<HeapItemType, CHeapListStorage<HeapLayout>>       ListType;
+    typedef typename CHeapOrderOf<HeapItemType, KeyOf>::MaxOrder    MaxOrder;
+    typedef typename CHeapOrderOf<HeapItemType, KeyOf>::MinOrder    MinOrder;
+
+    // a sift only moves items, so it cannot throw if their moves cannot;
+    // otherwise a throwing move reaches the caller, as it did before
+    static constexpr bool NOTHROW_SIFT
+        = std::is_nothrow_move_constructible<HeapItemType>::value
+          && std::is_nothrow_move_assignable<HeapItemType>::value;
+
     // data members
     int m_heapType; // heapType
     int m_numItems; // number of nodes
@@ -68,13 +139,13 @@ private:
     int GetParentIndex(int childIndex);
 
     // member functions
-    void    Reheapification(int  rootIndex);
+    void    Reheapification(int  rootIndex) noexcept(NOTHROW_SIFT);
+    void    ReheapificationUp(int  index) noexcept(NOTHROW_SIFT);
 
 };
 
 // include implementation file since it is a template
 // #include    "cmaxminheap.tpp"
-#endif // CMAXMINHEAP_H
 
 // ==== CMaxMinHeap::CMaxMinHeap (Conversion) =================================
 //
@@ -82,9 +153,9 @@ private:
 // m_heapType, and CList objects using CList::CList default constructor
 //
 // ============================================================================
-template <class HeapItemType>
-CMaxMinHeap<HeapItemType>::CMaxMinHeap(int heapType, int numItems)
-:CList<HeapItemType>(), m_heapType(heapType), m_numItems(numItems)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::CMaxMinHeap(int heapType, int numItems)
+:ListType(), m_heapType(heapType), m_numItems(numItems)
 {
 }
 // end of CMaxMinHeap::CMaxMinHeap() (conversion Constructor)
@@ -93,23 +164,15 @@ CMaxMinHeap<HeapItemType>::CMaxMinHeap(int heapType, int numItems)
 // ==== CMaxMinHeap::CMaxMinHeap (Copy) =======================================
 //
 // This is the copy constructor that initializes the variable m_numItems,
-// m_heapType, and CList objects using other CMaxMinHeap obejct
+// m_heapType, and CList objects using other CMaxMinHeap obejct. The items
+// are copied in the order they are stored, which is already a valid heap.
 //
 // ============================================================================
-template <class HeapItemType>
-CMaxMinHeap<HeapItemType>::CMaxMinHeap(const CMaxMinHeap &otherObj)
-:m_heapType(otherObj.m_heapType), m_numItems(CList<HeapItemType>::GetNumItems())
+template <class HeapItemType, class HeapLayout, class KeyOf>
+CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::CMaxMinHeap(const CMaxMinHeap &otherObj)
+:ListType(otherObj), m_heapType(otherObj.m_heapType),
+ m_numItems(otherObj.m_numItems)
 {
-    // copy CList elements
-    CList<HeapItemType>::CopyCMaxMinHeapConstructorHelper();
-
-    // Heapify down the CList object
-    for (int index = CList<HeapItemType>::GetNumItems() / 2 ; index >= 0; index--)
-	{
-	    // call Reheapfication function
-		Reheapification(index);
-	}
-
 }
 // end of CMaxMinHeap::CMaxMinHeap() (copy constructor)
 
@@ -119,8 +182,8 @@ CMaxMinHeap<HeapItemType>::CMaxMinHeap(const CMaxMinHeap &otherObj)
 // This is the destructor.
 //
 // ============================================================================
-template <class HeapItemType>
-CMaxMinHeap<HeapItemType>::~CMaxMinHeap()
+template <class HeapItemType, class HeapLayout, class KeyOf>
+CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::~CMaxMinHeap()
 {
     DestroyHeap();
 }
@@ -136,12 +199,12 @@ CMaxMinHeap<HeapItemType>::~CMaxMinHeap()
 // Output:
 //      A boolean value. True if the node is a leaf, false otherwise.
 // ============================================================================
-template<class HeapItemType>
-bool CMaxMinHeap<HeapItemType>::IsLeaf(int index)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::IsLeaf(int index)
 {
     // if the node is leaf, the index of the left child of the node is
     // equal to or greater than the number of nodes.
-    return (GetLeftChildIndex(index) >= m_numItems);
+    return (GetLeftChildIndex(index) >= ListType::GetNumItems());
 }
 // end of CMaxMinHeap::IsLeaf()
 
@@ -156,10 +219,15 @@ bool CMaxMinHeap<HeapItemType>::IsLeaf(int index)
 // Output:
 //      int the left child index [OUT] -- the left child index of the node
 // ============================================================================
-template<class HeapItemType>
-int CMaxMinHeap<HeapItemType>::GetLeftChildIndex(int parentIndex)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetLeftChildIndex(int parentIndex)
 {
-    return ((parentIndex * 2 + 1));
+    int leftIndex = 0;
+    int rightIndex = 0;
+
+    HeapLayout::GetChildIndices(parentIndex, leftIndex, rightIndex);
+
+    return leftIndex;
 }
 // end of CMaxMinHeap::GetLeftChildIndex()
 
@@ -174,10 +242,15 @@ int CMaxMinHeap<HeapItemType>::GetLeftChildIndex(int parentIndex)
 // Output:
 //      int the right child index [OUT] -- the right child index of the node
 // ============================================================================
-template<class HeapItemType>
-int CMaxMinHeap<HeapItemType>::GetRightChildIndex(int parentIndex)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetRightChildIndex(int parentIndex)
 {
-    return ((parentIndex * 2 + 2));
+    int leftIndex = 0;
+    int rightIndex = 0;
+
+    HeapLayout::GetChildIndices(parentIndex, leftIndex, rightIndex);
+
+    return rightIndex;
 }
 // end of CMaxMinHeap::GetRightChildIndex()
 
@@ -191,17 +264,17 @@ int CMaxMinHeap<HeapItemType>::GetRightChildIndex(int parentIndex)
 // Output:
 //      int the parent index [OUT] -- the index of the parent of the node
 // ============================================================================
-template<class HeapItemType>
-int CMaxMinHeap<HeapItemType>::GetParentIndex(int childIndex)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetParentIndex(int childIndex)
 {
-    return ((childIndex - 1) / 2);
+    return HeapLayout::GetParentIndex(childIndex);
 }
 // end of CMaxMinHeap::GetParentIndex()
 
 
 // ==== CMaxMinHeap::Reheapification =========================================
 //
-// This function heapifys down the CList object using recursion
+// This function heapifys down the CList object from a node
 //
 // Input:
 //      int  index -- [IN]: the node's index
@@ -209,80 +282,55 @@ int CMaxMinHeap<HeapItemType>::GetParentIndex(int childIndex)
 // Output:
 //      void
 // ============================================================================
-template<class HeapItemType>
-void CMaxMinHeap<HeapItemType>::Reheapification(int  index)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Reheapification(int  index)
+noexcept(NOTHROW_SIFT)
 {
-    // save the indexes for reheapication
-    int leftChildIndex = GetLeftChildIndex(index);
-    int rightChildIndex = GetRightChildIndex(index);
+    HeapItemType *items = ListType::GetItemArray();
+    int numItems = ListType::GetNumItems();
 
-    // the first assumption( the left child is the largest)
-    // because heap is a complete binary tree
-    int largestIndex = leftChildIndex;
-
-    if (m_heapType == 0) // maxHeap
+    if (m_heapType == MAX) // maxHeap
     {
-        if(!IsLeaf(index)) // recursion stopping point: if it is leaf, we are done
-        {
-        // check if the right child exists
-            if (rightChildIndex < CList<HeapItemType>::GetNumItems())
-            {
-            //comparison 1: if there exists a right child, compare
-            // the node's priority level with that of the left child
-                if(  CList<HeapItemType>:: GetItem(rightChildIndex)>
-                CList<HeapItemType>::GetItem(leftChildIndex))
-                {
-                //if the right child's priority is larger, update the largestIndex
-                largestIndex = rightChildIndex;
-
-                }
-            }
-            // comparison 2: if there compare the largest node with the parent
-            if (CList<HeapItemType>:: GetItem(index)
-                < CList<HeapItemType>::GetItem(largestIndex))
-            {
-                // if the parent is smaller than the largest node
-                // conduct swap
-                CList<HeapItemType>::Swap(index, largestIndex);
-                // recursively call heapify down to the leaf
-                Reheapification(largestIndex);
-            }
-        }
+        HeapSiftDown(items, numItems, index, MaxOrder(),
+                     HeapLayout());
     }
     else // minHeap
     {
-        int smallestIndex = largestIndex;
-        if(!IsLeaf(index)) // recursion stopping point: if it is leaf, we are done
-        {
-            // check if the right child exists
-            if (rightChildIndex < CList<HeapItemType>::GetNumItems())
-            {
-                //comparison 1: if there exists a right child, compare
-                // the node's priority level with that of the left child
-                if(  CList<HeapItemType>:: GetItem(rightChildIndex)<
-                CList<HeapItemType>::GetItem(leftChildIndex))
-                {
-                    //if the right child's priority is smaller, update the largestIndex
-                    smallestIndex = rightChildIndex;
-                }
-            }
-            // comparison 2: if there compare the smallest node with the parent
-            if (CList<HeapItemType>:: GetItem(index)
-                > CList<HeapItemType>::GetItem(smallestIndex))
-            {
-                // if the parent is smaller than the largest node
-                // conduct the Swap function
-                CList<HeapItemType>::Swap(index, smallestIndex);
-                // recursively call Reheapification to heapify down to the leaf
-                Reheapification(smallestIndex);
-            }
-        }
+        HeapSiftDown(items, numItems, index, MinOrder(),
+                     HeapLayout());
     }
-
 }
 // end of CMaxMinHeap::ReHeapification()
 
 
+// ==== CMaxMinHeap::ReheapificationUp =======================================
+//
+// This function heapifys up the CList object from a node
+//
+// Input:
+//      int  index -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::ReheapificationUp(int  index)
+noexcept(NOTHROW_SIFT)
+{
+    HeapItemType *items = ListType::GetItemArray();
+
+    if (m_heapType == MAX) // maxHeap
+    {
+        HeapSiftUp(items, index, MaxOrder(), HeapLayout());
+    }
+    else // minHeap
+    {
+        HeapSiftUp(items, index, MinOrder(), HeapLayout());
+    }
+}
+// end of CMaxMinHeap::ReheapificationUp()
+
+
 // ==== CMaxMinHeap::DestroyHeap() ===========================================
 //
 // This function destroys
@@ -293,184 +341,230 @@ void CMaxMinHeap<HeapItemType>::Reheapification(int  index)
 // Output:
 //      void
 // ============================================================================
-template <class HeapItemType>
-void  CMaxMinHeap<HeapItemType>::DestroyHeap()
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void  CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::DestroyHeap()
 {
     m_heapType = 0;
     m_numItems = 0;
-    CList<HeapItemType>::Clear();
+    ListType::Clear();
 }
 // end of CMaxMinHeap::DestroyHeap
 
 
-// ==== CMaxMinHeap::Insert() =================================================
-//
-// This function inserts an element into CMaxMinHeap object.
+// ==== CMaxMinHeap::TryPush() ================================================
 //
+// This function inserts an element into CMaxMinHeap object without throwing.
+// A full CList object is doubled in place; no exception is used for that.
+// Only a move that throws during the sift, for items whose moves may, still
+// reaches the caller.
 //
 // Input:
 //      const HeapItemType  &newItem -- [IN]: the address of
 // constant HeapItemType element
 //
 // Output:
-//      bool -- [OUT]: if successful, it returns true. Otherwise, it returns
-// false
+//      bool -- [OUT]: true if the item was inserted, false if there was no
+// memory for it (the heap is left unchanged)
 // ============================================================================
-template <class HeapItemType>
-bool CMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
-throw (CMaxMinHeapException)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::TryPush(const HeapItemType  &newItem)
+noexcept(NOTHROW_SIFT)
 {
-    // successful insertion indicator
-    bool InsertionSuccess = false;
     try
     {
-        // try to insert an element
-        // by calling CList:Insert()
-        CList<HeapItemType>::Insert(newItem);
+        // if the list is full, resize the list first
+        if (ListType::IsFull())
+        {
+            int numItems = ListType::GetNumItems();
+            ListType::SetListSize(
+                        (numItems > 0) ? 2 * numItems : HEAP_MAX_ITEMS);
+        }
 
+        ListType::Insert(newItem);
+    }
+    catch (...)
+    {
+        // out of memory, or the item could not be copied
+        return false;
     }
 
-    // if the list is full, resize the list and insert
-    catch (const CListException &exceptionType)
+    // heapify up from the newly added item
+    ReheapificationUp(ListType::GetNumItems() - 1);
+
+    // since we added an item
+    // update the m_numItems
+    m_numItems++;
+
+    return true;
+}
+// end of CMaxMinHeap::TryPush()
+
+
+// ==== CMaxMinHeap::TryPop() =================================================
+//
+// This function removes the top element of the CMaxMinHeap object without
+// throwing.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no value
+// if the heap is empty
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+std::optional<HeapItemType> CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::TryPop(void)
+noexcept(NOTHROW_SIFT)
+{
+    std::optional<HeapItemType> item;
+
+    if (!TryPop(item))
     {
-        if(exceptionType.GetException() == CLIST_FULL)
-        {
-            // resize the CList object
-            CList<HeapItemType>::SetListSize(m_numItems);
-            // insert the new item
-            CList<HeapItemType>::Insert(newItem);
-        }
-        else // throw other unexpected cases
-        {
-            throw CMaxMinHeapException(HEAP_ERROR);
-        }
+        return std::nullopt;
     }
 
-    // Heapify Up process
+    return item;
+}
+// end of CMaxMinHeap::TryPop()
 
-    // After inserting the value at the end of CList object
-    // it is necessary to heapify up
 
-    // the newindex is the index value of the newly added item
-    int newIndex = CList<HeapItemType>::GetNumItems() - 1;
+// ==== CMaxMinHeap::TryPop() =================================================
+//
+// This function removes the top element of the CMaxMinHeap object into an
+// existing optional, so the caller can reuse it across calls.
+//
+// Input:
+//      std::optional<HeapItemType> &item -- [OUT]: receives the removed
+// element
+//
+// Output:
+//      bool -- [OUT]: true if an element was removed, false if the heap is
+// empty or the element could not be moved out
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::TryPop(std::optional<HeapItemType> &item)
+noexcept(NOTHROW_SIFT)
+{
+    if (ListType::IsEmpty())
+    {
+        return false;
+    }
 
-    // correct location indicator
-    bool correctPosition = false;
+    HeapItemType *items = ListType::GetItemArray();
+    int lastIndex = ListType::GetNumItems() - 1;
 
-    if (m_heapType == 0) // maxHeap
+    try
     {
-         // Heapify up to the head node(index == 0)
-        while((newIndex > 0) && !correctPosition)
-        {
-            // get the parent index of the newly added item
-            int parentIndex = GetParentIndex(newIndex);
-
-            // compare the priory levels
-            if (CList<HeapItemType>::GetItem(newIndex)
-            > CList<HeapItemType>::GetItem(parentIndex))
-            {
-                // if the newly added item is larger, swap elements.
-                CList<HeapItemType>::Swap(newIndex, parentIndex);
-                // update the newIndex for the next iteration
-                newIndex = parentIndex;
-
-            }
-            else // if the position is correct, leave as it is
-            {
-                correctPosition = true;
-            }
-        }
+        // hand the top element to the caller
+        item = std::move(items[0]);
+    }
+    catch (...)
+    {
+        return false;
     }
 
-    else // minHeap
+    // move the last element to the root, drop the last slot and
+    // heapify down from the root
+    if (lastIndex > 0)
     {
-         // Heapify up to the head node(index == 0)
-        while((newIndex > 0) && !correctPosition)
-        {
-            // get the parent index of the newly added item
-            int parentIndex = GetParentIndex(newIndex);
-
-            // compare the priory levels
-            if (CList<HeapItemType>::GetItem(newIndex)
-            < CList<HeapItemType>::GetItem(parentIndex))
-            {
-                // if the newly added item is smaller, swap elements.
-                CList<HeapItemType>::Swap(newIndex, parentIndex);
-                // update the newIndex for the next iteration
-                newIndex = parentIndex;
-
-            }
-            else // if the position is correct, leave as it is
-            {
-                correctPosition = true;
-            }
-        }
+        items[0] = std::move(items[lastIndex]);
     }
-    // since we added an item
+    ListType::RemoveLast();
+    Reheapification(0);
+
+    // since we removed an item
     // update the m_numItems
+    m_numItems--;
 
-    m_numItems++;
-    // successful addition
+    return true;
+}
+// end of CMaxMinHeap::TryPop()
 
-    InsertionSuccess = true;
 
-    return InsertionSuccess;
+// ==== CMaxMinHeap::TryPeek() ================================================
+//
+// This function peeks the first element of the CMaxMinHeap object without
+// copying it and without throwing.
+// Input:
+//    void
+//
+// Output:
+//      const HeapItemType* --[OUT] the first element, NULL if the heap is
+// empty. The pointer is valid until the heap is next changed.
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+const HeapItemType* CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::TryPeek(void) const noexcept
+{
+    if (ListType::IsEmpty())
+    {
+        return NULL;
+    }
 
+    return ListType::GetItemArray();
+}
+// end of CMaxMinHeap::TryPeek()
+
+
+// ==== CMaxMinHeap::Insert() =================================================
+//
+// This function inserts an element into CMaxMinHeap object. It is the
+// throwing wrapper of TryPush.
+//
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the address of
+// constant HeapItemType element
+//
+// Output:
+//      bool -- [OUT]: if successful, it returns true. Otherwise, it throws
+// CMaxMinHeapException(HEAP_FULL)
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Insert(const HeapItemType  &newItem)
+{
+    if (!TryPush(newItem))
+    {
+        throw CMaxMinHeapException(HEAP_FULL);
+    }
+
+    return true;
 }
 // end of CMaxMinHeap::Insert()
 
 // ==== CMaxMinHeap::Remove() =================================================
 //
-// This function removes an element from the CMaxMinHeap object.
+// This function removes an element from the CMaxMinHeap object. It is the
+// throwing wrapper of TryPop.
 //
 //
 // Input:
-//      HeapItemType  &Item -- [IN]: the address of
-//  HeapItemType element
+//      HeapItemType  &Item -- [OUT]: the address of
+//  HeapItemType element that receives the removed top element
 //
 // Output:
-//      bool -- [OUT]: if successful, it returns true. Otherwise, it returns
-// false
+//      bool -- [OUT]: if successful, it returns true. Otherwise, it throws
+// CMaxMinHeapException(HEAP_EMPTY)
 // ============================================================================
-template <class HeapItemType>
-bool CMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
-throw (CMaxMinHeapException)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Remove(HeapItemType &item)
 {
-    // successful deletion indicator
-    bool successfulDeletion = false;
-
     // case #1: check if the list is empty
-    if(CList<HeapItemType>::IsEmpty())
+    if (ListType::IsEmpty())
     {
         // throw CMaxMinHeapException error object
         throw CMaxMinHeapException(HEAP_EMPTY);
     }
-    try
-    {
-        // Swap the first element with the last element
-        CList<HeapItemType>::Swap(0, CList<HeapItemType>::GetNumItems() - 1);
-        // remove the last element
-        CList<HeapItemType>::Remove(item);
-        // Heapfiy down from the first element
-        Reheapification(0);
-    }
-    catch (const CListException &exceptionType)
-    {
-        // case where the target value does not exist
-        if (exceptionType.GetException() == CLIST_DNE)
-        {
-            throw CMaxMinHeapException(HEAP_ERROR);
-        }
-    }
-    catch (...)
+
+    // case #2: hand the top element to the caller
+    std::optional<HeapItemType> top;
+    if (!TryPop(top))
     {
-        // other types of exceptions
         throw CMaxMinHeapException(HEAP_ERROR);
     }
 
-    successfulDeletion = true;
+    item = std::move(*top);
 
-    return successfulDeletion;
+    return true;
 }
 // end of CMaxMinHeap::Remove()
 
@@ -478,33 +572,25 @@ throw (CMaxMinHeapException)
 
 // ==== CMaxMinHeap::PeakTop() ================================================
 //
-// This function peeks the first element of the CMaxMinHeap object.
+// This function peeks the first element of the CMaxMinHeap object. It is the
+// throwing wrapper of TryPeek.
 // Input:
 //    void
 //
 // Output:
 //      HeapItemType --[OUT] the first element of the CMaxMinHeap object
 // ============================================================================
-template <class HeapItemType>
-HeapItemType    CMaxMinHeap<HeapItemType>::PeekTop(void)
-const throw (CMaxMinHeapException)
+template <class HeapItemType, class HeapLayout, class KeyOf>
+HeapItemType    CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::PeekTop(void) const
 {
-    try
-    {
-        // return the first element
-        return (CList<HeapItemType>::GetItem(0));
-    }
-    catch (const CListException &exceptionType)
+    const HeapItemType *top = TryPeek();
+
+    if (top == NULL)
     {
-        if (exceptionType.GetException() == CLIST_EMPTY)
-        {
-            throw CMaxMinHeapException(HEAP_EMPTY);
-        }
-        else // other exceptions
-        {
-            throw CMaxMinHeapException(HEAP_ERROR);
-        }
+        throw CMaxMinHeapException(HEAP_EMPTY);
     }
+
+    return *top;
 }
 // end of CMaxMinHeap::PeekTop
 
@@ -518,9 +604,339 @@ const throw (CMaxMinHeapException)
 // Output:
 //      void
 // ============================================================================
-template <class HeapItemType>
-void CMaxMinHeap<HeapItemType>::Display(void) const
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Display(void) const
 {
-    CList<HeapItemType>::CListDisplay();
+    ListType::CListDisplay();
 }
 // end of CMaxMinHeap::Display()
+
+
+// ==== CMaxMinHeap::GetHeapType() ============================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// Input:
+//    void
+//
+// Output:
+//      int --[OUT] MAX or MIN
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of CMaxMinHeap::GetHeapType()
+
+
+// ==== CMaxMinHeap::GetNumItems() ============================================
+//
+// This function returns the number of items stored in the heap.
+// Input:
+//    void
+//
+// Output:
+//      int --[OUT] the number of items
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetNumItems(void) const
+{
+    return ListType::GetNumItems();
+}
+// end of CMaxMinHeap::GetNumItems()
+
+
+// ==== CMaxMinHeap::IsEmpty() ================================================
+//
+// This function returns a boolean value if the heap is empty.
+// Input:
+//    void
+//
+// Output:
+//      bool --[OUT] true if the heap is empty, false otherwise
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+bool CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::IsEmpty(void) const
+{
+    return ListType::IsEmpty();
+}
+// end of CMaxMinHeap::IsEmpty()
+
+
+// ==== CMaxMinHeap::GetItemArray() ===========================================
+//
+// This function returns the items in heap order (the root first), as they
+// are laid out in the underlying CList object.
+// Input:
+//    void
+//
+// Output:
+//      const HeapItemType* --[OUT] a pointer to GetNumItems() items
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+const HeapItemType* CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::GetItemArray(void) const
+{
+    return ListType::GetItemArray();
+}
+// end of CMaxMinHeap::GetItemArray()
+
+
+
+// ==== CMaxMinHeap::Reserve() ================================================
+//
+// This function makes room for at least numItems items, so that a bulk load
+// does not resize the CList object along the way.
+// Input:
+//    int numItems -- [IN]: the number of items to make room for
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Reserve(int numItems)
+{
+    if (numItems > ListType::GetListSize())
+    {
+        ListType::SetListSize(numItems);
+    }
+}
+// end of CMaxMinHeap::Reserve()
+
+
+// ==== CMaxMinHeap::AppendUnordered() ========================================
+//
+// This function adds a default constructed item at the end of the heap and
+// returns it to be filled in place. The heap order is NOT restored: after
+// the last AppendUnordered, the caller must call Heapify once before using
+// any other member function.
+// Input:
+//    void
+//
+// Output:
+//      HeapItemType& --[OUT] the new item
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+HeapItemType& CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::AppendUnordered(void)
+{
+    if (ListType::IsFull())
+    {
+        ListType::SetListSize(2 * ListType::GetNumItems());
+    }
+
+    // count the slot only once it exists
+    HeapItemType &newItem = ListType::AppendItem();
+    m_numItems++;
+
+    return newItem;
+}
+// end of CMaxMinHeap::AppendUnordered()
+
+
+// ==== CMaxMinHeap::Heapify() ================================================
+//
+// This function restores the heap order of the whole CList object in O(n),
+// sifting down every internal node from the last one up to the root.
+// Input:
+//    void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Heapify(void)
+{
+    HeapItemType *items = ListType::GetItemArray();
+    int numItems = ListType::GetNumItems();
+
+    if (m_heapType == MAX)
+    {
+        HeapBuild(items, numItems, MaxOrder(), HeapLayout());
+    }
+    else
+    {
+        HeapBuild(items, numItems, MinOrder(), HeapLayout());
+    }
+}
+// end of CMaxMinHeap::Heapify()
+
+
+// ==== CMaxMinHeap::SortItems() ==============================================
+//
+// This function sorts the items in place into priority order, so that
+// GetItemArray then lists them best first. In the implicit layout every
+// parent comes before its children in the array, so the sorted array still
+// is a heap and nothing has to be rebuilt; the other layouts do not keep
+// that property and cannot be sorted this way.
+// Input:
+//    void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::SortItems(void)
+{
+    static_assert(std::is_same<HeapLayout, CImplicitHeapLayout>::value,
+                  "only the implicit layout stays a heap when sorted");
+
+    HeapItemType *items = ListType::GetItemArray();
+    int numItems = ListType::GetNumItems();
+
+    if (m_heapType == MAX)
+    {
+        std::sort(items, items + numItems, MaxOrder());
+    }
+    else
+    {
+        std::sort(items, items + numItems, MinOrder());
+    }
+}
+// end of CMaxMinHeap::SortItems()
+
+
+
+// ==== CMaxMinHeap::RemoveIf() ===============================================
+//
+// This function removes every item for which the predicate returns true.
+// The CList object is compacted in one stable pass and the heap order is
+// restored with a single Heapify, so the whole call is O(n) no matter how
+// many items are removed. If the predicate throws, the items removed so far
+// stay removed, the rest are kept and the heap is rebuilt before the
+// exception is passed on.
+// Input:
+//    Predicate removeItem -- [IN]: a function object taking a
+// const HeapItemType& and returning true for the items to remove
+//
+// Output:
+//      int --[OUT] the number of items removed
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+template <class Predicate>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::RemoveIf(Predicate removeItem)
+{
+    int numRemoved;
+
+    try
+    {
+        numRemoved = ListType::RemoveIf(removeItem);
+    }
+    catch (...)
+    {
+        m_numItems = ListType::GetNumItems();
+        Heapify();
+        throw;
+    }
+
+    if (numRemoved > 0)
+    {
+        m_numItems -= numRemoved;
+        Heapify();
+    }
+
+    return numRemoved;
+}
+// end of CMaxMinHeap::RemoveIf()
+
+
+// ==== CMaxMinHeap::Retain() =================================================
+//
+// This function keeps only the items for which the predicate returns true,
+// with the same single pass and single Heapify as RemoveIf.
+// Input:
+//    Predicate keepItem -- [IN]: a function object taking a
+// const HeapItemType& and returning true for the items to keep
+//
+// Output:
+//      int --[OUT] the number of items removed
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+template <class Predicate>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::Retain(Predicate keepItem)
+{
+    return RemoveIf([&keepItem](const HeapItemType &item)
+                    {
+                        return !keepItem(item);
+                    });
+}
+// end of CMaxMinHeap::Retain()
+
+
+// ==== CMaxMinHeap::PopN() ===================================================
+//
+// This function removes the first count items and writes them to output in
+// priority order. Large batches are selected and the rest rebuilt in
+// O(n + count log count); small ones are popped bottom-up with about half
+// the comparisons of count Remove calls (see HeapPopN). The items are popped
+// into a local buffer, reserved before the heap is touched, and moved to
+// output once the heap is consistent again: an output iterator that throws
+// then loses the items it did not take, but cannot leave moved-from items
+// in the heap.
+// Input:
+//    int count -- [IN]: the number of items to remove at most
+//    OutputIt output -- [IN]: output iterator receiving the moved items
+//
+// Output:
+//      int --[OUT] the number of items removed, less than count if the heap
+// runs out
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+template <class OutputIt>
+int CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::PopN(int count, OutputIt output)
+{
+    HeapItemType *items = ListType::GetItemArray();
+    int numItems = ListType::GetNumItems();
+    int numPopped;
+    std::vector<HeapItemType> popped;
+
+    popped.reserve((count < 0) ? 0 : (count < numItems) ? count : numItems);
+    if (m_heapType == MAX)
+    {
+        numPopped = HeapPopN(items, numItems, count, std::back_inserter(popped),
+                             MaxOrder(), HeapLayout());
+    }
+    else
+    {
+        numPopped = HeapPopN(items, numItems, count, std::back_inserter(popped),
+                             MinOrder(), HeapLayout());
+    }
+
+    // the moved-from slots are at the end of the CList object
+    for (int index = 0; index < numPopped; ++index)
+    {
+        ListType::RemoveLast();
+    }
+    m_numItems -= numPopped;
+
+    for (HeapItemType &item : popped)
+    {
+        *output++ = std::move(item);
+    }
+
+    return numPopped;
+}
+// end of CMaxMinHeap::PopN()
+
+
+// ==== CMaxMinHeap::TopView() ================================================
+//
+// This function returns a view that yields the first count items in priority
+// order without changing the heap, in O(count log count). The view is valid
+// until the heap is next changed.
+// Input:
+//    int count -- [IN]: the number of items to yield at most
+//
+// Output:
+//      CHeapTopView<HeapItemType, HeapLayout, KeyOf> --[OUT] the view
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+CHeapTopView<HeapItemType, HeapLayout, KeyOf>
+CMaxMinHeap<HeapItemType, HeapLayout, KeyOf>::TopView(int count) const
+{
+    return CHeapTopView<HeapItemType, HeapLayout, KeyOf>(
+                    ListType::GetItemArray(),
+                    ListType::GetNumItems(),
+                    (m_heapType == MAX), count);
+}
+// end of CMaxMinHeap::TopView()
+
+#endif // CMAXMINHEAP_H
@@ -0,0 +1,470 @@
+// ============================================================================
+// File: cnamearena.h
+// ============================================================================
+// Header file for the CNameArena class, an intern pool for the names of
+// InternedPersonInfo records.
+//
+// Each distinct name is stored once, back to back in one character buffer,
+// and is referred to by a 32-bit id. The top 6 bits of an id select the
+// arena (every live arena owns one of NAME_ARENA_MAX_ARENAS slots), the next
+// 5 bits hold the generation of that slot and the low 21 bits select the
+// name, so a record needs nothing but the id to find its name again, and one
+// arena per heap is enough.
+//
+// A slot is reused once its arena is destroyed, but with the next generation,
+// and free slots are taken round robin. A stale id therefore finds no arena,
+// until its slot has been claimed 32 more times; even then GetName and
+// GetNameLength check the index against that arena, so it reads an empty or
+// wrong name but never out of bounds.
+//
+// The registry is guarded by a lock, and CopyName looks up the arena and
+// copies the name under it, so a name can be printed from one thread while
+// another destroys arenas. An arena itself is not synchronized: it must not
+// intern names while another thread reads them.
+// ============================================================================
+#ifndef CNAMEARENA_H
+#define CNAMEARENA_H
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <mutex>
+#include    <string>
+#include    <vector>
+
+// constants
+const   int         NAME_ARENA_MAX_ARENAS = 64;
+const   int         NAME_ID_INDEX_BITS = 21;
+const   int         NAME_ID_GENERATION_BITS = 5;
+const   uint32_t    NAME_ID_INDEX_MASK = (1u << NAME_ID_INDEX_BITS) - 1;
+const   uint32_t    NAME_ID_GENERATION_MASK = (1u << NAME_ID_GENERATION_BITS) - 1;
+const   uint32_t    NAME_ID_NONE = 0xFFFFFFFFu; // a record without a name
+
+// enumerate list for CNameArenaException class
+enum    CNameArenaExceptionType  { NAME_ARENA_NO_SLOT,
+                                   NAME_ARENA_FULL
+                                 };
+
+
+// exception class for CNameArena
+class CNameArenaException
+{
+public:
+    // constructor
+    CNameArenaException(CNameArenaExceptionType   exceptType)
+            : m_exceptType(exceptType) {}
+
+    // member function
+    CNameArenaExceptionType GetException() const {return m_exceptType;}
+
+private:
+    CNameArenaExceptionType  m_exceptType;
+};
+
+
+class   CNameArena;
+
+// the arena that owns a registry slot, and how often the slot was claimed
+struct  CNameArenaSlot
+{
+    CNameArena  *m_arena;       // NULL while the slot is free
+    uint32_t    m_generation;   // bumped each time the slot is claimed
+};
+
+// the table of live arenas
+struct  CNameArenaRegistry
+{
+    CNameArenaSlot  m_slots[NAME_ARENA_MAX_ARENAS];
+    int             m_nextSlot; // where the search for a free slot starts
+    std::mutex      m_lock;     // guards the whole registry
+};
+
+
+// class declaration
+class   CNameArena
+{
+public:
+    // constructor and destructor
+    CNameArena();
+    ~CNameArena();
+
+    // member functions
+    uint32_t        Intern(const char *name, size_t length);
+    uint32_t        Intern(const std::string &name);
+    const char*     GetName(uint32_t nameId) const;
+    size_t          GetNameLength(uint32_t nameId) const;
+    int             GetNumNames(void) const;
+
+    // utility functions
+    static const CNameArena*    FindArena(uint32_t nameId);
+    static bool                 CopyName(uint32_t nameId, std::string &name);
+
+private:
+    // names are referred to by arena slot, so an arena cannot be copied
+    CNameArena(const CNameArena &otherObj);
+    CNameArena& operator=(const CNameArena &rhs);
+
+    // data members
+    int                     m_slot;     // registry slot
+    uint32_t                m_idBase;   // slot and generation bits of ids
+    std::vector<char>       m_chars;    // all names, back to back
+    std::vector<uint32_t>   m_offsets;  // start of each name, plus the end
+    std::vector<uint32_t>   m_table;    // hash table of name index + 1
+
+    // utility functions
+    static uint32_t             HashName(const char *name, size_t length);
+    static CNameArenaRegistry&  GetRegistry(void);
+    static const CNameArena*    FindArenaLocked(uint32_t nameId);
+    void                        GrowTable(void);
+};
+
+
+// ==== CNameArena::GetRegistry ===============================================
+//
+// This function returns the table of live arenas, indexed by slot.
+//
+// Input:
+//      void
+//
+// Output:
+//      CNameArenaRegistry& -- [OUT]: the registry
+// ============================================================================
+inline CNameArenaRegistry& CNameArena::GetRegistry(void)
+{
+    static CNameArenaRegistry registry = {};
+
+    return registry;
+}
+// end of CNameArena::GetRegistry()
+
+
+// ==== CNameArena::CNameArena ================================================
+//
+// This is the default constructor. It claims the next free registry slot and
+// moves the slot to its next generation, so ids of the slot's earlier arenas
+// no longer find it.
+//
+// ============================================================================
+inline CNameArena::CNameArena()
+: m_slot(-1), m_idBase(0), m_offsets(1, 0), m_table(16, 0)
+{
+    CNameArenaRegistry &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.m_lock);
+
+    for (int count = 0; count < NAME_ARENA_MAX_ARENAS; ++count)
+    {
+        int slot = (registry.m_nextSlot + count) % NAME_ARENA_MAX_ARENAS;
+        CNameArenaSlot &entry = registry.m_slots[slot];
+
+        if (entry.m_arena == NULL)
+        {
+            entry.m_arena = this;
+            entry.m_generation = (entry.m_generation + 1) & NAME_ID_GENERATION_MASK;
+            registry.m_nextSlot = (slot + 1) % NAME_ARENA_MAX_ARENAS;
+
+            m_slot = slot;
+            m_idBase = (((static_cast<uint32_t>(slot) << NAME_ID_GENERATION_BITS)
+                         | entry.m_generation) << NAME_ID_INDEX_BITS);
+            return;
+        }
+    }
+
+    throw CNameArenaException(NAME_ARENA_NO_SLOT);
+}
+// end of CNameArena::CNameArena()
+
+
+// ==== CNameArena::~CNameArena ===============================================
+//
+// This is the destructor. It releases the registry slot; ids handed out by
+// this arena find no arena afterwards. A CopyName running on another thread
+// finishes before the arena goes away.
+//
+// ============================================================================
+inline CNameArena::~CNameArena()
+{
+    CNameArenaRegistry &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.m_lock);
+
+    registry.m_slots[m_slot].m_arena = NULL;
+}
+// end of CNameArena::~CNameArena()
+
+
+// ==== CNameArena::HashName ==================================================
+//
+// This function returns the FNV-1a hash of a name.
+//
+// Input:
+//      name    -- [IN]: the characters of the name
+//      length  -- [IN]: the number of characters
+//
+// Output:
+//      uint32_t -- [OUT]: the hash value
+// ============================================================================
+inline uint32_t CNameArena::HashName(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t index = 0; index < length; ++index)
+    {
+        hash ^= static_cast<unsigned char>(name[index]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+// end of CNameArena::HashName()
+
+
+// ==== CNameArena::GrowTable =================================================
+//
+// This function doubles the hash table and re-inserts every name index.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+inline void CNameArena::GrowTable(void)
+{
+    std::vector<uint32_t> newTable(m_table.size() * 2, 0);
+    size_t mask = newTable.size() - 1;
+
+    for (size_t index = 0; index + 1 < m_offsets.size(); ++index)
+    {
+        size_t position = HashName(m_chars.data() + m_offsets[index],
+                                   m_offsets[index + 1] - m_offsets[index]) & mask;
+        while (newTable[position] != 0)
+        {
+            position = (position + 1) & mask;
+        }
+        newTable[position] = static_cast<uint32_t>(index + 1);
+    }
+
+    m_table.swap(newTable);
+}
+// end of CNameArena::GrowTable()
+
+
+// ==== CNameArena::Intern ====================================================
+//
+// This function returns the id of a name, adding the name to the arena the
+// first time it is seen.
+//
+// Input:
+//      name    -- [IN]: the characters of the name
+//      length  -- [IN]: the number of characters
+//
+// Output:
+//      uint32_t -- [OUT]: the id of the name
+// ============================================================================
+inline uint32_t CNameArena::Intern(const char *name, size_t length)
+{
+    size_t mask = m_table.size() - 1;
+    size_t position = HashName(name, length) & mask;
+
+    // case #1: the name is already in the arena
+    while (m_table[position] != 0)
+    {
+        uint32_t index = m_table[position] - 1;
+        size_t storedLength = m_offsets[index + 1] - m_offsets[index];
+
+        if ((storedLength == length)
+            && (std::char_traits<char>::compare(m_chars.data() + m_offsets[index],
+                                                name, length) == 0))
+        {
+            return (m_idBase | index);
+        }
+        position = (position + 1) & mask;
+    }
+
+    // case #2: a new name
+    uint32_t index = static_cast<uint32_t>(m_offsets.size()) - 1;
+    if (index > NAME_ID_INDEX_MASK - 1)
+    {
+        throw CNameArenaException(NAME_ARENA_FULL);
+    }
+
+    m_chars.insert(m_chars.end(), name, name + length);
+    m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+    m_table[position] = index + 1;
+
+    // keep the table at most half full
+    if (2 * m_offsets.size() > m_table.size())
+    {
+        GrowTable();
+    }
+
+    return (m_idBase | index);
+}
+// end of CNameArena::Intern()
+
+
+// ==== CNameArena::Intern ====================================================
+//
+// This function returns the id of a name held in a std::string.
+//
+// Input:
+//      name    -- [IN]: the name
+//
+// Output:
+//      uint32_t -- [OUT]: the id of the name
+// ============================================================================
+inline uint32_t CNameArena::Intern(const std::string &name)
+{
+    return Intern(name.data(), name.size());
+}
+// end of CNameArena::Intern()
+
+
+// ==== CNameArena::GetName ===================================================
+//
+// This function returns the characters of a name (not NUL terminated).
+//
+// Input:
+//      nameId  -- [IN]: an id returned by Intern on this arena
+//
+// Output:
+//      const char* -- [OUT]: the first character of the name, an empty
+//                     string if the id has no name in this arena
+// ============================================================================
+inline const char* CNameArena::GetName(uint32_t nameId) const
+{
+    uint32_t index = nameId & NAME_ID_INDEX_MASK;
+
+    if (index >= static_cast<uint32_t>(GetNumNames()))
+    {
+        return "";
+    }
+
+    return (m_chars.empty() ? "" : &m_chars[0]) + m_offsets[index];
+}
+// end of CNameArena::GetName()
+
+
+// ==== CNameArena::GetNameLength =============================================
+//
+// This function returns the number of characters of a name.
+//
+// Input:
+//      nameId  -- [IN]: an id returned by Intern on this arena
+//
+// Output:
+//      size_t  -- [OUT]: the length of the name, 0 if the id has no name in
+//                 this arena
+// ============================================================================
+inline size_t CNameArena::GetNameLength(uint32_t nameId) const
+{
+    uint32_t index = nameId & NAME_ID_INDEX_MASK;
+
+    if (index >= static_cast<uint32_t>(GetNumNames()))
+    {
+        return 0;
+    }
+
+    return (m_offsets[index + 1] - m_offsets[index]);
+}
+// end of CNameArena::GetNameLength()
+
+
+// ==== CNameArena::GetNumNames ===============================================
+//
+// This function returns the number of distinct names in the arena.
+//
+// Input:
+//      void
+//
+// Output:
+//      int     -- [OUT]: the number of names
+// ============================================================================
+inline int CNameArena::GetNumNames(void) const
+{
+    return static_cast<int>(m_offsets.size()) - 1;
+}
+// end of CNameArena::GetNumNames()
+
+
+// ==== CNameArena::FindArenaLocked ===========================================
+//
+// This function returns the arena that handed out a name id. The caller
+// holds the registry lock.
+//
+// Input:
+//      nameId  -- [IN]: a name id
+//
+// Output:
+//      const CNameArena* -- [OUT]: the arena, NULL if it no longer exists
+// ============================================================================
+inline const CNameArena* CNameArena::FindArenaLocked(uint32_t nameId)
+{
+    if (nameId == NAME_ID_NONE)
+    {
+        return NULL;
+    }
+
+    uint32_t generation = (nameId >> NAME_ID_INDEX_BITS) & NAME_ID_GENERATION_MASK;
+    const CNameArenaSlot &entry
+        = GetRegistry().m_slots[nameId >> (NAME_ID_INDEX_BITS
+                                           + NAME_ID_GENERATION_BITS)];
+
+    if (entry.m_generation != generation)
+    {
+        return NULL;
+    }
+
+    return entry.m_arena;
+}
+// end of CNameArena::FindArenaLocked()
+
+
+// ==== CNameArena::FindArena =================================================
+//
+// This function returns the arena that handed out a name id. The pointer is
+// only safe to use while the caller knows the arena is alive; to read a name
+// that another thread may be destroying, use CopyName.
+//
+// Input:
+//      nameId  -- [IN]: a name id
+//
+// Output:
+//      const CNameArena* -- [OUT]: the arena, NULL if it no longer exists
+// ============================================================================
+inline const CNameArena* CNameArena::FindArena(uint32_t nameId)
+{
+    std::lock_guard<std::mutex> guard(GetRegistry().m_lock);
+
+    return FindArenaLocked(nameId);
+}
+// end of CNameArena::FindArena()
+
+
+// ==== CNameArena::CopyName ==================================================
+//
+// This function copies the name of an id out of the arena that handed it
+// out, under the registry lock, so the arena cannot be destroyed meanwhile.
+//
+// Input:
+//      nameId  -- [IN]: a name id
+//      name    -- [OUT]: receives the name, empty if there is none
+//
+// Output:
+//      bool    -- [OUT]: false if the id's arena no longer exists
+// ============================================================================
+inline bool CNameArena::CopyName(uint32_t nameId, std::string &name)
+{
+    std::lock_guard<std::mutex> guard(GetRegistry().m_lock);
+    const CNameArena *arena = FindArenaLocked(nameId);
+
+    if (arena == NULL)
+    {
+        name.clear();
+        return false;
+    }
+
+    name.assign(arena->GetName(nameId), arena->GetNameLength(nameId));
+    return true;
+}
+// end of CNameArena::CopyName()
+
+#endif // CNAMEARENA_H
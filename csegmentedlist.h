@@ -0,0 +1,361 @@
+// ============================================================================
+// File: csegmentedlist.h
+// ============================================================================
+// Header file for the CSegmentedList class, an array of items kept in fixed
+// size chunks.
+//
+// Item i lives in chunk (i >> ChunkShift) at offset (i & (ChunkItems - 1)).
+// Growing the list allocates one new chunk and never moves an existing
+// item, so growth costs one chunk allocation instead of the copy of every
+// item CList::SetListSize makes, and a pointer to a slot stays valid for as
+// long as the slot is in use. Only the chunk directory (one pointer per
+// chunk) is ever reallocated.
+//
+// The directory doubles when it is full, so an append is amortized O(1): a
+// directory copy moves one pointer per chunk, 1/1024 of the items with the
+// default chunk size. It is not preallocated, because the int index range
+// needs 2^(31 - ChunkShift) pointers (16 MB with the default chunks). A
+// caller that knows its maximum size calls ReserveDirectory once, and after
+// that every append is worst-case O(1): at most one chunk allocation.
+// ============================================================================
+#ifndef CSEGMENTEDLIST_H
+#define CSEGMENTEDLIST_H
+
+#include    <cstddef>
+#include    <utility>
+#include    <vector>
+
+// constants
+const   int SEGMENTED_CHUNK_SHIFT = 10; // 1024 items per chunk by default
+
+
+// class declaration
+template <class ListItemType, int ChunkShift = SEGMENTED_CHUNK_SHIFT>
+class   CSegmentedList
+{
+    static_assert(ChunkShift >= 0 && ChunkShift < 24,
+                  "CSegmentedList chunks hold 1 to 2^23 items");
+
+public:
+    static const int    CHUNK_ITEMS = 1 << ChunkShift;
+
+    // constructors and destructor
+    CSegmentedList();
+    CSegmentedList(const CSegmentedList &otherObj);
+    virtual ~CSegmentedList();
+
+    // member functions
+    ListItemType&       AppendItem(void);
+    void                RemoveLast(void);
+    void                Reserve(int numItems);
+    void                ReserveDirectory(int maxItems);
+    void                Clear(void);
+
+    // Helper functions
+    int                 GetNumItems(void) const;
+    int                 GetCapacity(void) const;
+    bool                IsEmpty(void) const;
+
+    // overloaded operator(s)
+    CSegmentedList&     operator=(const CSegmentedList &rhs);
+    ListItemType&       operator[](int index);
+    const ListItemType& operator[](int index) const;
+
+private:
+    // data members
+    std::vector<ListItemType*>  m_chunks;   // chunk directory
+    int                         m_numItems; // number of items in use
+
+    // utility functions
+    void                AddChunk(void);
+    void                ReleaseChunks(int numChunks);
+};
+
+
+// ==== CSegmentedList::CSegmentedList ========================================
+//
+// This is the default constructor. It does not allocate.
+//
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+CSegmentedList<ListItemType, ChunkShift>::CSegmentedList()
+: m_numItems(0)
+{
+}
+// end of CSegmentedList::CSegmentedList()
+
+
+// ==== CSegmentedList::CSegmentedList (Copy) =================================
+//
+// This is the copy constructor.
+//
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+CSegmentedList<ListItemType, ChunkShift>::CSegmentedList(const CSegmentedList &otherObj)
+: m_numItems(0)
+{
+    *this = otherObj;
+}
+// end of CSegmentedList::CSegmentedList() (copy constructor)
+
+
+// ==== CSegmentedList::~CSegmentedList =======================================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+CSegmentedList<ListItemType, ChunkShift>::~CSegmentedList()
+{
+    ReleaseChunks(0);
+}
+// end of CSegmentedList::~CSegmentedList()
+
+
+// ==== CSegmentedList::operator= =============================================
+//
+// This is the overloaded assignment operator.
+//
+// Input:
+//      rhs     -- [IN]: the list to copy
+//
+// Output:
+//      A reference to the calling object.
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+CSegmentedList<ListItemType, ChunkShift>&
+CSegmentedList<ListItemType, ChunkShift>::operator=(const CSegmentedList &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    m_numItems = 0;
+    Reserve(rhs.m_numItems);
+
+    for (int index = 0; index < rhs.m_numItems; ++index)
+    {
+        (*this)[index] = rhs[index];
+    }
+    m_numItems = rhs.m_numItems;
+
+    return *this;
+}
+// end of CSegmentedList::operator=()
+
+
+// ==== CSegmentedList::operator[] ============================================
+//
+// This is the overloaded subscript operator. It does not check the index.
+//
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+ListItemType& CSegmentedList<ListItemType, ChunkShift>::operator[](int index)
+{
+    return m_chunks[index >> ChunkShift][index & (CHUNK_ITEMS - 1)];
+}
+
+template <class ListItemType, int ChunkShift>
+const ListItemType& CSegmentedList<ListItemType, ChunkShift>::operator[](int index)
+const
+{
+    return m_chunks[index >> ChunkShift][index & (CHUNK_ITEMS - 1)];
+}
+// end of CSegmentedList::operator[]()
+
+
+// ==== CSegmentedList::AddChunk ==============================================
+//
+// This function allocates one more chunk. Existing items are not touched.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::AddChunk(void)
+{
+    // make room in the directory first, so push_back cannot throw and leak
+    // the new chunk; the directory doubles, and holds only pointers
+    if (m_chunks.size() == m_chunks.capacity())
+    {
+        m_chunks.reserve(m_chunks.empty() ? 16 : 2 * m_chunks.size());
+    }
+    m_chunks.push_back(new ListItemType[CHUNK_ITEMS]);
+}
+// end of CSegmentedList::AddChunk()
+
+
+// ==== CSegmentedList::ReleaseChunks =========================================
+//
+// This function frees the chunks past the first numChunks.
+//
+// Input:
+//      numChunks   -- [IN]: the number of chunks to keep
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::ReleaseChunks(int numChunks)
+{
+    while (static_cast<int>(m_chunks.size()) > numChunks)
+    {
+        delete [] m_chunks.back();
+        m_chunks.pop_back();
+    }
+}
+// end of CSegmentedList::ReleaseChunks()
+
+
+// ==== CSegmentedList::AppendItem ============================================
+//
+// This function adds a slot at the end of the list and returns it to be
+// filled in place. It allocates a chunk when the last one is full.
+//
+// Input:
+//      void
+//
+// Output:
+//      ListItemType& -- [OUT]: the new slot
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+ListItemType& CSegmentedList<ListItemType, ChunkShift>::AppendItem(void)
+{
+    if (m_numItems == GetCapacity())
+    {
+        AddChunk();
+    }
+
+    return (*this)[m_numItems++];
+}
+// end of CSegmentedList::AppendItem()
+
+
+// ==== CSegmentedList::RemoveLast ============================================
+//
+// This function drops the last slot. A chunk is freed only once the chunk
+// after it is empty as well, so a list that hovers around a chunk boundary
+// does not allocate and free the same chunk over and over.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::RemoveLast(void)
+{
+    if (m_numItems == 0)
+    {
+        return;
+    }
+
+    --m_numItems;
+
+    int chunksInUse = (m_numItems + CHUNK_ITEMS - 1) >> ChunkShift;
+    if (static_cast<int>(m_chunks.size()) > chunksInUse + 1)
+    {
+        ReleaseChunks(chunksInUse + 1);
+    }
+}
+// end of CSegmentedList::RemoveLast()
+
+
+// ==== CSegmentedList::Reserve ===============================================
+//
+// This function allocates chunks for at least numItems items.
+//
+// Input:
+//      numItems    -- [IN]: the number of items to make room for
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::Reserve(int numItems)
+{
+    while (GetCapacity() < numItems)
+    {
+        AddChunk();
+    }
+}
+// end of CSegmentedList::Reserve()
+
+
+// ==== CSegmentedList::ReserveDirectory ======================================
+//
+// This function sizes the chunk directory for maxItems items without
+// allocating any chunk. Until the list grows past maxItems, AppendItem never
+// reallocates the directory.
+//
+// Input:
+//      maxItems    -- [IN]: the largest number of items the list will hold
+//
+// Output:
+//      void
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::ReserveDirectory(int maxItems)
+{
+    if (maxItems > 0)
+    {
+        m_chunks.reserve(((static_cast<std::size_t>(maxItems) - 1) >> ChunkShift) + 1);
+    }
+}
+// end of CSegmentedList::ReserveDirectory()
+
+
+// ==== CSegmentedList::Clear =================================================
+//
+// This function removes every item and frees every chunk.
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+void CSegmentedList<ListItemType, ChunkShift>::Clear(void)
+{
+    m_numItems = 0;
+    ReleaseChunks(0);
+}
+// end of CSegmentedList::Clear()
+
+
+// ==== CSegmentedList::GetNumItems ===========================================
+//
+// This function returns the number of items.
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+int CSegmentedList<ListItemType, ChunkShift>::GetNumItems(void) const
+{
+    return m_numItems;
+}
+// end of CSegmentedList::GetNumItems()
+
+
+// ==== CSegmentedList::GetCapacity ===========================================
+//
+// This function returns the number of items the allocated chunks can hold.
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+int CSegmentedList<ListItemType, ChunkShift>::GetCapacity(void) const
+{
+    return static_cast<int>(m_chunks.size()) << ChunkShift;
+}
+// end of CSegmentedList::GetCapacity()
+
+
+// ==== CSegmentedList::IsEmpty ===============================================
+//
+// This function returns a boolean value if the list is empty.
+// ============================================================================
+template <class ListItemType, int ChunkShift>
+bool CSegmentedList<ListItemType, ChunkShift>::IsEmpty(void) const
+{
+    return (m_numItems == 0);
+}
+// end of CSegmentedList::IsEmpty()
+
+#endif // CSEGMENTEDLIST_H
@@ -0,0 +1,431 @@
+// ============================================================================
+// File: csegmentedmaxminheap.h
+// ============================================================================
+// Header file for the CSegmentedMaxMinHeap class, a heap stored in a
+// CSegmentedList instead of a CList.
+//
+// The heap never copies its items to grow: crossing a capacity boundary costs
+// one chunk allocation. The chunk directory still doubles now and then (one
+// pointer per chunk); call ReserveDirectory with the largest expected size
+// to make every Insert worst-case O(log n) with no copy at all.
+// The sift routines are the shared heapsift kernels, reaching the chunks
+// through a small accessor object. Items still move between slots as the
+// heap reorders them; it is the slots that never move.
+// ============================================================================
+#ifndef CSEGMENTEDMAXMINHEAP_H
+#define CSEGMENTEDMAXMINHEAP_H
+
+#include    <optional>
+#include    <type_traits>
+#include    <utility>
+#include    "cmaxminheap.h"
+#include    "csegmentedlist.h"
+#include    "heapsift.h"
+
+
+// class declaration
+template <class HeapItemType, int ChunkShift = SEGMENTED_CHUNK_SHIFT>
+class   CSegmentedMaxMinHeap
+{
+public:
+    // constructor and destructor
+    CSegmentedMaxMinHeap(int heapType = MAX);
+    virtual ~CSegmentedMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+    void            Reserve(int numItems);
+    void            ReserveDirectory(int maxItems);
+
+    // exception-free versions of Insert, Remove and PeekTop
+    bool                        TryPush(const HeapItemType  &newItem)
+                                                    noexcept(NOTHROW_SIFT);
+    std::optional<HeapItemType> TryPop(void) noexcept(NOTHROW_SIFT);
+    const HeapItemType*         TryPeek(void) const noexcept;
+
+    // Helper functions
+    int             GetCapacity(void) const;
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    typedef CSegmentedList<HeapItemType, ChunkShift>    ListType;
+
+    // the sifts only move items (see CMaxMinHeap::NOTHROW_SIFT)
+    static constexpr bool NOTHROW_SIFT
+        = std::is_nothrow_move_constructible<HeapItemType>::value
+          && std::is_nothrow_move_assignable<HeapItemType>::value;
+
+    // item array accessor handed to the heapsift kernels
+    struct  CItemAccessor
+    {
+        ListType    *m_list;
+
+        HeapItemType& operator[](int index) const { return (*m_list)[index]; }
+    };
+
+    // data members
+    int         m_heapType; // MAX or MIN
+    ListType    m_list;     // the items, in heap order
+
+    // utility functions
+    void        SiftUp(int index) noexcept(NOTHROW_SIFT);
+    void        SiftDown(int index) noexcept(NOTHROW_SIFT);
+};
+
+
+// ==== CSegmentedMaxMinHeap::CSegmentedMaxMinHeap ============================
+//
+// This is the constructor.
+//
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::CSegmentedMaxMinHeap(int heapType)
+: m_heapType(heapType)
+{
+}
+// end of CSegmentedMaxMinHeap::CSegmentedMaxMinHeap()
+
+
+// ==== CSegmentedMaxMinHeap::~CSegmentedMaxMinHeap ===========================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::~CSegmentedMaxMinHeap()
+{
+}
+// end of CSegmentedMaxMinHeap::~CSegmentedMaxMinHeap()
+
+
+// ==== CSegmentedMaxMinHeap::SiftUp ==========================================
+//
+// This function heapifies up from a node.
+//
+// Input:
+//      index   -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+void CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::SiftUp(int index)
+noexcept(NOTHROW_SIFT)
+{
+    CItemAccessor items = { &m_list };
+
+    if (m_heapType == MAX)
+    {
+        HeapSiftUp(items, index, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftUp(items, index, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CSegmentedMaxMinHeap::SiftUp()
+
+
+// ==== CSegmentedMaxMinHeap::SiftDown ========================================
+//
+// This function heapifies down from a node.
+//
+// Input:
+//      index   -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+void CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::SiftDown(int index)
+noexcept(NOTHROW_SIFT)
+{
+    CItemAccessor items = { &m_list };
+    int numItems = m_list.GetNumItems();
+
+    if (m_heapType == MAX)
+    {
+        HeapSiftDown(items, numItems, index, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftDown(items, numItems, index, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CSegmentedMaxMinHeap::SiftDown()
+
+
+// ==== CSegmentedMaxMinHeap::TryPush =========================================
+//
+// This function inserts an element without throwing.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if there was no memory for the item
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+bool CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::TryPush(const HeapItemType  &newItem)
+noexcept(NOTHROW_SIFT)
+{
+    try
+    {
+        HeapItemType &slot = m_list.AppendItem();
+
+        try
+        {
+            slot = newItem;
+        }
+        catch (...)
+        {
+            m_list.RemoveLast();
+            throw;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    SiftUp(m_list.GetNumItems() - 1);
+
+    return true;
+}
+// end of CSegmentedMaxMinHeap::TryPush()
+
+
+// ==== CSegmentedMaxMinHeap::TryPop ==========================================
+//
+// This function removes the top element without throwing.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no
+//                                     value if the heap is empty
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+std::optional<HeapItemType> CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::TryPop(void)
+noexcept(NOTHROW_SIFT)
+{
+    if (m_list.IsEmpty())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<HeapItemType> item;
+    try
+    {
+        item = std::move(m_list[0]);
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+
+    int lastIndex = m_list.GetNumItems() - 1;
+    if (lastIndex > 0)
+    {
+        m_list[0] = std::move(m_list[lastIndex]);
+    }
+    m_list.RemoveLast();
+
+    if (!m_list.IsEmpty())
+    {
+        SiftDown(0);
+    }
+
+    return item;
+}
+// end of CSegmentedMaxMinHeap::TryPop()
+
+
+// ==== CSegmentedMaxMinHeap::TryPeek =========================================
+//
+// This function peeks the top element without copying it.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the top element, NULL if empty
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+const HeapItemType* CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::TryPeek(void) const
+noexcept
+{
+    return m_list.IsEmpty() ? NULL : &m_list[0];
+}
+// end of CSegmentedMaxMinHeap::TryPeek()
+
+
+// ==== CSegmentedMaxMinHeap::Insert ==========================================
+//
+// This function inserts an element.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_FULL) is thrown
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+bool CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::Insert(const HeapItemType  &newItem)
+{
+    if (!TryPush(newItem))
+    {
+        throw CMaxMinHeapException(HEAP_FULL);
+    }
+
+    return true;
+}
+// end of CSegmentedMaxMinHeap::Insert()
+
+
+// ==== CSegmentedMaxMinHeap::Remove ==========================================
+//
+// This function removes the top element.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_EMPTY) is thrown
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+bool CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::Remove(HeapItemType &item)
+{
+    if (m_list.IsEmpty())
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    std::optional<HeapItemType> top = TryPop();
+    if (!top)
+    {
+        throw CMaxMinHeapException(HEAP_ERROR);
+    }
+
+    item = std::move(*top);
+
+    return true;
+}
+// end of CSegmentedMaxMinHeap::Remove()
+
+
+// ==== CSegmentedMaxMinHeap::PeekTop =========================================
+//
+// This function peeks the top element.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+HeapItemType CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::PeekTop(void) const
+{
+    const HeapItemType *top = TryPeek();
+
+    if (top == NULL)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return *top;
+}
+// end of CSegmentedMaxMinHeap::PeekTop()
+
+
+// ==== CSegmentedMaxMinHeap::Reserve =========================================
+//
+// This function allocates the chunks for at least numItems items up front.
+//
+// Input:
+//      numItems    -- [IN]: the number of items to make room for
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+void CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::Reserve(int numItems)
+{
+    m_list.Reserve(numItems);
+}
+// end of CSegmentedMaxMinHeap::Reserve()
+
+
+// ==== CSegmentedMaxMinHeap::ReserveDirectory ================================
+//
+// This function sizes the chunk directory for maxItems items without
+// allocating chunks, so growing up to maxItems never copies the directory.
+//
+// Input:
+//      maxItems    -- [IN]: the largest number of items the heap will hold
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+void CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::ReserveDirectory(int maxItems)
+{
+    m_list.ReserveDirectory(maxItems);
+}
+// end of CSegmentedMaxMinHeap::ReserveDirectory()
+
+
+// ==== CSegmentedMaxMinHeap::GetCapacity =====================================
+//
+// This function returns the number of items that fit without allocating.
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+int CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::GetCapacity(void) const
+{
+    return m_list.GetCapacity();
+}
+// end of CSegmentedMaxMinHeap::GetCapacity()
+
+
+// ==== CSegmentedMaxMinHeap::GetHeapType =====================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+int CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of CSegmentedMaxMinHeap::GetHeapType()
+
+
+// ==== CSegmentedMaxMinHeap::GetNumItems =====================================
+//
+// This function returns the number of elements.
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+int CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::GetNumItems(void) const
+{
+    return m_list.GetNumItems();
+}
+// end of CSegmentedMaxMinHeap::GetNumItems()
+
+
+// ==== CSegmentedMaxMinHeap::IsEmpty =========================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType, int ChunkShift>
+bool CSegmentedMaxMinHeap<HeapItemType, ChunkShift>::IsEmpty(void) const
+{
+    return m_list.IsEmpty();
+}
+// end of CSegmentedMaxMinHeap::IsEmpty()
+
+#endif // CSEGMENTEDMAXMINHEAP_H
@@ -0,0 +1,854 @@
+// ============================================================================
+// File: cshmmaxminheap.h
+// ============================================================================
+// Header file for the CShmMaxMinHeap class, a heap of trivially copyable
+// items that lives in a POSIX shared-memory segment, so that several
+// processes on one host can feed and drain one priority queue.
+//
+// The segment holds a fixed size header followed by the items in the same
+// array order CList uses. Items are found by index from the start of the
+// item array, never by pointer, so every process may map the segment at a
+// different address.
+//
+// All operations take a process-shared, robust mutex kept in the header.
+// When a process dies while holding it, the next process to lock it gets
+// EOWNERDEAD: the heap order is then rebuilt with HeapBuild before the
+// operation goes on. The operation that was cut short may have lost its item
+// or left another one stored twice; every other item is kept.
+//
+// The capacity is fixed when the segment is created: a mapping that other
+// processes use cannot be moved, so Insert throws SHM_HEAP_FULL instead of
+// growing. Link with -pthread (and -lrt on older glibc).
+//
+// Creating and opening are serialized by an flock on the segment: every
+// process takes it before it looks at the header and drops it once the
+// segment is set up. The kernel releases the flock of a process that dies,
+// so a process that gets the lock and finds m_ready clear knows that the
+// creation was abandoned (or has not started yet), and sets the segment up
+// itself, with its own heap type and capacity.
+//
+// Segment layout (version 1):
+//      bytes [0, sizeof(CShmHeapHeader))   -- CShmHeapHeader
+//      bytes [sizeof(CShmHeapHeader), ...) -- m_capacity items
+// ============================================================================
+#ifndef CSHMMAXMINHEAP_H
+#define CSHMMAXMINHEAP_H
+
+#include    <atomic>
+#include    <cerrno>
+#include    <chrono>
+#include    <climits>
+#include    <cstddef>
+#include    <cstdint>
+#include    <cstring>
+#include    <iterator>
+#include    <type_traits>
+#include    <vector>
+#include    <fcntl.h>
+#include    <pthread.h>
+#include    <sys/file.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+#include    "cmaxminheap.h"
+#include    "heapsift.h"
+
+// constants
+const   char        SHM_HEAP_MAGIC[8] = "CSHMHEP";
+const   uint32_t    SHM_HEAP_VERSION = 1;
+const   int         SHM_HEAP_OPEN_TIMEOUT_MS = 5000;  // wait for a creator
+const   int         SHM_HEAP_OPEN_POLL_US = 200;      // between lock polls
+
+// enumerate list for CShmHeapException class
+enum    CShmHeapExceptionType  { SHM_HEAP_OPEN_FAILED,
+                                 SHM_HEAP_BAD_FORMAT,
+                                 SHM_HEAP_LOCK_FAILED,
+                                 SHM_HEAP_FULL,
+                                 SHM_HEAP_EMPTY
+                               };
+
+
+// exception class for CShmMaxMinHeap
+class CShmHeapException
+{
+public:
+    // constructor
+    CShmHeapException(CShmHeapExceptionType   exceptType)
+            : m_exceptType(exceptType) {}
+
+    // member function
+    CShmHeapExceptionType GetException() const {return m_exceptType;}
+
+private:
+    CShmHeapExceptionType  m_exceptType;
+};
+
+
+// segment header; aligned so the item array starts on a cache line
+struct  alignas(64) CShmHeapHeader
+{
+    char                    m_magic[8];     // SHM_HEAP_MAGIC
+    uint32_t                m_version;      // SHM_HEAP_VERSION
+    uint32_t                m_itemSize;     // sizeof(HeapItemType)
+    uint32_t                m_heapType;     // MAX or MIN
+    std::atomic<uint32_t>   m_ready;        // set once the creator is done
+    uint64_t                m_numItems;     // number of items in use
+    uint64_t                m_capacity;     // number of item slots
+    pthread_mutex_t         m_lock;         // process-shared, robust
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the ready flag is shared between processes");
+
+
+// class declaration
+template <class HeapItemType>
+class   CShmMaxMinHeap
+{
+    static_assert(std::is_trivially_copyable<HeapItemType>::value,
+                  "CShmMaxMinHeap items are copied between processes as bytes");
+
+public:
+    // constructor and destructor
+    CShmMaxMinHeap(const char *segmentName, int heapType = MAX,
+                   int numItems = HEAP_MAX_ITEMS);
+    virtual ~CShmMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+    bool            TryPush(const HeapItemType &newItem);
+    bool            TryPop(HeapItemType &item);
+    template <class OutputIt>
+    int             PopN(int count, OutputIt output);
+    static bool     Unlink(const char *segmentName);
+
+    // Helper functions
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    int             GetCapacity(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    // holds the segment lock for one scope
+    class   CLockGuard
+    {
+    public:
+        CLockGuard(const CShmMaxMinHeap &heap) : m_heap(heap) { m_heap.Lock(); }
+        ~CLockGuard() { pthread_mutex_unlock(&m_heap.m_header->m_lock); }
+
+    private:
+        const CShmMaxMinHeap    &m_heap;
+    };
+
+    // a mapping cannot be shared by two objects
+    CShmMaxMinHeap(const CShmMaxMinHeap &otherObj);
+    CShmMaxMinHeap& operator=(const CShmMaxMinHeap &rhs);
+
+    // data members
+    int                 m_segmentDesc;  // descriptor from shm_open
+    size_t              m_mapSize;      // number of bytes mapped
+    CShmHeapHeader      *m_header;      // start of the mapping
+
+    // utility functions
+    HeapItemType*   GetItems(void) const;
+    void            LockSegmentFile(void);
+    void            CreateSegment(int heapType, int numItems);
+    void            OpenSegment(int heapType, int numItems);
+    void            MapSegment(size_t numBytes);
+    void            CloseSegment(void);
+    void            Lock(void) const;
+    void            PushLocked(const HeapItemType &newItem);
+    void            PopLocked(HeapItemType &item);
+    void            RebuildLocked(void) const;
+};
+
+
+// ==== ShmHeapSegmentSize ====================================================
+//
+// This function returns the segment size needed for a number of item slots.
+//
+// Input:
+//      capacity    -- [IN]: the number of item slots
+//      itemSize    -- [IN]: the size of one item in bytes
+//
+// Output:
+//      size_t      -- [OUT]: the size of the segment in bytes
+// ============================================================================
+inline size_t ShmHeapSegmentSize(uint64_t capacity, size_t itemSize)
+{
+    return (sizeof(CShmHeapHeader) + static_cast<size_t>(capacity) * itemSize);
+}
+// end of ShmHeapSegmentSize()
+
+
+// ==== CShmMaxMinHeap::CShmMaxMinHeap ========================================
+//
+// This constructor opens the shared-memory segment, or creates it when it
+// does not exist yet. An existing segment keeps its own heap type and
+// capacity; heapType and numItems are only used for a new one, or for one
+// whose creator died before finishing it. A process that opens a segment
+// while another one is still creating it waits up to
+// SHM_HEAP_OPEN_TIMEOUT_MS for the creator.
+//
+// Input:
+//      segmentName -- [IN]: the shm_open name, such as "/jobqueue"
+//      heapType    -- [IN]: MAX or MIN
+//      numItems    -- [IN]: the capacity of a new segment
+//
+// ============================================================================
+template <class HeapItemType>
+CShmMaxMinHeap<HeapItemType>::CShmMaxMinHeap(const char *segmentName,
+                                             int heapType, int numItems)
+: m_segmentDesc(-1), m_mapSize(0), m_header(NULL)
+{
+    bool created;
+
+    // create the name, or attach to the existing one
+    m_segmentDesc = shm_open(segmentName, O_RDWR | O_CREAT | O_EXCL, 0600);
+    created = (m_segmentDesc >= 0);
+    if (!created && (errno == EEXIST))
+    {
+        m_segmentDesc = shm_open(segmentName, O_RDWR, 0600);
+    }
+    if (m_segmentDesc < 0)
+    {
+        throw CShmHeapException(SHM_HEAP_OPEN_FAILED);
+    }
+
+    try
+    {
+        LockSegmentFile();
+        OpenSegment(heapType, numItems);
+        flock(m_segmentDesc, LOCK_UN);
+    }
+    catch (...)
+    {
+        CloseSegment();
+        if (created)
+        {
+            shm_unlink(segmentName);
+        }
+        throw;
+    }
+}
+// end of CShmMaxMinHeap::CShmMaxMinHeap()
+
+
+// ==== CShmMaxMinHeap::~CShmMaxMinHeap() =====================================
+//
+// This is the destructor. It unmaps the segment; the segment itself stays
+// until Unlink is called and the last process has unmapped it.
+//
+// ============================================================================
+template <class HeapItemType>
+CShmMaxMinHeap<HeapItemType>::~CShmMaxMinHeap()
+{
+    CloseSegment();
+}
+// end of CShmMaxMinHeap::~CShmMaxMinHeap()
+
+
+// ==== CShmMaxMinHeap::LockSegmentFile() =====================================
+//
+// This function takes the flock that serializes the set up of the segment.
+// It polls, so that a creator that stalls makes the open fail after
+// SHM_HEAP_OPEN_TIMEOUT_MS instead of hanging; a creator that died holds
+// no lock.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::LockSegmentFile(void)
+{
+    std::chrono::steady_clock::time_point deadline
+                    = std::chrono::steady_clock::now()
+                      + std::chrono::milliseconds(SHM_HEAP_OPEN_TIMEOUT_MS);
+
+    while (flock(m_segmentDesc, LOCK_EX | LOCK_NB) != 0)
+    {
+        if (((errno != EWOULDBLOCK) && (errno != EINTR))
+            || (std::chrono::steady_clock::now() >= deadline))
+        {
+            throw CShmHeapException(SHM_HEAP_OPEN_FAILED);
+        }
+        usleep(SHM_HEAP_OPEN_POLL_US);
+    }
+}
+// end of CShmMaxMinHeap::LockSegmentFile()
+
+
+// ==== CShmMaxMinHeap::CreateSegment() =======================================
+//
+// This function sizes a new segment, writes an empty heap and sets up the
+// robust, process-shared mutex. m_ready is stored last, so a header with
+// m_ready set is complete. The caller holds the segment's flock.
+//
+// Input:
+//      heapType    -- [IN]: MAX or MIN
+//      numItems    -- [IN]: the number of item slots
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::CreateSegment(int heapType, int numItems)
+{
+    uint64_t capacity = (numItems > 0) ? numItems : HEAP_MAX_ITEMS;
+    size_t segmentSize = ShmHeapSegmentSize(capacity, sizeof(HeapItemType));
+    pthread_mutexattr_t attributes;
+    bool success;
+
+    if (ftruncate(m_segmentDesc, segmentSize) != 0)
+    {
+        throw CShmHeapException(SHM_HEAP_OPEN_FAILED);
+    }
+    MapSegment(segmentSize);
+
+    std::memcpy(m_header->m_magic, SHM_HEAP_MAGIC, sizeof(m_header->m_magic));
+    m_header->m_version = SHM_HEAP_VERSION;
+    m_header->m_itemSize = sizeof(HeapItemType);
+    m_header->m_heapType = heapType;
+    m_header->m_numItems = 0;
+    m_header->m_capacity = capacity;
+
+    success = (pthread_mutexattr_init(&attributes) == 0);
+    if (success)
+    {
+        success = (pthread_mutexattr_setpshared(&attributes,
+                                                PTHREAD_PROCESS_SHARED) == 0)
+                  && (pthread_mutexattr_setrobust(&attributes,
+                                                  PTHREAD_MUTEX_ROBUST) == 0)
+                  && (pthread_mutex_init(&m_header->m_lock, &attributes) == 0);
+        pthread_mutexattr_destroy(&attributes);
+    }
+    if (!success)
+    {
+        throw CShmHeapException(SHM_HEAP_LOCK_FAILED);
+    }
+
+    m_header->m_ready.store(1, std::memory_order_release);
+}
+// end of CShmMaxMinHeap::CreateSegment()
+
+
+// ==== CShmMaxMinHeap::OpenSegment() =========================================
+//
+// This function maps a segment whose set up is finished and validates its
+// header, or sets the segment up when it is not: its creator died before
+// setting m_ready, or has not taken the flock yet and will find the
+// segment ready when it does. The caller holds the segment's flock.
+//
+// Input:
+//      heapType    -- [IN]: MAX or MIN, for a segment that is not set up
+//      numItems    -- [IN]: the capacity of a segment that is not set up
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::OpenSegment(int heapType, int numItems)
+{
+    struct stat segmentStatus;
+
+    if (fstat(m_segmentDesc, &segmentStatus) != 0)
+    {
+        throw CShmHeapException(SHM_HEAP_OPEN_FAILED);
+    }
+    if (static_cast<size_t>(segmentStatus.st_size) >= sizeof(CShmHeapHeader))
+    {
+        MapSegment(segmentStatus.st_size);
+        if (m_header->m_ready.load(std::memory_order_acquire) != 0)
+        {
+            if ((std::memcmp(m_header->m_magic, SHM_HEAP_MAGIC,
+                             sizeof(m_header->m_magic)) != 0)
+                || (m_header->m_version != SHM_HEAP_VERSION)
+                || (m_header->m_itemSize != sizeof(HeapItemType))
+                || ((m_header->m_heapType != MAX) && (m_header->m_heapType != MIN))
+                || (m_header->m_capacity == 0)
+                || (m_header->m_capacity > static_cast<uint64_t>(INT_MAX))
+                || (m_header->m_numItems > m_header->m_capacity)
+                || (ShmHeapSegmentSize(m_header->m_capacity, sizeof(HeapItemType))
+                    > m_mapSize))
+            {
+                throw CShmHeapException(SHM_HEAP_BAD_FORMAT);
+            }
+            return;
+        }
+
+        munmap(m_header, m_mapSize);
+        m_header = NULL;
+        m_mapSize = 0;
+    }
+
+    CreateSegment(heapType, numItems);
+}
+// end of CShmMaxMinHeap::OpenSegment()
+
+
+// ==== CShmMaxMinHeap::MapSegment() ==========================================
+//
+// This function maps the first numBytes of the segment.
+//
+// Input:
+//      numBytes    -- [IN]: the number of bytes to map
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::MapSegment(size_t numBytes)
+{
+    void *address = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         m_segmentDesc, 0);
+    if (address == MAP_FAILED)
+    {
+        throw CShmHeapException(SHM_HEAP_OPEN_FAILED);
+    }
+
+    m_header = static_cast<CShmHeapHeader *>(address);
+    m_mapSize = numBytes;
+}
+// end of CShmMaxMinHeap::MapSegment()
+
+
+// ==== CShmMaxMinHeap::CloseSegment() ========================================
+//
+// This function releases the mapping and the descriptor, if any.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::CloseSegment(void)
+{
+    if (m_header != NULL)
+    {
+        munmap(m_header, m_mapSize);
+        m_header = NULL;
+        m_mapSize = 0;
+    }
+    if (m_segmentDesc >= 0)
+    {
+        close(m_segmentDesc);
+        m_segmentDesc = -1;
+    }
+}
+// end of CShmMaxMinHeap::CloseSegment()
+
+
+// ==== CShmMaxMinHeap::Unlink() ==============================================
+//
+// This function removes a segment name. Processes that have it mapped keep
+// using it; the memory is freed when the last of them unmaps it.
+//
+// Input:
+//      segmentName -- [IN]: the shm_open name
+//
+// Output:
+//      bool -- [OUT]: true if the name existed and was removed
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::Unlink(const char *segmentName)
+{
+    return (shm_unlink(segmentName) == 0);
+}
+// end of CShmMaxMinHeap::Unlink()
+
+
+// ==== CShmMaxMinHeap::GetItems() ============================================
+//
+// This function returns the item array that follows the header.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType* -- [OUT]: the first item slot
+// ============================================================================
+template <class HeapItemType>
+HeapItemType* CShmMaxMinHeap<HeapItemType>::GetItems(void) const
+{
+    return reinterpret_cast<HeapItemType *>(m_header + 1);
+}
+// end of CShmMaxMinHeap::GetItems()
+
+
+// ==== CShmMaxMinHeap::Lock() ================================================
+//
+// This function takes the segment lock. If its last owner died while holding
+// it, the heap order is rebuilt and the lock is marked consistent again.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::Lock(void) const
+{
+    int result = pthread_mutex_lock(&m_header->m_lock);
+
+    if (result == EOWNERDEAD)
+    {
+        RebuildLocked();
+        result = pthread_mutex_consistent(&m_header->m_lock);
+        if (result != 0)
+        {
+            pthread_mutex_unlock(&m_header->m_lock);
+        }
+    }
+    if (result != 0)
+    {
+        throw CShmHeapException(SHM_HEAP_LOCK_FAILED);
+    }
+}
+// end of CShmMaxMinHeap::Lock()
+
+
+// ==== CShmMaxMinHeap::RebuildLocked() =======================================
+//
+// This function restores the heap order after a process died in the middle
+// of an operation. The caller holds the lock.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::RebuildLocked(void) const
+{
+    HeapItemType *items = GetItems();
+
+    if (m_header->m_numItems > m_header->m_capacity)
+    {
+        m_header->m_numItems = m_header->m_capacity;
+    }
+
+    int numItems = static_cast<int>(m_header->m_numItems);
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapBuild(items, numItems, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapBuild(items, numItems, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CShmMaxMinHeap::RebuildLocked()
+
+
+// ==== CShmMaxMinHeap::PushLocked() ==========================================
+//
+// This function adds an item at the end and heapifies up. The caller holds
+// the lock and has checked that a slot is free.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::PushLocked(const HeapItemType &newItem)
+{
+    HeapItemType *items = GetItems();
+    int newIndex = static_cast<int>(m_header->m_numItems);
+
+    items[newIndex] = newItem;
+    m_header->m_numItems++;
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapSiftUp(items, newIndex, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftUp(items, newIndex, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CShmMaxMinHeap::PushLocked()
+
+
+// ==== CShmMaxMinHeap::PopLocked() ===========================================
+//
+// This function removes the top item and heapifies down. The caller holds
+// the lock and has checked that the heap is not empty.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CShmMaxMinHeap<HeapItemType>::PopLocked(HeapItemType &item)
+{
+    HeapItemType *items = GetItems();
+    int lastIndex = static_cast<int>(m_header->m_numItems) - 1;
+
+    // move the last element to the root and heapify down
+    item = items[0];
+    items[0] = items[lastIndex];
+    m_header->m_numItems--;
+
+    if (m_header->m_heapType == MAX)
+    {
+        HeapSiftDown(items, lastIndex, 0, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftDown(items, lastIndex, 0, CHeapMinOrder<HeapItemType>());
+    }
+}
+// end of CShmMaxMinHeap::PopLocked()
+
+
+// ==== CShmMaxMinHeap::Insert() ==============================================
+//
+// This function inserts an element into the heap.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true when the item was inserted; CShmHeapException
+//              (SHM_HEAP_FULL) is thrown when every slot is in use
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
+{
+    if (!TryPush(newItem))
+    {
+        throw CShmHeapException(SHM_HEAP_FULL);
+    }
+
+    return true;
+}
+// end of CShmMaxMinHeap::Insert()
+
+
+// ==== CShmMaxMinHeap::Remove() ==============================================
+//
+// This function removes the top element of the heap. Other processes may
+// drain the heap between an IsEmpty check and this call; TryPop avoids that
+// race.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true when an element was removed; CShmHeapException
+//              (SHM_HEAP_EMPTY) is thrown when the heap is empty
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
+{
+    if (!TryPop(item))
+    {
+        throw CShmHeapException(SHM_HEAP_EMPTY);
+    }
+
+    return true;
+}
+// end of CShmMaxMinHeap::Remove()
+
+
+// ==== CShmMaxMinHeap::TryPush() =============================================
+//
+// This function inserts an element if a slot is free.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if the segment is full
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::TryPush(const HeapItemType &newItem)
+{
+    CLockGuard guard(*this);
+
+    if (m_header->m_numItems >= m_header->m_capacity)
+    {
+        return false;
+    }
+
+    PushLocked(newItem);
+
+    return true;
+}
+// end of CShmMaxMinHeap::TryPush()
+
+
+// ==== CShmMaxMinHeap::TryPop() ==============================================
+//
+// This function removes the top element if there is one, as a single step
+// under the lock.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: false if the heap is empty
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::TryPop(HeapItemType &item)
+{
+    CLockGuard guard(*this);
+
+    if (m_header->m_numItems == 0)
+    {
+        return false;
+    }
+
+    PopLocked(item);
+
+    return true;
+}
+// end of CShmMaxMinHeap::TryPop()
+
+
+// ==== CShmMaxMinHeap::PopN() ================================================
+//
+// This function removes up to count items, best first, under a single lock
+// acquisition (see HeapPopN). The items are popped into a local buffer,
+// reserved before the heap is touched, and written to output after the
+// lock is released: an output iterator that throws then loses the items it
+// did not take, but cannot leave the shared heap out of order.
+//
+// Input:
+//      count   -- [IN]: the number of items to remove at most
+//      output  -- [IN]: output iterator receiving the items
+//
+// Output:
+//      int -- [OUT]: the number of items removed
+// ============================================================================
+template <class HeapItemType>
+template <class OutputIt>
+int CShmMaxMinHeap<HeapItemType>::PopN(int count, OutputIt output)
+{
+    std::vector<HeapItemType> popped;
+
+    {
+        CLockGuard guard(*this);
+
+        HeapItemType *items = GetItems();
+        int numItems = static_cast<int>(m_header->m_numItems);
+        int numPopped;
+
+        popped.reserve((count < 0) ? 0 : (count < numItems) ? count : numItems);
+        if (m_header->m_heapType == MAX)
+        {
+            numPopped = HeapPopN(items, numItems, count,
+                                 std::back_inserter(popped),
+                                 CHeapMaxOrder<HeapItemType>(),
+                                 CImplicitHeapLayout());
+        }
+        else
+        {
+            numPopped = HeapPopN(items, numItems, count,
+                                 std::back_inserter(popped),
+                                 CHeapMinOrder<HeapItemType>(),
+                                 CImplicitHeapLayout());
+        }
+        m_header->m_numItems -= numPopped;
+    }
+
+    for (const HeapItemType &item : popped)
+    {
+        *output++ = item;
+    }
+
+    return static_cast<int>(popped.size());
+}
+// end of CShmMaxMinHeap::PopN()
+
+
+// ==== CShmMaxMinHeap::PeekTop() =============================================
+//
+// This function peeks the first element of the heap.
+// Input:
+//    void
+//
+// Output:
+//      HeapItemType --[OUT] a copy of the first element of the heap
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CShmMaxMinHeap<HeapItemType>::PeekTop(void) const
+{
+    CLockGuard guard(*this);
+
+    if (m_header->m_numItems == 0)
+    {
+        throw CShmHeapException(SHM_HEAP_EMPTY);
+    }
+
+    return GetItems()[0];
+}
+// end of CShmMaxMinHeap::PeekTop()
+
+
+// ==== CShmMaxMinHeap::GetHeapType() =========================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType>
+int CShmMaxMinHeap<HeapItemType>::GetHeapType(void) const
+{
+    return static_cast<int>(m_header->m_heapType);
+}
+// end of CShmMaxMinHeap::GetHeapType()
+
+
+// ==== CShmMaxMinHeap::GetNumItems() =========================================
+//
+// This function returns the number of items stored in the heap. Other
+// processes may change it as soon as the lock is released.
+// ============================================================================
+template <class HeapItemType>
+int CShmMaxMinHeap<HeapItemType>::GetNumItems(void) const
+{
+    CLockGuard guard(*this);
+
+    return static_cast<int>(m_header->m_numItems);
+}
+// end of CShmMaxMinHeap::GetNumItems()
+
+
+// ==== CShmMaxMinHeap::GetCapacity() =========================================
+//
+// This function returns the number of item slots in the segment.
+// ============================================================================
+template <class HeapItemType>
+int CShmMaxMinHeap<HeapItemType>::GetCapacity(void) const
+{
+    return static_cast<int>(m_header->m_capacity);
+}
+// end of CShmMaxMinHeap::GetCapacity()
+
+
+// ==== CShmMaxMinHeap::IsEmpty() =============================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType>
+bool CShmMaxMinHeap<HeapItemType>::IsEmpty(void) const
+{
+    return (GetNumItems() == 0);
+}
+// end of CShmMaxMinHeap::IsEmpty()
+
+#endif // CSHMMAXMINHEAP_H
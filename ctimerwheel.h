@@ -0,0 +1,800 @@
+// ============================================================================
+// File: ctimerwheel.h
+// ============================================================================
+// Header file for the CTimerWheel class, a timer queue for large numbers of
+// mostly cancelled timeouts, and the clocks that drive it.
+//
+// Near-term timers live in a hierarchical timing wheel: TIMER_WHEEL_LEVELS
+// wheels of TIMER_WHEEL_SLOTS slots, each slot an intrusive doubly linked
+// list. A timer sits on the level of the highest digit (base SLOTS) in which
+// its deadline differs from the current time, so Arm and Cancel are O(1)
+// list operations. When a lower wheel wraps, the next slot of the wheel
+// above is cascaded down; every timer moves at most TIMER_WHEEL_LEVELS
+// times, so each tick is O(1) amortised.
+//
+// Deadlines past the span of the wheels (2^24 ticks) go to a min-heap. Its
+// entries are only looked at when the top wheel wraps, when those falling
+// in the new span migrate into the wheels. Cancelling such a timer frees its
+// node at once and leaves a stale heap entry behind, which migration skips
+// and RemoveIf clears out once the stale entries outnumber the live ones.
+//
+// Time is counted in ticks of an injected CTimerClock: CSteadyTimerClock
+// for real use, CManualTimerClock for deterministic tests. Poll fires every
+// timer whose deadline has been reached, in deadline order across slots.
+// ============================================================================
+#ifndef CTIMERWHEEL_H
+#define CTIMERWHEEL_H
+
+#include    <chrono>
+#include    <cstdint>
+#include    <exception>
+#include    <functional>
+#include    <utility>
+#include    <vector>
+#include    "cmaxminheap.h"
+
+// constants
+const   int         TIMER_WHEEL_BITS = 8;
+const   int         TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;
+const   int         TIMER_WHEEL_LEVELS = 3;
+const   int         TIMER_WHEEL_SPAN_BITS = TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS;
+const   int         TIMER_OVERFLOW_COMPACT_MIN = 64;    // stale entries
+
+// handle to a timer of a CTimerWheel (generation, node)
+typedef uint64_t        CTimerHandle;
+const   CTimerHandle    INVALID_TIMER_HANDLE = ~static_cast<CTimerHandle>(0);
+
+
+// ==== CTimerClock ===========================================================
+//
+// The time source of a CTimerWheel, in ticks. It must never go backwards.
+//
+// ============================================================================
+class   CTimerClock
+{
+public:
+    virtual ~CTimerClock() {}
+
+    virtual uint64_t    GetNow(void) const = 0;
+};
+
+
+// ==== CSteadyTimerClock =====================================================
+//
+// std::chrono::steady_clock in ticks of tickLength (1 ms by default),
+// counted from the clock's construction.
+//
+// ============================================================================
+class   CSteadyTimerClock : public CTimerClock
+{
+public:
+    CSteadyTimerClock(std::chrono::nanoseconds tickLength
+                                            = std::chrono::milliseconds(1))
+                    : m_start(std::chrono::steady_clock::now()),
+                      m_tickLength(tickLength) {}
+
+    uint64_t    GetNow(void) const override
+    {
+        return static_cast<uint64_t>((std::chrono::steady_clock::now()
+                                      - m_start) / m_tickLength);
+    }
+
+private:
+    std::chrono::steady_clock::time_point   m_start;
+    std::chrono::nanoseconds                m_tickLength;
+};
+
+
+// ==== CManualTimerClock =====================================================
+//
+// A clock that moves only when told to, for tests.
+//
+// ============================================================================
+class   CManualTimerClock : public CTimerClock
+{
+public:
+    CManualTimerClock(uint64_t now = 0) : m_now(now) {}
+
+    uint64_t    GetNow(void) const override { return m_now; }
+    void        SetNow(uint64_t now) { m_now = now; }
+    void        AdvanceBy(uint64_t numTicks) { m_now += numTicks; }
+
+private:
+    uint64_t    m_now;
+};
+
+
+// class declaration
+template <class CallbackType = std::function<void()>>
+class   CTimerWheel
+{
+public:
+    // constructor and destructor
+    CTimerWheel(const CTimerClock &clock);
+    virtual ~CTimerWheel();
+
+    // member functions
+    CTimerHandle    Arm(uint64_t deadline, CallbackType callback);
+    CTimerHandle    ArmAfter(uint64_t delay, CallbackType callback);
+    bool            Cancel(CTimerHandle handle);
+    int             Poll(void);
+    int             AdvanceTo(uint64_t now);
+
+    // Helper functions
+    bool            IsArmed(CTimerHandle handle) const;
+    uint64_t        GetNow(void) const { return m_now; }
+    int             GetNumTimers(void) const { return m_numTimers; }
+    int             GetNumOverflow(void) const;
+
+private:
+    static const uint32_t   NIL = ~static_cast<uint32_t>(0);
+    static const int        IN_OVERFLOW = -1;   // m_location values besides
+    static const int        IS_FREE = -2;       // a wheel slot index
+
+    // one timer; free nodes are chained through m_next
+    struct  CTimerNode
+    {
+        uint64_t        m_deadline;
+        uint32_t        m_prev;
+        uint32_t        m_next;
+        uint32_t        m_generation;
+        int             m_location;     // level * SLOTS + slot, or the above
+        CallbackType    m_callback;
+    };
+
+    // a far-future timer waiting in the overflow heap
+    struct  COverflowEntry
+    {
+        uint64_t        m_deadline;
+        CTimerHandle    m_handle;
+
+        bool operator<(const COverflowEntry &rhs) const
+        { return (m_deadline < rhs.m_deadline); }
+        bool operator>(const COverflowEntry &rhs) const
+        { return (m_deadline > rhs.m_deadline); }
+    };
+
+    // data members
+    const CTimerClock           *m_clock;       // the time source
+    uint64_t                    m_now;          // every deadline <= m_now fired
+    std::vector<CTimerNode>     m_nodes;        // the timers, live and free
+    uint32_t                    m_firstFree;    // free node chain
+    uint32_t                    m_slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    uint64_t                    m_occupied[TIMER_WHEEL_SLOTS / 64]; // level 0
+    int                         m_numTimers;    // armed timers
+    int                         m_numInWheel;   // of which in the wheels
+    CMaxMinHeap<COverflowEntry> m_overflow;     // far-future timers
+    int                         m_numStale;     // cancelled overflow entries
+
+    // no copying: handles refer to this wheel's nodes
+    CTimerWheel(const CTimerWheel &);
+    CTimerWheel&    operator=(const CTimerWheel &);
+
+    // utility functions
+    uint32_t        AcquireNode(void);
+    void            ReleaseNode(uint32_t node);
+    bool            FindNode(CTimerHandle handle, uint32_t &node) const;
+    void            Place(uint32_t node);
+    void            Link(uint32_t node, int location);
+    void            Unlink(uint32_t node);
+    void            Cascade(int level);
+    void            MigrateOverflow(void);
+    int             FireSlot(int slot);
+    int             FirstOccupiedSlot(int slot) const;
+};
+
+
+// ==== CTimerWheel::CTimerWheel ==============================================
+//
+// This is the constructor. The wheel starts at the clock's current time.
+//
+// Input:
+//      clock   -- [IN]: the time source; it must outlive the wheel
+//
+// ============================================================================
+template <class CallbackType>
+CTimerWheel<CallbackType>::CTimerWheel(const CTimerClock &clock)
+: m_clock(&clock), m_now(clock.GetNow()), m_firstFree(NIL), m_numTimers(0),
+  m_numInWheel(0), m_overflow(MIN), m_numStale(0)
+{
+    for (uint32_t &head : m_slots)
+    {
+        head = NIL;
+    }
+    for (uint64_t &word : m_occupied)
+    {
+        word = 0;
+    }
+}
+// end of CTimerWheel::CTimerWheel()
+
+
+// ==== CTimerWheel::~CTimerWheel =============================================
+//
+// This is the destructor. Pending timers are dropped without firing.
+//
+// ============================================================================
+template <class CallbackType>
+CTimerWheel<CallbackType>::~CTimerWheel()
+{
+}
+// end of CTimerWheel::~CTimerWheel()
+
+
+// ==== CTimerWheel::AcquireNode ==============================================
+//
+// This function takes a free node (or adds one).
+//
+// Input:
+//      void
+//
+// Output:
+//      uint32_t -- [OUT]: the node's index
+// ============================================================================
+template <class CallbackType>
+uint32_t CTimerWheel<CallbackType>::AcquireNode(void)
+{
+    uint32_t node = m_firstFree;
+
+    if (node == NIL)
+    {
+        node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(CTimerNode());
+        m_nodes[node].m_generation = 0;
+    }
+    else
+    {
+        m_firstFree = m_nodes[node].m_next;
+    }
+
+    m_nodes[node].m_prev = m_nodes[node].m_next = NIL;
+    m_numTimers++;
+
+    return node;
+}
+// end of CTimerWheel::AcquireNode()
+
+
+// ==== CTimerWheel::ReleaseNode ==============================================
+//
+// This function frees a node that is in no list. The new generation makes
+// its handle stale.
+//
+// Input:
+//      node    -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::ReleaseNode(uint32_t node)
+{
+    CTimerNode &timer = m_nodes[node];
+
+    timer.m_callback = CallbackType();
+    timer.m_generation++;
+    timer.m_location = IS_FREE;
+    timer.m_next = m_firstFree;
+    m_firstFree = node;
+    m_numTimers--;
+}
+// end of CTimerWheel::ReleaseNode()
+
+
+// ==== CTimerWheel::FindNode =================================================
+//
+// This function looks up the node of a live handle.
+//
+// Input:
+//      handle  -- [IN]: the handle
+//      node    -- [OUT]: the node's index
+//
+// Output:
+//      bool -- [OUT]: false if the timer fired or was cancelled
+// ============================================================================
+template <class CallbackType>
+bool CTimerWheel<CallbackType>::FindNode(CTimerHandle handle, uint32_t &node) const
+{
+    node = static_cast<uint32_t>(handle);
+
+    return ((node < m_nodes.size())
+            && (m_nodes[node].m_generation == static_cast<uint32_t>(handle >> 32))
+            && (m_nodes[node].m_location != IS_FREE));
+}
+// end of CTimerWheel::FindNode()
+
+
+// ==== CTimerWheel::Link =====================================================
+//
+// This function pushes a node onto the front of a wheel slot.
+//
+// Input:
+//      node        -- [IN]: the node's index
+//      location    -- [IN]: level * SLOTS + slot
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::Link(uint32_t node, int location)
+{
+    CTimerNode &timer = m_nodes[node];
+
+    timer.m_location = location;
+    timer.m_prev = NIL;
+    timer.m_next = m_slots[location];
+    if (timer.m_next != NIL)
+    {
+        m_nodes[timer.m_next].m_prev = node;
+    }
+    m_slots[location] = node;
+
+    if (location < TIMER_WHEEL_SLOTS)
+    {
+        m_occupied[location / 64] |= static_cast<uint64_t>(1) << (location % 64);
+    }
+    m_numInWheel++;
+}
+// end of CTimerWheel::Link()
+
+
+// ==== CTimerWheel::Unlink ===================================================
+//
+// This function takes a node out of its wheel slot.
+//
+// Input:
+//      node    -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::Unlink(uint32_t node)
+{
+    CTimerNode &timer = m_nodes[node];
+    int location = timer.m_location;
+
+    if (timer.m_prev != NIL)
+    {
+        m_nodes[timer.m_prev].m_next = timer.m_next;
+    }
+    else
+    {
+        m_slots[location] = timer.m_next;
+    }
+    if (timer.m_next != NIL)
+    {
+        m_nodes[timer.m_next].m_prev = timer.m_prev;
+    }
+
+    if ((location < TIMER_WHEEL_SLOTS) && (m_slots[location] == NIL))
+    {
+        m_occupied[location / 64] &= ~(static_cast<uint64_t>(1) << (location % 64));
+    }
+    m_numInWheel--;
+}
+// end of CTimerWheel::Unlink()
+
+
+// ==== CTimerWheel::Place ====================================================
+//
+// This function files a node by its deadline, which must not be before
+// m_now: in the wheel level of the highest digit in which the deadline and
+// m_now differ, or in the overflow heap past the wheels' span.
+//
+// Input:
+//      node    -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::Place(uint32_t node)
+{
+    uint64_t deadline = m_nodes[node].m_deadline;
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        int shift = TIMER_WHEEL_BITS * (level + 1);
+
+        if ((deadline >> shift) == (m_now >> shift))
+        {
+            int slot = static_cast<int>(deadline >> (TIMER_WHEEL_BITS * level))
+                       & (TIMER_WHEEL_SLOTS - 1);
+            Link(node, level * TIMER_WHEEL_SLOTS + slot);
+            return;
+        }
+    }
+
+    COverflowEntry entry;
+    entry.m_deadline = deadline;
+    entry.m_handle = (static_cast<CTimerHandle>(m_nodes[node].m_generation) << 32)
+                     | node;
+    m_overflow.Insert(entry);
+    m_nodes[node].m_location = IN_OVERFLOW;
+}
+// end of CTimerWheel::Place()
+
+
+// ==== CTimerWheel::Arm ======================================================
+//
+// This function arms a timer. A deadline already reached fires on the next
+// tick.
+//
+// Input:
+//      deadline    -- [IN]: the clock time, in ticks, to fire at
+//      callback    -- [IN]: called with no arguments when the timer fires
+//
+// Output:
+//      CTimerHandle -- [OUT]: the timer's handle, for Cancel
+// ============================================================================
+template <class CallbackType>
+CTimerHandle CTimerWheel<CallbackType>::Arm(uint64_t deadline, CallbackType callback)
+{
+    uint32_t node = AcquireNode();
+    CTimerNode &timer = m_nodes[node];
+
+    timer.m_deadline = (deadline > m_now) ? deadline : m_now + 1;
+    timer.m_callback = std::move(callback);
+
+    try
+    {
+        Place(node);
+    }
+    catch (...)
+    {
+        ReleaseNode(node);
+        throw;
+    }
+
+    return ((static_cast<CTimerHandle>(timer.m_generation) << 32) | node);
+}
+// end of CTimerWheel::Arm()
+
+
+// ==== CTimerWheel::ArmAfter =================================================
+//
+// This function arms a timer relative to the clock's current time.
+//
+// Input:
+//      delay       -- [IN]: ticks from now
+//      callback    -- [IN]: called with no arguments when the timer fires
+//
+// Output:
+//      CTimerHandle -- [OUT]: the timer's handle, for Cancel
+// ============================================================================
+template <class CallbackType>
+CTimerHandle CTimerWheel<CallbackType>::ArmAfter(uint64_t delay, CallbackType callback)
+{
+    return Arm(m_clock->GetNow() + delay, std::move(callback));
+}
+// end of CTimerWheel::ArmAfter()
+
+
+// ==== CTimerWheel::Cancel ===================================================
+//
+// This function disarms a timer in O(1).
+//
+// Input:
+//      handle  -- [IN]: the timer's handle
+//
+// Output:
+//      bool -- [OUT]: false if the timer already fired or was cancelled
+// ============================================================================
+template <class CallbackType>
+bool CTimerWheel<CallbackType>::Cancel(CTimerHandle handle)
+{
+    uint32_t node;
+
+    if (!FindNode(handle, node))
+    {
+        return false;
+    }
+
+    if (m_nodes[node].m_location == IN_OVERFLOW)
+    {
+        // leave the heap entry; its handle is stale from now on
+        m_numStale++;
+    }
+    else
+    {
+        Unlink(node);
+    }
+    ReleaseNode(node);
+
+    if ((m_numStale > TIMER_OVERFLOW_COMPACT_MIN)
+        && (m_numStale > m_overflow.GetNumItems() / 2))
+    {
+        m_overflow.RemoveIf([this](const COverflowEntry &entry)
+                            { uint32_t liveNode;
+                              return !FindNode(entry.m_handle, liveNode); });
+        m_numStale = 0;
+    }
+
+    return true;
+}
+// end of CTimerWheel::Cancel()
+
+
+// ==== CTimerWheel::Cascade ==================================================
+//
+// This function empties the current slot of a wheel level into the levels
+// below, once the level below has wrapped.
+//
+// Input:
+//      level   -- [IN]: the level, at least 1
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::Cascade(int level)
+{
+    int slot = static_cast<int>(m_now >> (TIMER_WHEEL_BITS * level))
+               & (TIMER_WHEEL_SLOTS - 1);
+    int location = level * TIMER_WHEEL_SLOTS + slot;
+
+    while (m_slots[location] != NIL)
+    {
+        uint32_t node = m_slots[location];
+
+        Unlink(node);
+        Place(node);
+    }
+}
+// end of CTimerWheel::Cascade()
+
+
+// ==== CTimerWheel::MigrateOverflow ==========================================
+//
+// This function moves the overflow timers that fall in the wheels' current
+// span into the wheels, dropping stale entries on the way.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class CallbackType>
+void CTimerWheel<CallbackType>::MigrateOverflow(void)
+{
+    COverflowEntry entry;
+    uint32_t node;
+
+    while (!m_overflow.IsEmpty()
+           && ((m_overflow.TryPeek()->m_deadline >> TIMER_WHEEL_SPAN_BITS)
+               <= (m_now >> TIMER_WHEEL_SPAN_BITS)))
+    {
+        m_overflow.Remove(entry);
+
+        if (FindNode(entry.m_handle, node))
+        {
+            Place(node);
+        }
+        else if (m_numStale > 0)
+        {
+            m_numStale--;
+        }
+    }
+}
+// end of CTimerWheel::MigrateOverflow()
+
+
+// ==== CTimerWheel::FireSlot =================================================
+//
+// This function fires the timers of a level 0 slot, all due at m_now. They
+// are taken one at a time, so a callback may Arm or Cancel timers. A
+// callback that throws does not stop the slot: m_now is already past these
+// deadlines, so a timer left in the slot would only fire a full wheel turn
+// late. The first exception is rethrown once the slot is empty.
+//
+// Input:
+//      slot    -- [IN]: the level 0 slot
+//
+// Output:
+//      int -- [OUT]: the number of timers fired
+// ============================================================================
+template <class CallbackType>
+int CTimerWheel<CallbackType>::FireSlot(int slot)
+{
+    int numFired = 0;
+    std::exception_ptr firstError;
+
+    while (m_slots[slot] != NIL)
+    {
+        uint32_t node = m_slots[slot];
+        CallbackType callback = std::move(m_nodes[node].m_callback);
+
+        Unlink(node);
+        ReleaseNode(node);
+        numFired++;
+
+        try
+        {
+            callback();
+        }
+        catch (...)
+        {
+            if (!firstError)
+            {
+                firstError = std::current_exception();
+            }
+        }
+    }
+
+    if (firstError)
+    {
+        std::rethrow_exception(firstError);
+    }
+
+    return numFired;
+}
+// end of CTimerWheel::FireSlot()
+
+
+// ==== CTimerWheel::FirstOccupiedSlot ========================================
+//
+// This function finds the first non-empty level 0 slot at or after a slot.
+//
+// Input:
+//      slot    -- [IN]: the slot to start from
+//
+// Output:
+//      int -- [OUT]: the slot, or TIMER_WHEEL_SLOTS if there is none
+// ============================================================================
+template <class CallbackType>
+int CTimerWheel<CallbackType>::FirstOccupiedSlot(int slot) const
+{
+    while (slot < TIMER_WHEEL_SLOTS)
+    {
+        uint64_t word = m_occupied[slot / 64] >> (slot % 64);
+
+        if (word != 0)
+        {
+            int offset = 0;
+            while ((word & 1) == 0)
+            {
+                word >>= 1;
+                offset++;
+            }
+            return slot + offset;
+        }
+        slot = (slot / 64 + 1) * 64;
+    }
+
+    return TIMER_WHEEL_SLOTS;
+}
+// end of CTimerWheel::FirstOccupiedSlot()
+
+
+// ==== CTimerWheel::AdvanceTo ================================================
+//
+// This function moves the wheel's time forward to now and fires every timer
+// due by then. Runs of empty level 0 slots, and stretches with no timer in
+// the wheels at all, are skipped rather than ticked through.
+//
+// If a callback throws, the other timers of its tick still fire, then the
+// exception propagates with the wheel's time at that tick; the next call
+// carries on from there, so no timer is skipped.
+//
+// Input:
+//      now     -- [IN]: the new time, in ticks
+//
+// Output:
+//      int -- [OUT]: the number of timers fired
+// ============================================================================
+template <class CallbackType>
+int CTimerWheel<CallbackType>::AdvanceTo(uint64_t now)
+{
+    int numFired = 0;
+
+    while (m_now < now)
+    {
+        uint64_t target = now;
+
+        if (m_numInWheel == 0)
+        {
+            // nothing to tick through: jump to just before the earliest
+            // overflow deadline (stale or not) and pull in its span
+            if (!m_overflow.IsEmpty())
+            {
+                uint64_t nextDeadline = m_overflow.TryPeek()->m_deadline;
+                if (nextDeadline - 1 < target)
+                {
+                    target = nextDeadline - 1;
+                }
+            }
+        }
+        else
+        {
+            // skip to just before the next occupied level 0 slot, or to the
+            // end of this turn of level 0
+            int slot = static_cast<int>(m_now) & (TIMER_WHEEL_SLOTS - 1);
+            int nextSlot = FirstOccupiedSlot(slot + 1);
+            uint64_t turnEnd = m_now + static_cast<uint64_t>(nextSlot - slot - 1);
+
+            if (turnEnd < target)
+            {
+                target = turnEnd;
+            }
+        }
+
+        if (target > m_now)
+        {
+            m_now = target;
+            if (m_numInWheel == 0)
+            {
+                MigrateOverflow();
+            }
+            continue;
+        }
+
+        // one tick: cascade the levels whose lower levels wrapped, top first
+        // so timers can fall more than one level, then fire level 0
+        m_now++;
+
+        if ((m_now & ((static_cast<uint64_t>(1) << TIMER_WHEEL_SPAN_BITS) - 1)) == 0)
+        {
+            MigrateOverflow();
+        }
+        for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; --level)
+        {
+            if ((m_now & ((static_cast<uint64_t>(1) << (TIMER_WHEEL_BITS * level)) - 1)) == 0)
+            {
+                Cascade(level);
+            }
+        }
+
+        numFired += FireSlot(static_cast<int>(m_now) & (TIMER_WHEEL_SLOTS - 1));
+    }
+
+    return numFired;
+}
+// end of CTimerWheel::AdvanceTo()
+
+
+// ==== CTimerWheel::Poll =====================================================
+//
+// This function fires every timer due by the clock's current time.
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: the number of timers fired
+// ============================================================================
+template <class CallbackType>
+int CTimerWheel<CallbackType>::Poll(void)
+{
+    return AdvanceTo(m_clock->GetNow());
+}
+// end of CTimerWheel::Poll()
+
+
+// ==== CTimerWheel::IsArmed ==================================================
+//
+// This function returns a boolean value if the timer is still pending.
+// ============================================================================
+template <class CallbackType>
+bool CTimerWheel<CallbackType>::IsArmed(CTimerHandle handle) const
+{
+    uint32_t node;
+
+    return FindNode(handle, node);
+}
+// end of CTimerWheel::IsArmed()
+
+
+// ==== CTimerWheel::GetNumOverflow ===========================================
+//
+// This function returns the number of armed timers in the overflow heap.
+// ============================================================================
+template <class CallbackType>
+int CTimerWheel<CallbackType>::GetNumOverflow(void) const
+{
+    return m_numTimers - m_numInWheel;
+}
+// end of CTimerWheel::GetNumOverflow()
+
+#endif // CTIMERWHEEL_H
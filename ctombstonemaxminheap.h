@@ -0,0 +1,616 @@
+// ============================================================================
+// File: ctombstonemaxminheap.h
+// ============================================================================
+// Header file for the CTombstoneMaxMinHeap class, a heap whose elements can
+// be cancelled in O(1).
+//
+// Insert returns a handle. MarkDeleted(handle) only flags the element as a
+// tombstone; the element stays in the array until it reaches the top (where
+// it is dropped) or until the tombstones make up more than the compaction
+// fraction of the array, at which point they are all removed in one pass
+// (CList::RemoveIf) and the heap is rebuilt in O(n). The top element is
+// never a tombstone, so PeekTop and Remove behave as in CMaxMinHeap.
+//
+// A handle stays valid until its element is removed or dropped; after that,
+// MarkDeleted on it returns false (slots are reused with a new generation).
+// ============================================================================
+#ifndef CTOMBSTONEMAXMINHEAP_H
+#define CTOMBSTONEMAXMINHEAP_H
+
+#include    <cstdint>
+#include    <vector>
+#include    "cmaxminheap.h"
+#include    "heapsift.h"
+
+// constants
+const   double  TOMBSTONE_COMPACT_FRACTION = 0.5;   // dead share that compacts
+
+// handle to an element of a CTombstoneMaxMinHeap (generation, slot)
+typedef uint64_t    CHeapHandle;
+const   CHeapHandle INVALID_HEAP_HANDLE = ~static_cast<CHeapHandle>(0);
+
+
+// an element and the slot that records whether it is a tombstone
+template <class HeapItemType>
+struct  CTombstoneEntry
+{
+    HeapItemType    m_item; // the element
+    uint32_t        m_slot; // index into the slot tables
+};
+
+template <class HeapItemType>
+bool operator<(const CTombstoneEntry<HeapItemType> &lhs,
+               const CTombstoneEntry<HeapItemType> &rhs)
+{
+    return (lhs.m_item < rhs.m_item);
+}
+
+template <class HeapItemType>
+bool operator>(const CTombstoneEntry<HeapItemType> &lhs,
+               const CTombstoneEntry<HeapItemType> &rhs)
+{
+    return (lhs.m_item > rhs.m_item);
+}
+
+template <class HeapItemType>
+bool operator==(const CTombstoneEntry<HeapItemType> &lhs,
+                const CTombstoneEntry<HeapItemType> &rhs)
+{
+    return (lhs.m_item == rhs.m_item);
+}
+
+
+// class declaration
+template <class HeapItemType>
+class   CTombstoneMaxMinHeap : private CList<CTombstoneEntry<HeapItemType> >
+{
+public:
+    // constructor and destructor
+    CTombstoneMaxMinHeap(int heapType = MAX,
+                         double compactFraction = TOMBSTONE_COMPACT_FRACTION);
+    virtual ~CTombstoneMaxMinHeap();
+
+    // member functions
+    CHeapHandle     Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+    bool            MarkDeleted(CHeapHandle handle);
+    template <class Predicate>
+    int             MarkDeletedIf(Predicate deleteItem);
+    void            Compact(void);
+
+    // Helper functions
+    bool            IsLive(CHeapHandle handle) const noexcept;
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    int             GetNumDeleted(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    typedef CTombstoneEntry<HeapItemType>   EntryType;
+    typedef CList<EntryType>                ListType;
+
+    // data members
+    int     m_heapType;         // MAX or MIN
+    double  m_compactFraction;  // tombstone share that triggers Compact
+    int     m_numDeleted;       // tombstones still in the array
+
+    std::vector<uint32_t>       m_generations;  // per slot, bumped on reuse
+    std::vector<unsigned char>  m_deleted;      // per slot, 1 = tombstone
+    std::vector<uint32_t>       m_freeSlots;    // slots ready for reuse
+
+    // utility functions
+    CHeapHandle     AcquireSlot(void);
+    void            ReleaseSlot(uint32_t slot);
+    void            PopTop(void);
+    void            DropDeletedTops(void);
+    void            CompactIfNeeded(void);
+    void            SiftUp(int index);
+    void            SiftDown(int index);
+};
+
+
+// ==== CTombstoneMaxMinHeap::CTombstoneMaxMinHeap ============================
+//
+// This is the constructor.
+//
+// ============================================================================
+template <class HeapItemType>
+CTombstoneMaxMinHeap<HeapItemType>::CTombstoneMaxMinHeap(int heapType,
+                                                         double compactFraction)
+: ListType(), m_heapType(heapType), m_compactFraction(compactFraction),
+  m_numDeleted(0)
+{
+}
+// end of CTombstoneMaxMinHeap::CTombstoneMaxMinHeap()
+
+
+// ==== CTombstoneMaxMinHeap::~CTombstoneMaxMinHeap ===========================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class HeapItemType>
+CTombstoneMaxMinHeap<HeapItemType>::~CTombstoneMaxMinHeap()
+{
+}
+// end of CTombstoneMaxMinHeap::~CTombstoneMaxMinHeap()
+
+
+// ==== CTombstoneMaxMinHeap::SiftUp ==========================================
+//
+// This function heapifys up from a node.
+//
+// Input:
+//      int  index -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::SiftUp(int index)
+{
+    if (m_heapType == MAX)
+    {
+        HeapSiftUp(ListType::GetItemArray(), index, CHeapMaxOrder<EntryType>());
+    }
+    else
+    {
+        HeapSiftUp(ListType::GetItemArray(), index, CHeapMinOrder<EntryType>());
+    }
+}
+// end of CTombstoneMaxMinHeap::SiftUp()
+
+
+// ==== CTombstoneMaxMinHeap::SiftDown ========================================
+//
+// This function heapifys down from a node.
+//
+// Input:
+//      int  index -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::SiftDown(int index)
+{
+    if (m_heapType == MAX)
+    {
+        HeapSiftDown(ListType::GetItemArray(), ListType::GetNumItems(), index,
+                     CHeapMaxOrder<EntryType>());
+    }
+    else
+    {
+        HeapSiftDown(ListType::GetItemArray(), ListType::GetNumItems(), index,
+                     CHeapMinOrder<EntryType>());
+    }
+}
+// end of CTombstoneMaxMinHeap::SiftDown()
+
+
+// ==== CTombstoneMaxMinHeap::AcquireSlot =====================================
+//
+// This function takes a free slot (or adds one) and returns its handle.
+// m_freeSlots is kept with room for every slot, so that ReleaseSlot, which
+// Compact calls from inside its RemoveIf predicate, never allocates.
+//
+// Input:
+//      void
+//
+// Output:
+//      CHeapHandle -- [OUT]: the handle of the slot
+// ============================================================================
+template <class HeapItemType>
+CHeapHandle CTombstoneMaxMinHeap<HeapItemType>::AcquireSlot(void)
+{
+    uint32_t slot;
+
+    if (m_freeSlots.empty())
+    {
+        slot = static_cast<uint32_t>(m_generations.size());
+        if (m_freeSlots.capacity() <= m_generations.size())
+        {
+            m_freeSlots.reserve(2 * m_generations.size() + 1);
+        }
+        m_deleted.push_back(0);
+        try
+        {
+            m_generations.push_back(0);
+        }
+        catch (...)
+        {
+            m_deleted.pop_back();
+            throw;
+        }
+    }
+    else
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    return ((static_cast<CHeapHandle>(m_generations[slot]) << 32) | slot);
+}
+// end of CTombstoneMaxMinHeap::AcquireSlot()
+
+
+// ==== CTombstoneMaxMinHeap::ReleaseSlot =====================================
+//
+// This function frees the slot of an element that left the array. The new
+// generation makes the old handle stale. The slot is queued for reuse
+// first, so that the slot is left as it was if that cannot be done.
+//
+// Input:
+//      slot    -- [IN]: the slot
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::ReleaseSlot(uint32_t slot)
+{
+    m_freeSlots.push_back(slot);
+    if (m_deleted[slot])
+    {
+        m_deleted[slot] = 0;
+        m_numDeleted--;
+    }
+    m_generations[slot]++;
+}
+// end of CTombstoneMaxMinHeap::ReleaseSlot()
+
+
+// ==== CTombstoneMaxMinHeap::PopTop ==========================================
+//
+// This function drops the top entry of the array, live or not.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::PopTop(void)
+{
+    EntryType *entries = ListType::GetItemArray();
+    int lastIndex = ListType::GetNumItems() - 1;
+
+    ReleaseSlot(entries[0].m_slot);
+    if (lastIndex > 0)
+    {
+        entries[0] = std::move(entries[lastIndex]);
+    }
+    ListType::RemoveLast();
+    SiftDown(0);
+}
+// end of CTombstoneMaxMinHeap::PopTop()
+
+
+// ==== CTombstoneMaxMinHeap::DropDeletedTops =================================
+//
+// This function drops tombstones from the top until the top is live (or the
+// array is empty).
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::DropDeletedTops(void)
+{
+    while (!ListType::IsEmpty()
+           && m_deleted[ListType::GetItemArray()[0].m_slot])
+    {
+        PopTop();
+    }
+}
+// end of CTombstoneMaxMinHeap::DropDeletedTops()
+
+
+// ==== CTombstoneMaxMinHeap::CompactIfNeeded =================================
+//
+// This function compacts the array once the tombstones make up more than the
+// compaction fraction of it.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::CompactIfNeeded(void)
+{
+    if (m_numDeleted > m_compactFraction * ListType::GetNumItems())
+    {
+        Compact();
+    }
+    else
+    {
+        DropDeletedTops();
+    }
+}
+// end of CTombstoneMaxMinHeap::CompactIfNeeded()
+
+
+// ==== CTombstoneMaxMinHeap::Compact =========================================
+//
+// This function removes every tombstone in one pass over the array and then
+// rebuilds the heap in O(n).
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void CTombstoneMaxMinHeap<HeapItemType>::Compact(void)
+{
+    if (m_numDeleted == 0)
+    {
+        return;
+    }
+
+    // a no-op unless this heap is a copy, whose m_freeSlots is only as
+    // large as its contents: ReleaseSlot must not throw inside RemoveIf
+    m_freeSlots.reserve(m_generations.size());
+    ListType::RemoveIf([this](const EntryType &entry)
+                       {
+                           if (!m_deleted[entry.m_slot])
+                           {
+                               return false;
+                           }
+                           ReleaseSlot(entry.m_slot);
+                           return true;
+                       });
+
+    if (m_heapType == MAX)
+    {
+        HeapBuild(ListType::GetItemArray(), ListType::GetNumItems(),
+                  CHeapMaxOrder<EntryType>());
+    }
+    else
+    {
+        HeapBuild(ListType::GetItemArray(), ListType::GetNumItems(),
+                  CHeapMinOrder<EntryType>());
+    }
+}
+// end of CTombstoneMaxMinHeap::Compact()
+
+
+// ==== CTombstoneMaxMinHeap::Insert ==========================================
+//
+// This function inserts an element and returns its handle.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      CHeapHandle -- [OUT]: the handle to pass to MarkDeleted
+// ============================================================================
+template <class HeapItemType>
+CHeapHandle CTombstoneMaxMinHeap<HeapItemType>::Insert(const HeapItemType  &newItem)
+{
+    if (ListType::IsFull())
+    {
+        int numItems = ListType::GetNumItems();
+        ListType::SetListSize((numItems > 0) ? 2 * numItems : HEAP_MAX_ITEMS);
+    }
+
+    EntryType entry;
+    entry.m_item = newItem;
+
+    // the slot is taken only once the copy succeeded, and given back if the
+    // entry cannot be stored
+    CHeapHandle handle = AcquireSlot();
+    entry.m_slot = static_cast<uint32_t>(handle);
+
+    try
+    {
+        ListType::Insert(entry);
+    }
+    catch (...)
+    {
+        ReleaseSlot(entry.m_slot);
+        throw;
+    }
+    SiftUp(ListType::GetNumItems() - 1);
+
+    return handle;
+}
+// end of CTombstoneMaxMinHeap::Insert()
+
+
+// ==== CTombstoneMaxMinHeap::Remove ==========================================
+//
+// This function removes the top (live) element.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true when an element was removed
+// ============================================================================
+template <class HeapItemType>
+bool CTombstoneMaxMinHeap<HeapItemType>::Remove(HeapItemType &item)
+{
+    if (ListType::IsEmpty())
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    item = std::move(ListType::GetItemArray()[0].m_item);
+    PopTop();
+    DropDeletedTops();
+
+    return true;
+}
+// end of CTombstoneMaxMinHeap::Remove()
+
+
+// ==== CTombstoneMaxMinHeap::PeekTop =========================================
+//
+// This function peeks the top (live) element.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType>
+HeapItemType CTombstoneMaxMinHeap<HeapItemType>::PeekTop(void) const
+{
+    if (ListType::IsEmpty())
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return ListType::GetItemArray()[0].m_item;
+}
+// end of CTombstoneMaxMinHeap::PeekTop()
+
+
+// ==== CTombstoneMaxMinHeap::MarkDeleted =====================================
+//
+// This function turns the element of a handle into a tombstone in O(1). A
+// tombstone at the top is dropped at once, and reaching the compaction
+// fraction compacts the array.
+//
+// Input:
+//      handle  -- [IN]: a handle returned by Insert
+//
+// Output:
+//      bool    -- [OUT]: false if the handle is stale or already deleted
+// ============================================================================
+template <class HeapItemType>
+bool CTombstoneMaxMinHeap<HeapItemType>::MarkDeleted(CHeapHandle handle)
+{
+    if (!IsLive(handle))
+    {
+        return false;
+    }
+
+    m_deleted[static_cast<uint32_t>(handle)] = 1;
+    m_numDeleted++;
+    CompactIfNeeded();
+
+    return true;
+}
+// end of CTombstoneMaxMinHeap::MarkDeleted()
+
+
+// ==== CTombstoneMaxMinHeap::MarkDeletedIf ===================================
+//
+// This function turns every live element for which the predicate returns
+// true into a tombstone, in one pass over the array.
+//
+// Input:
+//      deleteItem  -- [IN]: a function object taking a const HeapItemType&
+//
+// Output:
+//      int         -- [OUT]: the number of elements deleted
+// ============================================================================
+template <class HeapItemType>
+template <class Predicate>
+int CTombstoneMaxMinHeap<HeapItemType>::MarkDeletedIf(Predicate deleteItem)
+{
+    const EntryType *entries = ListType::GetItemArray();
+    int numItems = ListType::GetNumItems();
+    int numMarked = 0;
+
+    for (int index = 0; index < numItems; ++index)
+    {
+        uint32_t slot = entries[index].m_slot;
+
+        if (!m_deleted[slot] && deleteItem(entries[index].m_item))
+        {
+            m_deleted[slot] = 1;
+            numMarked++;
+        }
+    }
+
+    m_numDeleted += numMarked;
+    CompactIfNeeded();
+
+    return numMarked;
+}
+// end of CTombstoneMaxMinHeap::MarkDeletedIf()
+
+
+// ==== CTombstoneMaxMinHeap::IsLive ==========================================
+//
+// This function returns true if the element of a handle is still in the
+// heap and not deleted.
+//
+// Input:
+//      handle  -- [IN]: a handle returned by Insert
+//
+// Output:
+//      bool    -- [OUT]: true when the element is live
+// ============================================================================
+template <class HeapItemType>
+bool CTombstoneMaxMinHeap<HeapItemType>::IsLive(CHeapHandle handle) const noexcept
+{
+    uint32_t slot = static_cast<uint32_t>(handle);
+
+    return ((slot < m_generations.size())
+            && (m_generations[slot] == static_cast<uint32_t>(handle >> 32))
+            && !m_deleted[slot]);
+}
+// end of CTombstoneMaxMinHeap::IsLive()
+
+
+// ==== CTombstoneMaxMinHeap::GetHeapType =====================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType>
+int CTombstoneMaxMinHeap<HeapItemType>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of CTombstoneMaxMinHeap::GetHeapType()
+
+
+// ==== CTombstoneMaxMinHeap::GetNumItems =====================================
+//
+// This function returns the number of live elements.
+// ============================================================================
+template <class HeapItemType>
+int CTombstoneMaxMinHeap<HeapItemType>::GetNumItems(void) const
+{
+    return ListType::GetNumItems() - m_numDeleted;
+}
+// end of CTombstoneMaxMinHeap::GetNumItems()
+
+
+// ==== CTombstoneMaxMinHeap::GetNumDeleted ===================================
+//
+// This function returns the number of tombstones still in the array.
+// ============================================================================
+template <class HeapItemType>
+int CTombstoneMaxMinHeap<HeapItemType>::GetNumDeleted(void) const
+{
+    return m_numDeleted;
+}
+// end of CTombstoneMaxMinHeap::GetNumDeleted()
+
+
+// ==== CTombstoneMaxMinHeap::IsEmpty =========================================
+//
+// This function returns a boolean value if there is no live element.
+// ============================================================================
+template <class HeapItemType>
+bool CTombstoneMaxMinHeap<HeapItemType>::IsEmpty(void) const
+{
+    return ListType::IsEmpty();
+}
+// end of CTombstoneMaxMinHeap::IsEmpty()
+
+#endif // CTOMBSTONEMAXMINHEAP_H
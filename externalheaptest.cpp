@@ -0,0 +1,408 @@
+// ============================================================================
+// File: externalheaptest.cpp
+// ============================================================================
+// This is a driver that checks CExternalMaxMinHeap against an in-memory
+// reference, with an insertion heap and run buffers small enough that the
+// items go through many spills and merges, and benchmarks it on disk.
+//
+//      externalheaptest [runDirectory]
+//              runs every check with its run files in runDirectory (the
+//              current directory by default); prints the failures and
+//              exits with 1 if there are any
+//      externalheaptest --bench <runDirectory> <numItems> [memoryItems]
+//              inserts numItems random 8-byte items, drains them and
+//              reports the time and the bytes written for each phase
+// ============================================================================
+
+#include    <iostream>
+#include    <iomanip>
+#include    <algorithm>
+#include    <chrono>
+#include    <cstdint>
+#include    <cstdlib>
+#include    <cstring>
+#include    <fstream>
+#include    <functional>
+#include    <random>
+#include    <set>
+#include    <string>
+#include    <vector>
+#include    <signal.h>
+#include    <sys/resource.h>
+using namespace std;
+#include    "cexternalmaxminheap.h"
+
+// constants
+const   int     SMALL_MEMORY_ITEMS = 100;   // insertion heap of the checks
+const   int     SMALL_BUFFER_ITEMS = 16;    // run buffer of the checks
+const   int     SMALL_MAX_RUNS = 4;         // runs before a merge
+const   int     NUM_CHECK_ITEMS = 20000;
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== TakeBest ==============================================================
+//
+// This function removes and returns the best item of a reference multiset.
+//
+// Input:
+//      reference   -- [IN/OUT]: the items the heap should hold
+//      heapType    -- [IN]: MAX or MIN
+//
+// Output:
+//      int -- [OUT]: the best item
+// ============================================================================
+int     TakeBest(multiset<int> &reference, int heapType)
+{
+    multiset<int>::iterator best = (heapType == MAX) ? prev(reference.end())
+                                                     : reference.begin();
+    int item = *best;
+
+    reference.erase(best);
+    return item;
+}
+// end of TakeBest()
+
+
+// ==== CheckAgainstReference =================================================
+//
+// This function mixes inserts and removes on a heap that spills every
+// SMALL_MEMORY_ITEMS items and merges runs often, and checks every removed
+// item, the peeked top, the item count and the open run limit.
+//
+// Input:
+//      runDirectory    -- [IN]: where the run files go
+//      heapType        -- [IN]: MAX or MIN
+//      removeEvery     -- [IN]: one remove after this many inserts
+//      random          -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckAgainstReference(const string &runDirectory, int heapType,
+                              int removeEvery, mt19937 &random)
+{
+    CExternalMaxMinHeap<int>    heap(runDirectory.c_str(), heapType,
+                                     SMALL_MEMORY_ITEMS, SMALL_BUFFER_ITEMS,
+                                     SMALL_MAX_RUNS);
+    multiset<int>               reference;
+    bool                        matches = true;
+    bool                        withinRuns = true;
+    int                         item;
+
+    for (int index = 0; index < NUM_CHECK_ITEMS; ++index)
+    {
+        int newItem = static_cast<int>(random() % 5000);
+
+        heap.Insert(newItem);
+        reference.insert(newItem);
+        withinRuns = withinRuns && (heap.GetNumRuns() <= SMALL_MAX_RUNS);
+
+        if (index % removeEvery == 0)
+        {
+            int top = heap.PeekTop();
+            heap.Remove(item);
+            matches = matches && (item == top)
+                      && (item == TakeBest(reference, heapType));
+        }
+    }
+    Check(withinRuns, "the heap keeps at most maxRuns runs open");
+    Check(heap.GetNumItems() == static_cast<long long>(reference.size()),
+          "the heap counts the items in memory and on disk");
+
+    while (!heap.IsEmpty() && !reference.empty())
+    {
+        int top = heap.PeekTop();
+        heap.Remove(item);
+        matches = matches && (item == top)
+                  && (item == TakeBest(reference, heapType));
+    }
+    Check(matches, "the heap removes the items in priority order");
+    Check(heap.IsEmpty() && reference.empty() && (heap.GetNumRuns() == 0),
+          "the heap drains every item and closes its runs");
+}
+// end of CheckAgainstReference()
+
+
+// ==== CheckRefill ===========================================================
+//
+// This function drains the heap down to a few items and fills it again, so
+// that new runs are added while old runs still have items left.
+//
+// Input:
+//      runDirectory    -- [IN]: where the run files go
+//      random          -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckRefill(const string &runDirectory, mt19937 &random)
+{
+    CExternalMaxMinHeap<int>    heap(runDirectory.c_str(), MIN,
+                                     SMALL_MEMORY_ITEMS, SMALL_BUFFER_ITEMS,
+                                     SMALL_MAX_RUNS);
+    multiset<int>               reference;
+    bool                        matches = true;
+    int                         item;
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int index = 0; index < 2000; ++index)
+        {
+            int newItem = static_cast<int>(random() % 100000);
+            heap.Insert(newItem);
+            reference.insert(newItem);
+        }
+        while (reference.size() > static_cast<size_t>(round))
+        {
+            heap.Remove(item);
+            matches = matches && (item == TakeBest(reference, MIN));
+        }
+    }
+    Check(matches, "a heap refilled between drains stays in order");
+    Check(heap.GetNumItems() == static_cast<long long>(reference.size()),
+          "a refilled heap keeps its count");
+}
+// end of CheckRefill()
+
+
+// ==== CheckDiskErrors =======================================================
+//
+// This function limits the size of the files the process may write, so that
+// spills and merges fail part way, and checks that every failed insert
+// throws EXTERNAL_HEAP_IO_ERROR and loses none of the items already in.
+//
+// Input:
+//      runDirectory    -- [IN]: where the run files go
+//      random          -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckDiskErrors(const string &runDirectory, mt19937 &random)
+{
+    CExternalMaxMinHeap<int>    heap(runDirectory.c_str(), MAX, 1000, 64, 3);
+    multiset<int>               reference;
+    struct rlimit               oldLimit;
+    struct rlimit               fileLimit;
+    int                         numFailures = 0;
+    bool                        rightErrors = true;
+    bool                        counted = true;
+    int                         item;
+
+    // room for a spilled run, not for a merge of three of them
+    signal(SIGXFSZ, SIG_IGN);
+    getrlimit(RLIMIT_FSIZE, &oldLimit);
+    fileLimit = oldLimit;
+    fileLimit.rlim_cur = 6000;
+    setrlimit(RLIMIT_FSIZE, &fileLimit);
+
+    for (int index = 0; (index < NUM_CHECK_ITEMS) && (numFailures < 20); ++index)
+    {
+        int newItem = static_cast<int>(random() % 100000);
+
+        try
+        {
+            heap.Insert(newItem);
+            reference.insert(newItem);
+        }
+        catch (CExternalHeapException &exceptObj)
+        {
+            rightErrors = rightErrors
+                          && (exceptObj.GetException() == EXTERNAL_HEAP_IO_ERROR);
+            ++numFailures;
+        }
+        counted = counted
+                  && (heap.GetNumItems() == static_cast<long long>(reference.size()));
+    }
+    setrlimit(RLIMIT_FSIZE, &oldLimit);
+
+    Check(numFailures > 0, "a full disk makes inserts fail");
+    Check(rightErrors, "a full disk throws EXTERNAL_HEAP_IO_ERROR");
+    Check(counted, "a failed insert leaves the count alone");
+
+    bool matches = true;
+    while (!heap.IsEmpty() && !reference.empty())
+    {
+        heap.Remove(item);
+        matches = matches && (item == TakeBest(reference, MAX));
+    }
+    Check(matches && heap.IsEmpty() && reference.empty(),
+          "a failed spill or merge loses no item");
+}
+// end of CheckDiskErrors()
+
+
+// ==== GetBytesWritten =======================================================
+//
+// This function returns how many bytes the process has written so far, from
+// /proc/self/io where there is one.
+//
+// Input:
+//      void
+//
+// Output:
+//      long long -- [OUT]: the bytes written, -1 if they are not known
+// ============================================================================
+long long   GetBytesWritten(void)
+{
+    ifstream    ioFile("/proc/self/io");
+    string      name;
+    long long   value;
+
+    while (ioFile >> name >> value)
+    {
+        if (name == "wchar:")
+        {
+            return value;
+        }
+    }
+
+    return -1;
+}
+// end of GetBytesWritten()
+
+
+// ==== RunBenchmark ==========================================================
+//
+// This function fills a heap with numItems random 8-byte items and drains
+// it, and reports the throughput and the bytes written per item of each
+// phase. With numItems ten times memoryItems, nine tenths of the items go
+// through the run files.
+//
+// Input:
+//      runDirectory    -- [IN]: where the run files go
+//      numItems        -- [IN]: the number of items
+//      memoryItems     -- [IN]: the insertion heap size
+//
+// Output:
+//      int -- [OUT]: 0 if the drain came out in order, 1 otherwise
+// ============================================================================
+int     RunBenchmark(const string &runDirectory, long long numItems,
+                     int memoryItems)
+{
+    typedef chrono::steady_clock    Clock;
+
+    CExternalMaxMinHeap<uint64_t>   heap(runDirectory.c_str(), MIN, memoryItems);
+    mt19937_64                      random(12345);
+    uint64_t                        item;
+    uint64_t                        previous = 0;
+    bool                            inOrder = true;
+    int                             maxRuns = 0;
+
+    long long   startBytes = GetBytesWritten();
+    Clock::time_point start = Clock::now();
+    for (long long index = 0; index < numItems; ++index)
+    {
+        heap.Insert(random());
+        maxRuns = max(maxRuns, heap.GetNumRuns());
+    }
+    Clock::time_point filled = Clock::now();
+    long long   filledBytes = GetBytesWritten();
+
+    while (!heap.IsEmpty())
+    {
+        heap.Remove(item);
+        inOrder = inOrder && (item >= previous);
+        previous = item;
+    }
+    Clock::time_point drained = Clock::now();
+    long long   drainedBytes = GetBytesWritten();
+
+    double  insertSeconds = chrono::duration<double>(filled - start).count();
+    double  removeSeconds = chrono::duration<double>(drained - filled).count();
+    double  megabytes = numItems * sizeof(uint64_t) / 1e6;
+
+    cout << fixed << setprecision(2)
+         << numItems << " items (" << megabytes << " MB), "
+         << memoryItems << " in memory, at most " << maxRuns << " runs" << endl
+         << "insert: " << insertSeconds << " s, "
+         << megabytes / insertSeconds << " MB/s" << endl
+         << "remove: " << removeSeconds << " s, "
+         << megabytes / removeSeconds << " MB/s" << endl;
+    if (startBytes >= 0)
+    {
+        cout << "written per item: "
+             << static_cast<double>(filledBytes - startBytes)
+                / (numItems * sizeof(uint64_t)) << " while inserting, "
+             << static_cast<double>(drainedBytes - filledBytes)
+                / (numItems * sizeof(uint64_t)) << " while removing" << endl;
+    }
+
+    if (!inOrder)
+    {
+        cout << "FAILED: the drain is out of order" << endl;
+        return 1;
+    }
+    return 0;
+}
+// end of RunBenchmark()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      argc, argv  -- [IN]: the run directory, or --bench and its arguments
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(int argc, char *argv[])
+{
+    if ((argc > 1) && (strcmp(argv[1], "--bench") == 0))
+    {
+        if (argc < 4)
+        {
+            cout << "usage: " << argv[0]
+                 << " --bench <runDirectory> <numItems> [memoryItems]" << endl;
+            return 1;
+        }
+        return RunBenchmark(argv[2], atoll(argv[3]),
+                            (argc > 4) ? atoi(argv[4])
+                                       : EXTERNAL_HEAP_MEMORY_ITEMS);
+    }
+
+    string  runDirectory = (argc > 1) ? argv[1] : ".";
+    mt19937 random(7);
+
+    CheckAgainstReference(runDirectory, MAX, 7, random);
+    CheckAgainstReference(runDirectory, MIN, 7, random);
+    CheckAgainstReference(runDirectory, MIN, 2, random);
+    CheckRefill(runDirectory, random);
+    CheckDiskErrors(runDirectory, random);
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all external heap checks passed" << endl;
+    return 0;
+}
+// end of main()
@@ -0,0 +1,149 @@
+// ============================================================================
+// File: heapkey.h
+// ============================================================================
+// Header file for the key functions shared by the heap classes that need the
+// priority of an element rather than the element itself, and for the key
+// projections a CMaxMinHeap can order its elements by.
+//
+// A projection (KeyOf) is a default constructible function object that maps
+// an element to the key the heap compares, so that a compare touches only
+// the key. CHeapIdentityKey, the default, compares whole elements with their
+// own operator< and operator>.
+//
+//      CMaxMinHeap<PersonInfo<int>, CImplicitHeapLayout,
+//                  CHeapMemberKey<&PersonInfo<int>::m_priority>>  byPriority;
+//
+// An arithmetic key also lets HEAP_BRANCHLESS_SIFT take its branchless path
+// for record types without a CHeapBranchlessItem specialization.
+//
+// Requires C++17, the minimum of the whole library (see clist.h):
+// CHeapMemberKey takes its pointer to member as a template <auto> parameter.
+// heapsift.h includes this file, so the check below also covers the heaps
+// that use the sift kernels without CList.
+// ============================================================================
+#ifndef HEAPKEY_H
+#define HEAPKEY_H
+
+#if (__cplusplus < 201703L) && !(defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#error "the heap headers require C++17 (compile with -std=c++17 or later)"
+#endif
+
+#include    <cstdint>
+#include    <type_traits>
+
+
+// ==== CDefaultPriorityOf ====================================================
+//
+// Returns the priority of an element: the m_priority member of a record such
+// as PersonInfo, or the value itself for arithmetic element types.
+//
+// ============================================================================
+struct  CDefaultPriorityOf
+{
+    template <class ItemType>
+    auto operator()(const ItemType &item) const -> decltype(item.m_priority)
+    {
+        return item.m_priority;
+    }
+
+    template <class ItemType,
+              typename std::enable_if<std::is_arithmetic<ItemType>::value,
+                                      int>::type = 0>
+    ItemType operator()(const ItemType &item) const
+    {
+        return item;
+    }
+};
+
+
+// ==== CHeapIdentityKey ======================================================
+//
+// The default projection: the element itself.
+//
+// ============================================================================
+struct  CHeapIdentityKey
+{
+    template <class ItemType>
+    constexpr const ItemType& operator()(const ItemType &item) const
+    {
+        return item;
+    }
+};
+
+
+// ==== CHeapMemberKey ========================================================
+//
+// Projects a data member, given as a pointer to member:
+// CHeapMemberKey<&PersonInfo<int>::m_priority>. The template <auto>
+// parameter, which deduces the class and member type, is C++17.
+//
+// ============================================================================
+template <auto Member>
+struct  CHeapMemberKey
+{
+    template <class ItemType>
+    constexpr auto operator()(const ItemType &item) const -> decltype(item.*Member)
+    {
+        return item.*Member;
+    }
+};
+
+
+// ==== HeapPackKey ===========================================================
+//
+// This function packs two keys into one unsigned 64 bit key that compares
+// the way the pair (high, low) does: high fills the upper 64 - LowBits bits
+// and low the lower LowBits bits. A signed high is offset by 2^(63 - LowBits)
+// so that negative values order below positive ones. Bits of high or low
+// that do not fit are lost.
+//
+// Input:
+//      high    -- [IN]: the major key, e.g. a priority
+//      low     -- [IN]: the minor key, e.g. a sequence number
+//
+// Output:
+//      uint64_t -- [OUT]: the packed key
+// ============================================================================
+template <int LowBits, class HighType, class LowType>
+constexpr uint64_t HeapPackKey(HighType high, LowType low)
+{
+    static_assert(LowBits > 0 && LowBits < 64,
+                  "HeapPackKey needs 1 to 63 low bits");
+
+    uint64_t lowMask = (static_cast<uint64_t>(1) << LowBits) - 1;
+    uint64_t packedHigh = static_cast<uint64_t>(high);
+
+    if (std::is_signed<HighType>::value)
+    {
+        packedHigh += static_cast<uint64_t>(1) << (63 - LowBits);
+    }
+
+    return (packedHigh << LowBits) | (static_cast<uint64_t>(low) & lowMask);
+}
+// end of HeapPackKey()
+
+
+// ==== CHeapPackedKey ========================================================
+//
+// Projects a composite key packed by HeapPackKey from two projections.
+// With InvertLow the low key is stored as its complement, so that the
+// smaller low key wins ties in a MAX heap: priority first, then FIFO by
+// sequence number, as one integer compare.
+//
+//      CHeapPackedKey<CHeapMemberKey<&Job::m_priority>,
+//                     CHeapMemberKey<&Job::m_sequence>, 40, true>
+//
+// ============================================================================
+template <class HighKeyOf, class LowKeyOf, int LowBits, bool InvertLow = false>
+struct  CHeapPackedKey
+{
+    template <class ItemType>
+    constexpr uint64_t operator()(const ItemType &item) const
+    {
+        uint64_t low = static_cast<uint64_t>(LowKeyOf()(item));
+
+        return HeapPackKey<LowBits>(HighKeyOf()(item), InvertLow ? ~low : low);
+    }
+};
+
+#endif // HEAPKEY_H
@@ -0,0 +1,142 @@
+// ============================================================================
+// File: heaplayout.h
+// ============================================================================
+// Header file for the heap layout policies: the mapping between a node and
+// the array indices of its parent and children.
+//
+// A layout is a class with two static functions,
+//
+//      int  GetParentIndex(int childIndex);
+//      void GetChildIndices(int parentIndex, int &leftIndex, int &rightIndex);
+//
+// over the indices 0 .. numItems - 1, with the root at index 0 and every
+// parent at a smaller index than its children. A node with a single child
+// reports it as both leftIndex and rightIndex. Indices past INT_MAX are
+// reported as INT_MAX, which is never a valid item.
+// ============================================================================
+#ifndef HEAPLAYOUT_H
+#define HEAPLAYOUT_H
+
+#include    <climits>
+
+
+// ==== CImplicitHeapLayout ===================================================
+//
+// The classic implicit binary heap: the children of node i are 2i+1 and
+// 2i+2. A root-to-leaf path touches a new page on every level once the heap
+// is a few pages deep.
+//
+// ============================================================================
+struct  CImplicitHeapLayout
+{
+    static constexpr int GetParentIndex(int childIndex)
+    {
+        return (childIndex - 1) / 2;
+    }
+
+    static constexpr void GetChildIndices(int parentIndex, int &leftIndex,
+                                          int &rightIndex)
+    {
+        leftIndex = parentIndex * 2 + 1;
+        rightIndex = leftIndex + 1;
+    }
+};
+
+
+// ==== CBHeapLayout ==========================================================
+//
+// The B-heap of P.-H. Kamp ("You're Doing It Wrong", ACM Queue 2010), with
+// the index arithmetic of Varnish's binheap.c. The array is cut into pages
+// of 2^PageShift items and every page holds a complete subtree, so a sift
+// changes page only once per PageShift - 1 levels: a root-to-leaf path
+// touches about log_B(n) pages instead of log2(n).
+//
+// Pick PageShift so that 2^PageShift items fill one virtual memory page,
+// for example 10 for 4-byte items on 4 KB pages. Varnish numbers the root 1;
+// the functions below shift its formulas down by one so that the root is
+// index 0, as in every other heap of this library. Page p then holds the
+// indices p * 2^PageShift - 1 up to (p + 1) * 2^PageShift - 2, so the
+// array must keep Varnish's unused slot 0 in front of index 0 and start
+// that slot on a page boundary for B-heap pages to be VM pages.
+// CMaxMinHeap does this with CListPageStorage (clist.h); other storage
+// keeps the index order but not the page property.
+//
+// ============================================================================
+template <int PageShift = 10>
+struct  CBHeapLayout
+{
+    static_assert(PageShift >= 2 && PageShift < 30,
+                  "CBHeapLayout pages hold 4 to 2^29 items");
+
+    static const unsigned PAGE_SIZE = 1u << PageShift;
+    static const unsigned PAGE_MASK = PAGE_SIZE - 1;
+
+    static constexpr int GetParentIndex(int childIndex)
+    {
+        unsigned u = static_cast<unsigned>(childIndex) + 1;
+        unsigned pageOffset = u & PAGE_MASK;
+        unsigned v = 0;
+
+        if ((u < PAGE_SIZE) || (pageOffset > 3))
+        {
+            // same page, ordinary binary heap inside it
+            v = (u & ~PAGE_MASK) | (pageOffset >> 1);
+        }
+        else if (pageOffset < 2)
+        {
+            // page root pair: the parent is in the bottom row of an
+            // earlier page
+            v = (u - PAGE_SIZE) >> PageShift;
+            v += v & ~(PAGE_MASK >> 1);
+            v |= PAGE_SIZE / 2;
+        }
+        else
+        {
+            // the single children of the page root pair
+            v = u - 2;
+        }
+
+        return static_cast<int>(v) - 1;
+    }
+
+    static constexpr void GetChildIndices(int parentIndex, int &leftIndex,
+                                          int &rightIndex)
+    {
+        unsigned u = static_cast<unsigned>(parentIndex) + 1;
+        unsigned long long a = 0;
+
+        if ((u > PAGE_MASK) && ((u & (PAGE_MASK - 1)) == 0))
+        {
+            // page root pair: each has a single child
+            a = u + 2;
+            leftIndex = rightIndex = ToIndex(a);
+            return;
+        }
+        else if (u & (PAGE_SIZE >> 1))
+        {
+            // bottom row of a page: the children start a new page
+            a = (u & ~PAGE_MASK) >> 1;
+            a |= u & (PAGE_MASK >> 1);
+            a += 1;
+            a <<= PageShift;
+        }
+        else
+        {
+            // ordinary binary heap inside the page
+            a = u + (u & PAGE_MASK);
+        }
+
+        leftIndex = ToIndex(a);
+        rightIndex = ToIndex(a + 1);
+    }
+
+private:
+    // 1-based Varnish index to 0-based array index, saturated at INT_MAX
+    static constexpr int ToIndex(unsigned long long u)
+    {
+        return (u - 1 >= static_cast<unsigned long long>(INT_MAX))
+               ? INT_MAX : static_cast<int>(u - 1);
+    }
+};
+
+#endif // HEAPLAYOUT_H
@@ -0,0 +1,360 @@
+// ============================================================================
+// File: heappopntest.cpp
+// ============================================================================
+// This is a driver that checks CMaxMinHeap::PopN (and with it HeapPopN)
+// against repeated Remove calls on a twin heap: MAX and MIN heaps, the
+// implicit and B-heap layouts, a keyed heap and string items, with every
+// count from -1 to n + 3 on small heaps and sampled counts on large ones,
+// and an output iterator that throws part way through a batch.
+//
+//      heappopntest [seed]
+//              runs every check; prints the failures and exits with 1 if
+//              there are any
+// ============================================================================
+
+#include    <iostream>
+#include    <cstdlib>
+#include    <iterator>
+#include    <random>
+#include    <stdexcept>
+#include    <string>
+#include    <vector>
+using namespace std;
+#include    "cmaxminheap.h"
+#include    "heapkey.h"
+#include    "heaplayout.h"
+
+// constants
+const   int     MAX_FULL_RANGE = 40;    // heaps up to this size try every count
+const   int     HEAP_SIZES[] = { 0, 1, 2, 3, 7, 8, 9, 33, 40, 100, 1000, 5000 };
+
+// a record ordered by one member through CHeapMemberKey
+struct  CKeyedRecord
+{
+    int     m_key;
+    int     m_serial;
+};
+
+// an output iterator that throws when asked to take its limit-th item
+class   CThrowingOutput
+{
+public:
+    typedef output_iterator_tag         iterator_category;
+    typedef void                        value_type;
+    typedef void                        difference_type;
+    typedef void                        pointer;
+    typedef void                        reference;
+
+    CThrowingOutput(vector<string> *taken, int limit)
+    : m_taken(taken), m_limit(limit) {}
+
+    CThrowingOutput &operator*(void) { return *this; }
+    CThrowingOutput &operator++(void) { return *this; }
+    CThrowingOutput &operator++(int) { return *this; }
+    CThrowingOutput &operator=(const string &item)
+    {
+        if (static_cast<int>(m_taken->size()) + 1 >= m_limit)
+        {
+            throw runtime_error("output full");
+        }
+        m_taken->push_back(item);
+        return *this;
+    }
+
+private:
+    vector<string> *m_taken;
+    int             m_limit;
+};
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== RandomInt / RandomString ==============================================
+//
+// These functions make random items, with plenty of duplicates.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      the new item
+// ============================================================================
+int     RandomInt(mt19937 &random)
+{
+    return static_cast<int>(random() % 1000);
+}
+
+string  RandomString(mt19937 &random)
+{
+    return to_string(random() % 100000);
+}
+// end of RandomInt() / RandomString()
+
+
+// ==== CheckAgainstRemove ====================================================
+//
+// This function fills two heaps with the same items, pops count items from
+// one with PopN and from the other with Remove, and checks that both give
+// the same items in the same order and that the rest still drains alike.
+//
+// Input:
+//      heapType    -- [IN]: MAX or MIN
+//      numItems    -- [IN]: the number of items in the heaps
+//      count       -- [IN]: the count passed to PopN
+//      random      -- [IN/OUT]: the random generator
+//      makeItem    -- [IN]: the item generator
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapType, class ItemType>
+void    CheckAgainstRemove(int heapType, int numItems, int count, mt19937 &random,
+                           ItemType (*makeItem)(mt19937 &))
+{
+    HeapType            batchHeap(heapType);
+    HeapType            referenceHeap(heapType);
+    vector<ItemType>    popped;
+    ItemType            batchItem;
+    ItemType            referenceItem;
+    int                 numExpected = (count < 0) ? 0
+                                      : (count < numItems) ? count : numItems;
+
+    for (int index = 0; index < numItems; ++index)
+    {
+        ItemType item = makeItem(random);
+        batchHeap.Insert(item);
+        referenceHeap.Insert(item);
+    }
+
+    int numPopped = batchHeap.PopN(count, back_inserter(popped));
+    if (!Check((numPopped == numExpected)
+               && (static_cast<int>(popped.size()) == numExpected)
+               && (batchHeap.GetNumItems() == numItems - numExpected),
+               "PopN returns min(count, n) items"))
+    {
+        return;
+    }
+
+    for (const ItemType &item : popped)
+    {
+        referenceHeap.Remove(referenceItem);
+        if (!Check(!(item < referenceItem) && !(referenceItem < item),
+                   "PopN matches repeated Remove"))
+        {
+            return;
+        }
+    }
+    while (!batchHeap.IsEmpty())
+    {
+        batchHeap.Remove(batchItem);
+        referenceHeap.Remove(referenceItem);
+        if (!Check(!(batchItem < referenceItem) && !(referenceItem < batchItem),
+                   "the heap left by PopN drains like the reference"))
+        {
+            return;
+        }
+    }
+    Check(referenceHeap.IsEmpty(), "PopN loses no item");
+}
+// end of CheckAgainstRemove()
+
+
+// ==== CheckAllCounts ========================================================
+//
+// This function runs CheckAgainstRemove for one heap type over every heap
+// size, both heap orders, and every count (small heaps) or the counts
+// around the selection threshold and the ends (large heaps).
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//      makeItem    -- [IN]: the item generator
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapType, class ItemType>
+void    CheckAllCounts(mt19937 &random, ItemType (*makeItem)(mt19937 &))
+{
+    for (int numItems : HEAP_SIZES)
+    {
+        vector<int> counts;
+
+        if (numItems <= MAX_FULL_RANGE)
+        {
+            for (int count = -1; count <= numItems + 3; ++count)
+            {
+                counts.push_back(count);
+            }
+        }
+        else
+        {
+            int threshold = numItems / HEAP_POPN_SELECT_RATIO;
+            int sampled[] = { -1, 0, 1, 2, 5, threshold - 1, threshold,
+                              threshold + 1, numItems - 1, numItems,
+                              numItems + 3 };
+            counts.assign(sampled, sampled + sizeof(sampled) / sizeof(sampled[0]));
+        }
+
+        for (int count : counts)
+        {
+            CheckAgainstRemove<HeapType>(MAX, numItems, count, random, makeItem);
+            CheckAgainstRemove<HeapType>(MIN, numItems, count, random, makeItem);
+        }
+    }
+}
+// end of CheckAllCounts()
+
+
+// ==== CheckKeyedHeap ========================================================
+//
+// This function pops from a heap ordered by a member key and checks the
+// batch is in key order and ahead of what is left.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckKeyedHeap(mt19937 &random)
+{
+    CMaxMinHeap<CKeyedRecord, CImplicitHeapLayout,
+                CHeapMemberKey<&CKeyedRecord::m_key>>   heap(MIN);
+    vector<CKeyedRecord>                                popped;
+
+    for (int serial = 0; serial < 1000; ++serial)
+    {
+        CKeyedRecord record = { static_cast<int>(random() % 500), serial };
+        heap.Insert(record);
+    }
+
+    for (int count : { 30, 600 })
+    {
+        popped.clear();
+        heap.PopN(count, back_inserter(popped));
+
+        bool inOrder = true;
+        for (size_t index = 1; index < popped.size(); ++index)
+        {
+            inOrder = inOrder && (popped[index - 1].m_key <= popped[index].m_key);
+        }
+        Check(inOrder, "a keyed PopN is in key order");
+        Check(heap.IsEmpty() || (heap.PeekTop().m_key >= popped.back().m_key),
+              "a keyed PopN takes the best keys");
+    }
+    Check(heap.GetNumItems() == 1000 - 30 - 600, "a keyed PopN removes count items");
+}
+// end of CheckKeyedHeap()
+
+
+// ==== CheckThrowingOutput ==================================================
+//
+// This function pops a batch into an output iterator that throws on its
+// third item and checks the heap is left consistent: the batch is gone,
+// no empty moved-from string is left behind and the rest drains in order.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckThrowingOutput(mt19937 &random)
+{
+    for (int count : { 5, 60 })
+    {
+        CMaxMinHeap<string> heap(MIN);
+        vector<string>      taken;
+        bool                threw = false;
+
+        for (int index = 0; index < 100; ++index)
+        {
+            heap.Insert("item" + RandomString(random));
+        }
+
+        try
+        {
+            heap.PopN(count, CThrowingOutput(&taken, 3));
+        }
+        catch (const runtime_error &)
+        {
+            threw = true;
+        }
+        Check(threw && (taken.size() == 2), "a throwing output stops PopN");
+        Check(heap.GetNumItems() == 100 - count,
+              "a throwing output still removes the batch from the heap");
+
+        string  previous;
+        string  item;
+        bool    inOrder = true;
+        bool    noneEmpty = true;
+        int     numDrained = 0;
+        while (!heap.IsEmpty())
+        {
+            heap.Remove(item);
+            noneEmpty = noneEmpty && !item.empty();
+            inOrder = inOrder && ((numDrained == 0) || !(item < previous));
+            previous = item;
+            ++numDrained;
+        }
+        Check(noneEmpty, "a throwing output leaves no moved-from item");
+        Check(inOrder && (numDrained == 100 - count),
+              "the heap left by a throwing output drains in order");
+    }
+}
+// end of CheckThrowingOutput()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      argc, argv  -- [IN]: an optional random seed
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(int argc, char *argv[])
+{
+    mt19937 random((argc > 1) ? static_cast<unsigned>(atoi(argv[1])) : 7);
+
+    CheckAllCounts<CMaxMinHeap<int>>(random, RandomInt);
+    CheckAllCounts<CMaxMinHeap<string>>(random, RandomString);
+    CheckAllCounts<CMaxMinHeap<int, CBHeapLayout<4>>>(random, RandomInt);
+    CheckKeyedHeap(random);
+    CheckThrowingOutput(random);
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all PopN checks passed" << endl;
+    return 0;
+}
+// end of main()
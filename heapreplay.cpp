@@ -0,0 +1,215 @@
+// ============================================================================
+// File: heapreplay.cpp
+// ============================================================================
+// This is a driver that replays a heap operation trace (see heaptrace.h)
+// against the heap classes and reports throughput and latency percentiles.
+//
+//      heapreplay --generate <trace> <numOps>
+//              records a synthetic bursty workload to <trace>
+//      heapreplay <trace> [backend ...]
+//              replays <trace>; backends are implicit, bheap, segmented
+//              and small (all of them by default)
+// ============================================================================
+
+#include    <iostream>
+#include    <iomanip>
+#include    <cstdlib>
+#include    <random>
+#include    <string>
+#include    <vector>
+using namespace std;
+#include    "cmaxminheap.h"
+#include    "csegmentedmaxminheap.h"
+#include    "heaplayout.h"
+#include    "heaptrace.h"
+#include    "smallmaxminheap.h"
+
+// constants
+const   int     MAX_BURST = 64;         // inserts per burst, at most
+const   int     NUM_PERCENTILES = 5;
+const   double  PERCENTILES[NUM_PERCENTILES] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+const   char    *PERCENTILE_NAMES[NUM_PERCENTILES] = { "p50", "p90", "p99",
+                                                       "p99.9", "max" };
+const   char    *OP_NAMES[TRACE_NUM_OP_TYPES] = { "", "insert", "remove",
+                                                  "peek" };
+
+
+// ==== GenerateTrace =========================================================
+//
+// This function records a synthetic workload: bursts of inserts with skewed
+// keys, each followed by a partial drain with occasional peeks, the way a
+// scheduler sees arrivals.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//      numOps      -- [IN]: the number of operations to record
+//
+// Output:
+//      void
+// ============================================================================
+void    GenerateTrace(const string &fileName, long numOps)
+{
+    CHeapTraceWriter                        writer(fileName, MIN);
+    CTracingMaxMinHeap<long long>           heap(&writer, MIN);
+    mt19937_64                              random(12345);
+    uniform_int_distribution<int>           burstSize(1, MAX_BURST);
+    geometric_distribution<long long>       keySkew(0.001);
+    long long                               now = 0;
+    long long                               item;
+    long                                    numDone = 0;
+
+    while (numDone < numOps)
+    {
+        int numInserts = burstSize(random);
+        for (int index = 0; (index < numInserts) && (numDone < numOps); ++index)
+        {
+            heap.Insert(now + keySkew(random));
+            ++numDone;
+        }
+
+        int numRemoves = burstSize(random);
+        for (int index = 0; (index < numRemoves) && (numDone < numOps)
+                            && !heap.IsEmpty(); ++index)
+        {
+            if ((random() & 7) == 0)
+            {
+                heap.PeekTop();
+            }
+            else
+            {
+                heap.Remove(item);
+                now = item;
+            }
+            ++numDone;
+        }
+    }
+
+    writer.Flush();
+    cout << "wrote " << writer.GetNumRecords() << " records to " << fileName
+         << endl;
+}
+// end of GenerateTrace()
+
+
+// ==== ReportReplay ==========================================================
+//
+// This function replays the trace against one heap class and prints the
+// results.
+//
+// Input:
+//      name        -- [IN]: the backend's name
+//      records     -- [IN]: the trace
+//      heapType    -- [IN]: MAX or MIN
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapType>
+void    ReportReplay(const string &name,
+                     const vector<CHeapTraceRecord> &records, int heapType)
+{
+    HeapType            heap(heapType);
+    CHeapReplayStats    stats;
+
+    ReplayHeapTrace(records, heap, stats);
+
+    cout << name << ": " << fixed << setprecision(1)
+         << stats.GetNumOps() / stats.m_seconds / 1e6 << " Mops/s";
+    if (stats.m_numMismatches > 0)
+    {
+        cout << ", " << stats.m_numMismatches << " mismatches";
+    }
+    cout << endl;
+
+    for (int opType = TRACE_INSERT; opType < TRACE_NUM_OP_TYPES; ++opType)
+    {
+        if (stats.m_latencyNs[opType].empty())
+        {
+            continue;
+        }
+
+        cout << "    " << setw(6) << OP_NAMES[opType] << " ns:";
+        for (int index = 0; index < NUM_PERCENTILES; ++index)
+        {
+            cout << "  " << PERCENTILE_NAMES[index] << "="
+                 << stats.GetPercentile(opType, PERCENTILES[index]);
+        }
+        cout << endl;
+    }
+}
+// end of ReportReplay()
+
+
+// ==== main ==================================================================
+//
+// ============================================================================
+
+int     main(int argc, char *argv[])
+{
+    if ((argc == 4) && (string(argv[1]) == "--generate"))
+    {
+        GenerateTrace(argv[2], atol(argv[3]));
+        return EXIT_SUCCESS;
+    }
+
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0] << " --generate <trace> <numOps>" << endl
+             << "       " << argv[0] << " <trace> [implicit|bheap|segmented|small ...]"
+             << endl;
+        return EXIT_FAILURE;
+    }
+
+    vector<CHeapTraceRecord>    records;
+    int                         heapType;
+
+    try
+    {
+        heapType = LoadHeapTrace(argv[1], records);
+    }
+    catch (CHeapTraceException&)
+    {
+        cerr << "Error reading trace " << argv[1] << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << records.size() << " records, "
+         << (heapType == MAX ? "MAX" : "MIN") << " heap" << endl;
+
+    vector<string>  backends(argv + 2, argv + argc);
+    if (backends.empty())
+    {
+        backends = { "implicit", "bheap", "segmented", "small" };
+    }
+
+    for (const string &backend : backends)
+    {
+        if (backend == "implicit")
+        {
+            ReportReplay<CMaxMinHeap<long long>>(backend, records, heapType);
+        }
+        else if (backend == "bheap")
+        {
+            ReportReplay<CMaxMinHeap<long long, CBHeapLayout<>>>(backend,
+                                                                 records,
+                                                                 heapType);
+        }
+        else if (backend == "segmented")
+        {
+            ReportReplay<CSegmentedMaxMinHeap<long long>>(backend, records,
+                                                          heapType);
+        }
+        else if (backend == "small")
+        {
+            ReportReplay<SmallMaxMinHeap<long long>>(backend, records,
+                                                     heapType);
+        }
+        else
+        {
+            cerr << "unknown backend " << backend << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,712 @@
+// ============================================================================
+// File: heapsift.h
+// ============================================================================
+// Header file for the heap sift routines shared by the heap classes whose
+// storage does not live in a CList object.
+//
+// Every routine works on any random access item array (a raw pointer or a
+// small object with operator[]) and a "before" comparison object. The
+// comparison returns true when its first argument must sit closer to the
+// root than its second argument. The routines taking a layout argument walk
+// the tree through a heaplayout.h policy; the others, and the overloads for
+// CImplicitHeapLayout, use the implicit layout directly.
+// ============================================================================
+#ifndef HEAPSIFT_H
+#define HEAPSIFT_H
+
+#include    <algorithm>
+#include    <type_traits>
+#include    <utility>
+#include    "heapkey.h"
+#include    "heaplayout.h"
+
+// HEAP_CONSTEXPR marks the routines that can run at compile time. Under
+// C++20 they are constexpr, so a StaticMaxMinHeap can be filled and drained
+// in a constant expression; earlier standards compile them as before.
+#if __cplusplus >= 202002L
+#define HEAP_CONSTEXPR  constexpr
+#else
+#define HEAP_CONSTEXPR
+#endif
+
+// Define HEAP_PREFETCH to have HeapSiftDown prefetch the grandchildren of
+// each node it visits, one level ahead of the loads it is about to make.
+// It pays off once the heap no longer fits in the caches.
+
+
+// ==== CHeapMaxOrder =========================================================
+//
+// Comparison object for a max heap: larger items sit closer to the root.
+//
+// ============================================================================
+template <class HeapItemType>
+struct  CHeapMaxOrder
+{
+    HEAP_CONSTEXPR bool operator()(const HeapItemType &lhs,
+                                   const HeapItemType &rhs) const
+    {
+        return (lhs > rhs);
+    }
+};
+
+// ==== CHeapMinOrder =========================================================
+//
+// Comparison object for a min heap: smaller items sit closer to the root.
+//
+// ============================================================================
+template <class HeapItemType>
+struct  CHeapMinOrder
+{
+    HEAP_CONSTEXPR bool operator()(const HeapItemType &lhs,
+                                   const HeapItemType &rhs) const
+    {
+        return (lhs < rhs);
+    }
+};
+
+
+// ==== CHeapKeyMaxOrder ======================================================
+//
+// Comparison objects that compare the keys a projection (heapkey.h) takes
+// out of the items instead of the items themselves.
+//
+// ============================================================================
+template <class HeapItemType, class KeyOf>
+struct  CHeapKeyMaxOrder
+{
+    KeyOf   m_keyOf;
+
+    HEAP_CONSTEXPR bool operator()(const HeapItemType &lhs,
+                                   const HeapItemType &rhs) const
+    {
+        return (m_keyOf(lhs) > m_keyOf(rhs));
+    }
+};
+
+template <class HeapItemType, class KeyOf>
+struct  CHeapKeyMinOrder
+{
+    KeyOf   m_keyOf;
+
+    HEAP_CONSTEXPR bool operator()(const HeapItemType &lhs,
+                                   const HeapItemType &rhs) const
+    {
+        return (m_keyOf(lhs) < m_keyOf(rhs));
+    }
+};
+
+
+// ==== CHeapOrderOf ==========================================================
+//
+// The MAX and MIN comparison objects of a heap ordered by a projection. The
+// identity projection keeps CHeapMaxOrder and CHeapMinOrder, and with them
+// any CHeapBranchlessItem specialization of the item type.
+//
+// ============================================================================
+template <class HeapItemType, class KeyOf>
+struct  CHeapOrderOf
+{
+    typedef CHeapKeyMaxOrder<HeapItemType, KeyOf>   MaxOrder;
+    typedef CHeapKeyMinOrder<HeapItemType, KeyOf>   MinOrder;
+};
+
+template <class HeapItemType>
+struct  CHeapOrderOf<HeapItemType, CHeapIdentityKey>
+{
+    typedef CHeapMaxOrder<HeapItemType>     MaxOrder;
+    typedef CHeapMinOrder<HeapItemType>     MinOrder;
+};
+
+// ==== CHeapBranchlessItem ===================================================
+//
+// Trait marking the item types HeapSiftDownBranchless suits: true when
+// comparing two items is a single compare of an arithmetic key. Record types
+// ordered by such a key (PersonInfo and its m_priority, for instance)
+// specialize it next to their operators.
+//
+// When HEAP_BRANCHLESS_SIFT is defined, HeapSiftDown uses the branchless
+// kernel for CHeapMaxOrder and CHeapMinOrder on those types. It is opt-in:
+// on out-of-order cores with good branch prediction the speculative loads of
+// the plain loop hide more latency than the conditional moves save, and the
+// plain loop measured faster at every heap size, so profile before turning
+// it on.
+//
+// ============================================================================
+template <class HeapItemType>
+struct  CHeapBranchlessItem : std::is_arithmetic<HeapItemType>
+{
+};
+
+template <class Compare>
+struct  CHeapBranchlessOrder : std::false_type
+{
+};
+
+#if defined(HEAP_BRANCHLESS_SIFT)
+template <class HeapItemType>
+struct  CHeapBranchlessOrder<CHeapMaxOrder<HeapItemType> >
+      : CHeapBranchlessItem<HeapItemType>
+{
+};
+
+template <class HeapItemType>
+struct  CHeapBranchlessOrder<CHeapMinOrder<HeapItemType> >
+      : CHeapBranchlessItem<HeapItemType>
+{
+};
+
+template <class HeapItemType, class KeyOf>
+struct  CHeapBranchlessOrder<CHeapKeyMaxOrder<HeapItemType, KeyOf> >
+      : CHeapBranchlessItem<typename std::decay<decltype(
+                std::declval<KeyOf>()(std::declval<const HeapItemType&>()))>::type>
+{
+};
+
+template <class HeapItemType, class KeyOf>
+struct  CHeapBranchlessOrder<CHeapKeyMinOrder<HeapItemType, KeyOf> >
+      : CHeapBranchlessItem<typename std::decay<decltype(
+                std::declval<KeyOf>()(std::declval<const HeapItemType&>()))>::type>
+{
+};
+#endif
+
+
+// ==== HeapPrefetchGrandchildren =============================================
+//
+// This function prefetches the four grandchildren of a node (4i+3 to 4i+6)
+// when HEAP_PREFETCH is defined, and does nothing otherwise.
+//
+// Input:
+//      items       -- [IN]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      index       -- [IN]: the node's index
+//
+// Output:
+//      void
+// ============================================================================
+template <class ItemArray>
+HEAP_CONSTEXPR void HeapPrefetchGrandchildren(ItemArray items, int numItems,
+                                              int index)
+{
+#if defined(HEAP_PREFETCH) && (defined(__GNUC__) || defined(__clang__))
+#if __cplusplus >= 202002L
+    if (std::is_constant_evaluated())
+    {
+        return;
+    }
+#endif
+    int grandchildIndex = index * 4 + 3;
+
+    if (grandchildIndex < numItems)
+    {
+        __builtin_prefetch(&items[grandchildIndex]);
+    }
+    if (grandchildIndex + 3 < numItems)
+    {
+        __builtin_prefetch(&items[grandchildIndex + 3]);
+    }
+#else
+    (void)items;
+    (void)numItems;
+    (void)index;
+#endif
+}
+// end of HeapPrefetchGrandchildren()
+
+
+// ==== HeapSiftUp ============================================================
+//
+// This function moves the item at index towards the root until its parent
+// no longer has to come before it. The item is held aside while the parents
+// are shifted down, so each level costs one move instead of a full swap.
+//
+// Input:
+//      items   -- [IN/OUT]: the item array
+//      index   -- [IN]: the index of the item to move up
+//      before  -- [IN]: the comparison object
+//
+// Output:
+//      int     -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftUp(ItemArray items, int index, Compare before)
+{
+    auto item = std::move(items[index]);
+
+    while (index > 0)
+    {
+        int parentIndex = (index - 1) / 2;
+
+        if (!before(item, items[parentIndex]))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[parentIndex]);
+        index = parentIndex;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+// end of HeapSiftUp()
+
+
+// ==== HeapSiftDown ==========================================================
+//
+// This function moves the item at index towards the leaves until none of its
+// children has to come before it. Orders flagged by CHeapBranchlessOrder use
+// HeapSiftDownBranchless; every other order uses the plain loop below.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      index       -- [IN]: the index of the item to move down
+//      before      -- [IN]: the comparison object
+//
+// Output:
+//      int         -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDownSelect(ItemArray items, int numItems, int index,
+                                      Compare before, std::false_type)
+{
+    auto item = std::move(items[index]);
+
+    int childIndex = index * 2 + 1;
+    while (childIndex < numItems)
+    {
+        HeapPrefetchGrandchildren(items, numItems, index);
+
+        // pick the child that has to come first
+        if ((childIndex + 1 < numItems)
+            && before(items[childIndex + 1], items[childIndex]))
+        {
+            ++childIndex;
+        }
+
+        if (!before(items[childIndex], item))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[childIndex]);
+        index = childIndex;
+        childIndex = index * 2 + 1;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+// end of HeapSiftDown()
+
+
+// ==== HeapSiftDownBranchless ================================================
+//
+// This function is HeapSiftDown for cheap, unpredictable comparisons. It
+// first moves the hole at index all the way down to a leaf, always following
+// the child that has to come first; that choice is an index increment the
+// compiler turns into a conditional move, and the loop only exits on the
+// bounds test, so the descent has no data-dependent branch. The item then
+// climbs back from the leaf, which for an item taken from the bottom of the
+// heap (a pop) usually stops after a step or two.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      index       -- [IN]: the index of the item to move down
+//      before      -- [IN]: the comparison object
+//
+// Output:
+//      int         -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDownBranchless(ItemArray items, int numItems,
+                                          int index, Compare before)
+{
+    auto item = std::move(items[index]);
+    int rootIndex = index;
+
+    // descend while both children exist
+    int childIndex = index * 2 + 1;
+    while (childIndex + 1 < numItems)
+    {
+        HeapPrefetchGrandchildren(items, numItems, index);
+
+        childIndex += static_cast<int>(before(items[childIndex + 1],
+                                              items[childIndex]));
+        items[index] = std::move(items[childIndex]);
+        index = childIndex;
+        childIndex = index * 2 + 1;
+    }
+
+    // a last node with a single child
+    if (childIndex < numItems)
+    {
+        items[index] = std::move(items[childIndex]);
+        index = childIndex;
+    }
+
+    // climb back to the item's place
+    while (index > rootIndex)
+    {
+        int parentIndex = (index - 1) / 2;
+
+        if (!before(item, items[parentIndex]))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[parentIndex]);
+        index = parentIndex;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+// end of HeapSiftDownBranchless()
+
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDownSelect(ItemArray items, int numItems, int index,
+                                      Compare before, std::true_type)
+{
+    return HeapSiftDownBranchless(items, numItems, index, before);
+}
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDown(ItemArray items, int numItems, int index,
+                                Compare before)
+{
+    return HeapSiftDownSelect(items, numItems, index, before,
+                              std::integral_constant<bool,
+                                  CHeapBranchlessOrder<Compare>::value>());
+}
+// end of HeapSiftDown()
+
+
+// ==== HeapBuild =============================================================
+//
+// This function turns an unordered item array into a heap in O(n) by
+// sifting down every internal node, starting from the last one.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      before      -- [IN]: the comparison object
+//
+// Output:
+//      void
+// ============================================================================
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR void HeapBuild(ItemArray items, int numItems, Compare before)
+{
+    for (int index = numItems / 2 - 1; index >= 0; --index)
+    {
+        HeapSiftDown(items, numItems, index, before);
+    }
+}
+// end of HeapBuild()
+
+
+
+// ==== HeapSiftUp (layout) ===================================================
+//
+// This function is HeapSiftUp over the tree of a layout policy.
+//
+// Input:
+//      items   -- [IN/OUT]: the item array
+//      index   -- [IN]: the index of the item to move up
+//      before  -- [IN]: the comparison object
+//      layout  -- [IN]: the layout policy
+//
+// Output:
+//      int     -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare, class Layout>
+HEAP_CONSTEXPR int HeapSiftUp(ItemArray items, int index, Compare before, Layout)
+{
+    auto item = std::move(items[index]);
+
+    while (index > 0)
+    {
+        int parentIndex = Layout::GetParentIndex(index);
+
+        if (!before(item, items[parentIndex]))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[parentIndex]);
+        index = parentIndex;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftUp(ItemArray items, int index, Compare before,
+                              CImplicitHeapLayout)
+{
+    return HeapSiftUp(items, index, before);
+}
+// end of HeapSiftUp() (layout)
+
+
+// ==== HeapSiftDown (layout) =================================================
+//
+// This function is HeapSiftDown over the tree of a layout policy.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      index       -- [IN]: the index of the item to move down
+//      before      -- [IN]: the comparison object
+//      layout      -- [IN]: the layout policy
+//
+// Output:
+//      int         -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare, class Layout>
+HEAP_CONSTEXPR int HeapSiftDown(ItemArray items, int numItems, int index,
+                                Compare before, Layout)
+{
+    auto item = std::move(items[index]);
+
+    for (;;)
+    {
+        int leftIndex = 0;
+        int rightIndex = 0;
+
+        Layout::GetChildIndices(index, leftIndex, rightIndex);
+        if (leftIndex >= numItems)
+        {
+            break;
+        }
+
+        // pick the child that has to come first
+        int childIndex = leftIndex;
+        if ((rightIndex != leftIndex) && (rightIndex < numItems)
+            && before(items[rightIndex], items[leftIndex]))
+        {
+            childIndex = rightIndex;
+        }
+
+        if (!before(items[childIndex], item))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[childIndex]);
+        index = childIndex;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDown(ItemArray items, int numItems, int index,
+                                Compare before, CImplicitHeapLayout)
+{
+    return HeapSiftDown(items, numItems, index, before);
+}
+// end of HeapSiftDown() (layout)
+
+
+// ==== HeapBuild (layout) ====================================================
+//
+// This function is HeapBuild over the tree of a layout policy. Every parent
+// sits before its children, so sifting down every node from the last one to
+// the root builds the heap in O(n).
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      before      -- [IN]: the comparison object
+//      layout      -- [IN]: the layout policy
+//
+// Output:
+//      void
+// ============================================================================
+template <class ItemArray, class Compare, class Layout>
+HEAP_CONSTEXPR void HeapBuild(ItemArray items, int numItems, Compare before,
+                              Layout layout)
+{
+    for (int index = numItems - 1; index >= 0; --index)
+    {
+        HeapSiftDown(items, numItems, index, before, layout);
+    }
+}
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR void HeapBuild(ItemArray items, int numItems, Compare before,
+                              CImplicitHeapLayout)
+{
+    HeapBuild(items, numItems, before);
+}
+// end of HeapBuild() (layout)
+
+
+// ==== HeapSiftDownBottomUp (layout) =========================================
+//
+// This function is HeapSiftDownBranchless over the tree of a layout policy:
+// the hole at index goes down to a leaf with one comparison per level, then
+// the item climbs back. For an item taken from the bottom of the heap it
+// makes about half the comparisons of HeapSiftDown.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array
+//      numItems    -- [IN]: the number of items in the array
+//      index       -- [IN]: the index of the item to move down
+//      before      -- [IN]: the comparison object
+//      layout      -- [IN]: the layout policy
+//
+// Output:
+//      int         -- [OUT]: the final index of the item
+// ============================================================================
+template <class ItemArray, class Compare, class Layout>
+HEAP_CONSTEXPR int HeapSiftDownBottomUp(ItemArray items, int numItems,
+                                        int index, Compare before, Layout)
+{
+    auto item = std::move(items[index]);
+    int rootIndex = index;
+
+    for (;;)
+    {
+        int leftIndex = 0;
+        int rightIndex = 0;
+
+        Layout::GetChildIndices(index, leftIndex, rightIndex);
+        if (leftIndex >= numItems)
+        {
+            break;
+        }
+
+        int childIndex = leftIndex;
+        if ((rightIndex != leftIndex) && (rightIndex < numItems)
+            && before(items[rightIndex], items[leftIndex]))
+        {
+            childIndex = rightIndex;
+        }
+
+        items[index] = std::move(items[childIndex]);
+        index = childIndex;
+    }
+
+    while (index != rootIndex)
+    {
+        int parentIndex = Layout::GetParentIndex(index);
+
+        if (!before(item, items[parentIndex]))
+        {
+            break;
+        }
+
+        items[index] = std::move(items[parentIndex]);
+        index = parentIndex;
+    }
+
+    items[index] = std::move(item);
+
+    return index;
+}
+
+template <class ItemArray, class Compare>
+HEAP_CONSTEXPR int HeapSiftDownBottomUp(ItemArray items, int numItems,
+                                        int index, Compare before,
+                                        CImplicitHeapLayout)
+{
+    return HeapSiftDownBranchless(items, numItems, index, before);
+}
+// end of HeapSiftDownBottomUp() (layout)
+
+
+// batches of at least 1 / HEAP_POPN_SELECT_RATIO of the heap use selection
+const   int     HEAP_POPN_SELECT_RATIO = 2;
+
+
+// ==== HeapPopN ==============================================================
+//
+// This function moves the first count items of a heap to output, in
+// priority order, and leaves the other items as a heap at the front of the
+// array. The caller drops the last count slots afterwards.
+//
+// A batch of at least 1 / HEAP_POPN_SELECT_RATIO of the heap is selected
+// with nth_element, sorted and the rest rebuilt: O(n + k log k). A smaller
+// batch is popped one item at a time with HeapSiftDownBottomUp, which costs
+// about log n comparisons per item instead of the 2 log n of a plain pop.
+//
+// Input:
+//      items       -- [IN/OUT]: the item array, contiguous in memory
+//      numItems    -- [IN]: the number of items in the array
+//      count       -- [IN]: the number of items wanted
+//      output      -- [IN]: output iterator receiving the moved items
+//      before      -- [IN]: the comparison object
+//      layout      -- [IN]: the layout policy
+//
+// Output:
+//      int         -- [OUT]: the number of items moved out, at most count
+// ============================================================================
+template <class HeapItemType, class OutputIt, class Compare, class Layout>
+HEAP_CONSTEXPR int HeapPopN(HeapItemType *items, int numItems, int count,
+                            OutputIt output, Compare before, Layout layout)
+{
+    if (count > numItems)
+    {
+        count = numItems;
+    }
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    // case #1: a small batch, pop bottom-up
+    if (static_cast<long long>(count) * HEAP_POPN_SELECT_RATIO < numItems)
+    {
+        for (int popped = 0; popped < count; ++popped)
+        {
+            int lastIndex = numItems - 1 - popped;
+
+            *output++ = std::move(items[0]);
+            if (lastIndex > 0)
+            {
+                items[0] = std::move(items[lastIndex]);
+                HeapSiftDownBottomUp(items, lastIndex, 0, before, layout);
+            }
+        }
+
+        return count;
+    }
+
+    // case #2: a large batch, select and sort it, then rebuild the rest
+    if (count < numItems)
+    {
+        std::nth_element(items, items + count - 1, items + numItems, before);
+    }
+    std::sort(items, items + count, before);
+
+    for (int index = 0; index < count; ++index)
+    {
+        *output++ = std::move(items[index]);
+    }
+
+    // fill the holes at the front from the back of the array
+    int numLeft = numItems - count;
+    for (int index = 0; (index < count) && (index < numLeft); ++index)
+    {
+        items[index] = std::move(items[numItems - 1 - index]);
+    }
+    HeapBuild(items, numLeft, before, layout);
+
+    return count;
+}
+// end of HeapPopN()
+
+#endif // HEAPSIFT_H
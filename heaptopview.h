@@ -0,0 +1,257 @@
+// ============================================================================
+// File: heaptopview.h
+// ============================================================================
+// Header file for the CHeapTopView class, a non-destructive walk over the
+// first k items of a heap in priority order.
+//
+// The view never touches the heap. It keeps a small frontier heap of indices
+// into the heap's item array: the next item is always the best index in the
+// frontier, and yielding it adds that item's children. Yielding k items
+// therefore costs O(k log k) comparisons and O(k) memory, whatever the size
+// of the heap.
+//
+// A view reads the heap's storage directly, so it is valid only until the
+// heap is next changed.
+// ============================================================================
+#ifndef HEAPTOPVIEW_H
+#define HEAPTOPVIEW_H
+
+#include    <algorithm>
+#include    <cstddef>
+#include    <iterator>
+#include    <vector>
+#include    "heapsift.h"
+
+
+// ==== CHeapIndexOrder =======================================================
+//
+// Comparison object for the frontier: orders heap indices by the keys of
+// the items they refer to, in the heap's own order.
+//
+// ============================================================================
+template <class HeapItemType, class KeyOf = CHeapIdentityKey>
+struct  CHeapIndexOrder
+{
+    const HeapItemType  *m_items;   // the heap's item array
+    bool                m_isMax;    // true for a max heap
+    KeyOf               m_keyOf;    // the heap's projection
+
+    bool operator()(int lhs, int rhs) const
+    {
+        return m_isMax ? (m_keyOf(m_items[lhs]) > m_keyOf(m_items[rhs]))
+                       : (m_keyOf(m_items[lhs]) < m_keyOf(m_items[rhs]));
+    }
+};
+
+
+// class declaration
+template <class HeapItemType, class HeapLayout = CImplicitHeapLayout,
+          class KeyOf = CHeapIdentityKey>
+class   CHeapTopView
+{
+public:
+    // single pass input iterator over the view
+    class   Iterator
+    {
+    public:
+        typedef std::input_iterator_tag     iterator_category;
+        typedef HeapItemType                value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const HeapItemType*         pointer;
+        typedef const HeapItemType&         reference;
+
+        Iterator(CHeapTopView *view = NULL) : m_view(view) {}
+
+        reference   operator*() const { return m_view->m_items[m_view->m_current]; }
+        pointer     operator->() const { return &**this; }
+        Iterator&   operator++() { m_view->Advance(); return *this; }
+        void        operator++(int) { m_view->Advance(); }
+
+        bool operator==(const Iterator &rhs) const
+        {
+            return (IsDone() == rhs.IsDone());
+        }
+
+        bool operator!=(const Iterator &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        bool IsDone(void) const
+        {
+            return (m_view == NULL) || (m_view->m_current < 0);
+        }
+
+        CHeapTopView    *m_view;    // the view being walked, NULL for end()
+    };
+
+    // constructor
+    CHeapTopView(const HeapItemType *items, int numItems, bool isMax, int count);
+
+    // member functions
+    Iterator        begin(void);
+    Iterator        end(void);
+    const HeapItemType* Next(void);
+
+private:
+    // data members
+    const HeapItemType  *m_items;       // the heap's item array
+    int                 m_numItems;     // the number of items in the heap
+    int                 m_remaining;    // items still to yield, current one
+                                        // included
+    int                 m_current;      // index of the current item, or -1
+    std::vector<int>    m_frontier;     // indices that may come next
+    CHeapIndexOrder<HeapItemType, KeyOf>    m_before;
+
+    // utility functions
+    void            Advance(void);
+};
+
+
+// ==== CHeapTopView::CHeapTopView ============================================
+//
+// This is the constructor.
+//
+// Input:
+//      items       -- [IN]: the heap's item array, root first
+//      numItems    -- [IN]: the number of items in the heap
+//      isMax       -- [IN]: true for a max heap, false for a min heap
+//      count       -- [IN]: the number of items to yield at most
+//
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+CHeapTopView<HeapItemType, HeapLayout, KeyOf>::CHeapTopView(const HeapItemType *items,
+                                                            int numItems,
+                                                            bool isMax,
+                                                            int count)
+: m_items(items), m_numItems(numItems),
+  m_remaining(std::max(0, std::min(count, numItems))), m_current(-1)
+{
+    m_before.m_items = items;
+    m_before.m_isMax = isMax;
+
+    if (m_remaining > 0)
+    {
+        // every yield removes one index and adds at most two
+        m_frontier.reserve(m_remaining + 1);
+        m_frontier.push_back(0);
+        m_current = 0;
+    }
+}
+// end of CHeapTopView::CHeapTopView()
+
+
+// ==== CHeapTopView::Advance =================================================
+//
+// This function replaces the current item in the frontier with its children
+// and moves to the next best index.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+void CHeapTopView<HeapItemType, HeapLayout, KeyOf>::Advance(void)
+{
+    if (m_current < 0)
+    {
+        return;
+    }
+
+    int leftIndex = 0;
+    int rightIndex = 0;
+
+    HeapLayout::GetChildIndices(m_current, leftIndex, rightIndex);
+
+    if (--m_remaining == 0)
+    {
+        m_current = -1;
+        return;
+    }
+
+    // drop the current index (the frontier root)
+    int lastIndex = static_cast<int>(m_frontier.size()) - 1;
+    m_frontier[0] = m_frontier[lastIndex];
+    m_frontier.pop_back();
+    if (!m_frontier.empty())
+    {
+        HeapSiftDown(m_frontier.data(), lastIndex, 0, m_before);
+    }
+
+    // add its children
+    for (int child = leftIndex; child < m_numItems; child = rightIndex)
+    {
+        m_frontier.push_back(child);
+        HeapSiftUp(m_frontier.data(), static_cast<int>(m_frontier.size()) - 1,
+                   m_before);
+
+        if (child == rightIndex)
+        {
+            break;
+        }
+    }
+
+    m_current = m_frontier.empty() ? -1 : m_frontier[0];
+}
+// end of CHeapTopView::Advance()
+
+
+// ==== CHeapTopView::begin ===================================================
+//
+// This function returns an iterator at the current item. The view is single
+// pass: iterating again continues where the last iteration stopped.
+//
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+typename CHeapTopView<HeapItemType, HeapLayout, KeyOf>::Iterator
+CHeapTopView<HeapItemType, HeapLayout, KeyOf>::begin(void)
+{
+    return Iterator(this);
+}
+// end of CHeapTopView::begin()
+
+
+// ==== CHeapTopView::end =====================================================
+//
+// This function returns the end iterator.
+//
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+typename CHeapTopView<HeapItemType, HeapLayout, KeyOf>::Iterator
+CHeapTopView<HeapItemType, HeapLayout, KeyOf>::end(void)
+{
+    return Iterator();
+}
+// end of CHeapTopView::end()
+
+
+// ==== CHeapTopView::Next ====================================================
+//
+// This function yields the next item in priority order.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the next item, NULL when the view is
+//                             exhausted
+// ============================================================================
+template <class HeapItemType, class HeapLayout, class KeyOf>
+const HeapItemType* CHeapTopView<HeapItemType, HeapLayout, KeyOf>::Next(void)
+{
+    if (m_current < 0)
+    {
+        return NULL;
+    }
+
+    const HeapItemType *item = &m_items[m_current];
+    Advance();
+
+    return item;
+}
+// end of CHeapTopView::Next()
+
+#endif // HEAPTOPVIEW_H
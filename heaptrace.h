@@ -0,0 +1,768 @@
+// ============================================================================
+// File: heaptrace.h
+// ============================================================================
+// Header file for heap operation traces: CHeapTraceWriter and
+// CHeapTraceReader for the trace file, CTracingMaxMinHeap to record the
+// operations of a live heap, and ReplayHeapTrace to drive any heap class from
+// a recorded trace and measure it (see heapreplay.cpp).
+//
+// A trace stores, for each successful Insert, Remove and PeekTop, the
+// operation, the element's key and the time since the previous operation.
+// Records are variable length: an operation byte followed by LEB128 varints
+// for the time delta (nanoseconds) and the zigzag encoded key, so a typical
+// record takes 4 to 8 bytes.
+//
+// File layout (version 1):
+//      bytes [0, 32)   -- CHeapTraceHeader
+//      bytes [32, ...) -- records
+// ============================================================================
+#ifndef HEAPTRACE_H
+#define HEAPTRACE_H
+
+#include    <algorithm>
+#include    <chrono>
+#include    <cstdint>
+#include    <cstdio>
+#include    <cstring>
+#include    <string>
+#include    <vector>
+#include    "cmaxminheap.h"
+#include    "heapkey.h"
+
+// constants
+const   char        HEAP_TRACE_MAGIC[8] = "CHTRACE";
+const   uint32_t    HEAP_TRACE_VERSION = 1;
+const   int         HEAP_TRACE_BUFFER_BYTES = 1 << 16;
+
+// operations recorded in a trace
+enum    CHeapTraceOpType    { TRACE_INSERT = 1,
+                              TRACE_REMOVE = 2,
+                              TRACE_PEEK = 3,
+                              TRACE_NUM_OP_TYPES = 4
+                            };
+
+// enumerate list for CHeapTraceException class
+enum    CHeapTraceExceptionType { HEAP_TRACE_OPEN_FAILED,
+                                  HEAP_TRACE_IO_ERROR,
+                                  HEAP_TRACE_BAD_FORMAT
+                                };
+
+
+// exception class for the trace classes
+class CHeapTraceException
+{
+public:
+    // constructor
+    CHeapTraceException(CHeapTraceExceptionType   exceptType)
+            : m_exceptType(exceptType) {}
+
+    // member function
+    CHeapTraceExceptionType GetException() const {return m_exceptType;}
+
+private:
+    CHeapTraceExceptionType  m_exceptType;
+};
+
+
+// file header
+struct  CHeapTraceHeader
+{
+    char        m_magic[8];     // HEAP_TRACE_MAGIC
+    uint32_t    m_version;      // HEAP_TRACE_VERSION
+    uint32_t    m_heapType;     // MAX or MIN
+    uint64_t    m_reserved[2];
+};
+
+static_assert(sizeof(CHeapTraceHeader) == 32,
+              "CHeapTraceHeader must stay 32 bytes (file format)");
+
+
+// one decoded record
+struct  CHeapTraceRecord
+{
+    int         m_opType;   // CHeapTraceOpType
+    int64_t     m_key;      // key of the inserted, removed or peeked item
+    uint64_t    m_timeNs;   // nanoseconds since the start of the trace
+};
+
+
+// ==== CHeapTraceWriter ======================================================
+//
+// Appends records to a new trace file.
+//
+// ============================================================================
+class   CHeapTraceWriter
+{
+public:
+    // constructor and destructor
+    CHeapTraceWriter(const std::string &fileName, int heapType);
+    virtual ~CHeapTraceWriter();
+
+    // member functions
+    void        Write(int opType, int64_t key);
+    void        Write(const CHeapTraceRecord &record);
+    void        Flush(void);
+
+    // Helper functions
+    uint64_t    GetNumRecords(void) const { return m_numRecords; }
+
+private:
+    // data members
+    FILE                        *m_file;        // the trace file
+    std::vector<unsigned char>  m_buffer;       // encoded, unwritten records
+    std::chrono::steady_clock::time_point   m_startTime;
+    uint64_t                    m_lastTimeNs;   // time of the last record
+    uint64_t                    m_numRecords;   // records written
+
+    // no copying: the writer owns the file
+    CHeapTraceWriter(const CHeapTraceWriter &);
+    CHeapTraceWriter&   operator=(const CHeapTraceWriter &);
+
+    // utility functions
+    void        PutVarint(uint64_t value);
+};
+
+
+// ==== CHeapTraceReader ======================================================
+//
+// Reads the records of a trace file in order.
+//
+// ============================================================================
+class   CHeapTraceReader
+{
+public:
+    // constructor and destructor
+    CHeapTraceReader(const std::string &fileName);
+    virtual ~CHeapTraceReader();
+
+    // member functions
+    bool        Read(CHeapTraceRecord &record);
+
+    // Helper functions
+    int         GetHeapType(void) const { return m_heapType; }
+
+private:
+    // data members
+    FILE                        *m_file;        // the trace file
+    int                         m_heapType;     // from the header
+    std::vector<unsigned char>  m_buffer;       // unread bytes
+    size_t                      m_position;     // next byte in m_buffer
+    uint64_t                    m_lastTimeNs;   // time of the last record
+
+    // no copying: the reader owns the file
+    CHeapTraceReader(const CHeapTraceReader &);
+    CHeapTraceReader&   operator=(const CHeapTraceReader &);
+
+    // utility functions
+    bool        GetByte(unsigned char &byte);
+    uint64_t    GetVarint(void);
+};
+
+
+// ==== CHeapTraceWriter::CHeapTraceWriter ====================================
+//
+// This is the constructor. It creates (or truncates) the file and writes
+// the header.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//      heapType    -- [IN]: MAX or MIN, the type of the recorded heap
+//
+// ============================================================================
+inline CHeapTraceWriter::CHeapTraceWriter(const std::string &fileName,
+                                          int heapType)
+: m_file(std::fopen(fileName.c_str(), "wb")),
+  m_startTime(std::chrono::steady_clock::now()), m_lastTimeNs(0),
+  m_numRecords(0)
+{
+    if (m_file == NULL)
+    {
+        throw CHeapTraceException(HEAP_TRACE_OPEN_FAILED);
+    }
+
+    CHeapTraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.m_magic, HEAP_TRACE_MAGIC, sizeof(header.m_magic));
+    header.m_version = HEAP_TRACE_VERSION;
+    header.m_heapType = static_cast<uint32_t>(heapType);
+
+    if (std::fwrite(&header, sizeof(header), 1, m_file) != 1)
+    {
+        std::fclose(m_file);
+        throw CHeapTraceException(HEAP_TRACE_IO_ERROR);
+    }
+
+    m_buffer.reserve(HEAP_TRACE_BUFFER_BYTES + 32);
+}
+// end of CHeapTraceWriter::CHeapTraceWriter()
+
+
+// ==== CHeapTraceWriter::~CHeapTraceWriter ===================================
+//
+// This is the destructor. It writes the buffered records and closes the
+// file; call Flush first to see write errors.
+//
+// ============================================================================
+inline CHeapTraceWriter::~CHeapTraceWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (...)
+    {
+    }
+
+    std::fclose(m_file);
+}
+// end of CHeapTraceWriter::~CHeapTraceWriter()
+
+
+// ==== CHeapTraceWriter::PutVarint ===========================================
+//
+// This function appends an unsigned LEB128 varint to the buffer.
+//
+// Input:
+//      value   -- [IN]: the value
+//
+// Output:
+//      void
+// ============================================================================
+inline void CHeapTraceWriter::PutVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_buffer.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<unsigned char>(value));
+}
+// end of CHeapTraceWriter::PutVarint()
+
+
+// ==== CHeapTraceWriter::Write ===============================================
+//
+// This function records an operation at the current time.
+//
+// Input:
+//      opType  -- [IN]: TRACE_INSERT, TRACE_REMOVE or TRACE_PEEK
+//      key     -- [IN]: the key of the item
+//
+// Output:
+//      void
+// ============================================================================
+inline void CHeapTraceWriter::Write(int opType, int64_t key)
+{
+    CHeapTraceRecord record;
+
+    record.m_opType = opType;
+    record.m_key = key;
+    record.m_timeNs = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - m_startTime).count());
+
+    Write(record);
+}
+// end of CHeapTraceWriter::Write()
+
+
+// ==== CHeapTraceWriter::Write ===============================================
+//
+// This function records an operation with an explicit time, for traces that
+// are generated rather than recorded.
+//
+// Input:
+//      record  -- [IN]: the record; times must not decrease
+//
+// Output:
+//      void
+// ============================================================================
+inline void CHeapTraceWriter::Write(const CHeapTraceRecord &record)
+{
+    uint64_t timeNs = std::max(record.m_timeNs, m_lastTimeNs);
+    uint64_t zigzagKey = (static_cast<uint64_t>(record.m_key) << 1)
+                         ^ static_cast<uint64_t>(record.m_key >> 63);
+
+    m_buffer.push_back(static_cast<unsigned char>(record.m_opType));
+    PutVarint(timeNs - m_lastTimeNs);
+    PutVarint(zigzagKey);
+
+    m_lastTimeNs = timeNs;
+    m_numRecords++;
+
+    if (static_cast<int>(m_buffer.size()) >= HEAP_TRACE_BUFFER_BYTES)
+    {
+        Flush();
+    }
+}
+// end of CHeapTraceWriter::Write()
+
+
+// ==== CHeapTraceWriter::Flush ===============================================
+//
+// This function writes the buffered records to the file.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+inline void CHeapTraceWriter::Flush(void)
+{
+    if (!m_buffer.empty())
+    {
+        size_t numBytes = m_buffer.size();
+        size_t numWritten = std::fwrite(m_buffer.data(), 1, numBytes, m_file);
+
+        m_buffer.clear();
+        if (numWritten != numBytes)
+        {
+            throw CHeapTraceException(HEAP_TRACE_IO_ERROR);
+        }
+    }
+
+    if (std::fflush(m_file) != 0)
+    {
+        throw CHeapTraceException(HEAP_TRACE_IO_ERROR);
+    }
+}
+// end of CHeapTraceWriter::Flush()
+
+
+// ==== CHeapTraceReader::CHeapTraceReader ====================================
+//
+// This is the constructor. It opens the file and checks the header.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//
+// ============================================================================
+inline CHeapTraceReader::CHeapTraceReader(const std::string &fileName)
+: m_file(std::fopen(fileName.c_str(), "rb")), m_heapType(MAX), m_position(0),
+  m_lastTimeNs(0)
+{
+    if (m_file == NULL)
+    {
+        throw CHeapTraceException(HEAP_TRACE_OPEN_FAILED);
+    }
+
+    CHeapTraceHeader header;
+    if ((std::fread(&header, sizeof(header), 1, m_file) != 1)
+        || (std::memcmp(header.m_magic, HEAP_TRACE_MAGIC,
+                        sizeof(header.m_magic)) != 0)
+        || (header.m_version != HEAP_TRACE_VERSION))
+    {
+        std::fclose(m_file);
+        throw CHeapTraceException(HEAP_TRACE_BAD_FORMAT);
+    }
+
+    m_heapType = static_cast<int>(header.m_heapType);
+}
+// end of CHeapTraceReader::CHeapTraceReader()
+
+
+// ==== CHeapTraceReader::~CHeapTraceReader ===================================
+//
+// This is the destructor.
+//
+// ============================================================================
+inline CHeapTraceReader::~CHeapTraceReader()
+{
+    std::fclose(m_file);
+}
+// end of CHeapTraceReader::~CHeapTraceReader()
+
+
+// ==== CHeapTraceReader::GetByte =============================================
+//
+// This function returns the next byte of the file, refilling the buffer as
+// needed.
+//
+// Input:
+//      byte    -- [OUT]: the byte
+//
+// Output:
+//      bool -- [OUT]: false at the end of the file
+// ============================================================================
+inline bool CHeapTraceReader::GetByte(unsigned char &byte)
+{
+    if (m_position == m_buffer.size())
+    {
+        m_buffer.resize(HEAP_TRACE_BUFFER_BYTES);
+        m_buffer.resize(std::fread(m_buffer.data(), 1, m_buffer.size(), m_file));
+        m_position = 0;
+
+        if (m_buffer.empty())
+        {
+            if (std::ferror(m_file))
+            {
+                throw CHeapTraceException(HEAP_TRACE_IO_ERROR);
+            }
+            return false;
+        }
+    }
+
+    byte = m_buffer[m_position++];
+
+    return true;
+}
+// end of CHeapTraceReader::GetByte()
+
+
+// ==== CHeapTraceReader::GetVarint ===========================================
+//
+// This function reads an unsigned LEB128 varint.
+//
+// Input:
+//      void
+//
+// Output:
+//      uint64_t -- [OUT]: the value; CHeapTraceException(HEAP_TRACE_BAD_
+//                  FORMAT) is thrown on a truncated or overlong varint
+// ============================================================================
+inline uint64_t CHeapTraceReader::GetVarint(void)
+{
+    uint64_t value = 0;
+    unsigned char byte = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (!GetByte(byte))
+        {
+            break;
+        }
+
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+
+    throw CHeapTraceException(HEAP_TRACE_BAD_FORMAT);
+}
+// end of CHeapTraceReader::GetVarint()
+
+
+// ==== CHeapTraceReader::Read ================================================
+//
+// This function reads the next record.
+//
+// Input:
+//      record  -- [OUT]: the record
+//
+// Output:
+//      bool -- [OUT]: false at the end of the trace
+// ============================================================================
+inline bool CHeapTraceReader::Read(CHeapTraceRecord &record)
+{
+    unsigned char opType = 0;
+
+    if (!GetByte(opType))
+    {
+        return false;
+    }
+
+    if ((opType < TRACE_INSERT) || (opType >= TRACE_NUM_OP_TYPES))
+    {
+        throw CHeapTraceException(HEAP_TRACE_BAD_FORMAT);
+    }
+
+    m_lastTimeNs += GetVarint();
+    uint64_t zigzagKey = GetVarint();
+
+    record.m_opType = opType;
+    record.m_key = static_cast<int64_t>(zigzagKey >> 1)
+                   ^ -static_cast<int64_t>(zigzagKey & 1);
+    record.m_timeNs = m_lastTimeNs;
+
+    return true;
+}
+// end of CHeapTraceReader::Read()
+
+
+// ==== LoadHeapTrace =========================================================
+//
+// This function reads a whole trace into memory, so that replaying it does
+// not include any file I/O.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//      records     -- [OUT]: the records
+//
+// Output:
+//      int -- [OUT]: the heap type (MAX or MIN) of the recorded heap
+// ============================================================================
+inline int LoadHeapTrace(const std::string &fileName,
+                         std::vector<CHeapTraceRecord> &records)
+{
+    CHeapTraceReader reader(fileName);
+    CHeapTraceRecord record;
+
+    records.clear();
+    while (reader.Read(record))
+    {
+        records.push_back(record);
+    }
+
+    return reader.GetHeapType();
+}
+// end of LoadHeapTrace()
+
+
+// class declaration
+// A heap that records every successful Insert, Remove and PeekTop to a
+// CHeapTraceWriter. With a NULL writer it only forwards to the heap.
+template <class HeapItemType,
+          class HeapType = CMaxMinHeap<HeapItemType>,
+          class KeyOf = CDefaultPriorityOf>
+class   CTracingMaxMinHeap
+{
+public:
+    // constructor
+    CTracingMaxMinHeap(CHeapTraceWriter *writer, int heapType = MAX,
+                       KeyOf keyOf = KeyOf())
+                     : m_writer(writer), m_keyOf(keyOf), m_heap(heapType) {}
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+
+    // Helper functions
+    int             GetHeapType(void) const { return m_heap.GetHeapType(); }
+    int             GetNumItems(void) const { return m_heap.GetNumItems(); }
+    bool            IsEmpty(void) const { return m_heap.IsEmpty(); }
+    HeapType&       GetHeap(void) { return m_heap; }
+
+private:
+    // data members
+    CHeapTraceWriter    *m_writer;  // NULL when not recording
+    KeyOf               m_keyOf;    // element -> key
+    HeapType            m_heap;     // the traced heap
+};
+
+
+// ==== CTracingMaxMinHeap::Insert ============================================
+//
+// This function inserts an element and records it.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: the heap's result
+// ============================================================================
+template <class HeapItemType, class HeapType, class KeyOf>
+bool CTracingMaxMinHeap<HeapItemType, HeapType, KeyOf>::Insert(const HeapItemType  &newItem)
+{
+    bool inserted = m_heap.Insert(newItem);
+
+    if (m_writer != NULL)
+    {
+        m_writer->Write(TRACE_INSERT, static_cast<int64_t>(m_keyOf(newItem)));
+    }
+
+    return inserted;
+}
+// end of CTracingMaxMinHeap::Insert()
+
+
+// ==== CTracingMaxMinHeap::Remove ============================================
+//
+// This function removes the top element and records it.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: the heap's result
+// ============================================================================
+template <class HeapItemType, class HeapType, class KeyOf>
+bool CTracingMaxMinHeap<HeapItemType, HeapType, KeyOf>::Remove(HeapItemType &item)
+{
+    bool removed = m_heap.Remove(item);
+
+    if (m_writer != NULL)
+    {
+        m_writer->Write(TRACE_REMOVE, static_cast<int64_t>(m_keyOf(item)));
+    }
+
+    return removed;
+}
+// end of CTracingMaxMinHeap::Remove()
+
+
+// ==== CTracingMaxMinHeap::PeekTop ===========================================
+//
+// This function peeks the top element and records it.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType, class HeapType, class KeyOf>
+HeapItemType CTracingMaxMinHeap<HeapItemType, HeapType, KeyOf>::PeekTop(void) const
+{
+    HeapItemType top = m_heap.PeekTop();
+
+    if (m_writer != NULL)
+    {
+        m_writer->Write(TRACE_PEEK, static_cast<int64_t>(m_keyOf(top)));
+    }
+
+    return top;
+}
+// end of CTracingMaxMinHeap::PeekTop()
+
+
+// ==== CHeapReplayStats ======================================================
+//
+// Throughput and per-operation latencies of one replay.
+//
+// ============================================================================
+struct  CHeapReplayStats
+{
+    double                  m_seconds;                          // total time
+    uint64_t                m_numMismatches;                    // other keys
+    std::vector<uint32_t>   m_latencyNs[TRACE_NUM_OP_TYPES];    // per op
+
+    CHeapReplayStats() : m_seconds(0), m_numMismatches(0) {}
+
+    uint64_t GetNumOps(void) const
+    {
+        uint64_t numOps = 0;
+        for (int opType = TRACE_INSERT; opType < TRACE_NUM_OP_TYPES; ++opType)
+        {
+            numOps += m_latencyNs[opType].size();
+        }
+        return numOps;
+    }
+
+    // the latency below which the given fraction of the operations fall;
+    // sorts the latencies of that operation type
+    uint32_t GetPercentile(int opType, double fraction)
+    {
+        std::vector<uint32_t> &latencies = m_latencyNs[opType];
+
+        if (latencies.empty())
+        {
+            return 0;
+        }
+
+        size_t rank = static_cast<size_t>(fraction * (latencies.size() - 1));
+        std::nth_element(latencies.begin(), latencies.begin() + rank,
+                         latencies.end());
+
+        return latencies[rank];
+    }
+};
+
+
+// ==== CHeapReplayItemOf =====================================================
+//
+// Default conversion from a trace key to a heap item: a cast, for heaps of
+// arithmetic items.
+//
+// ============================================================================
+template <class HeapItemType>
+struct  CHeapReplayItemOf
+{
+    HeapItemType operator()(int64_t key) const
+    {
+        return static_cast<HeapItemType>(key);
+    }
+};
+
+
+// ==== ReplayHeapTrace =======================================================
+//
+// This function runs the operations of a trace against a heap as fast as
+// possible and measures each one. Removes and peeks on an empty heap are
+// skipped; a removed or peeked key that differs from the trace counts as a
+// mismatch, which flags a heap that orders items differently from the
+// recorded one.
+//
+// Input:
+//      records     -- [IN]: the trace, as loaded by LoadHeapTrace
+//      heap        -- [IN/OUT]: the heap to drive, usually empty
+//      stats       -- [OUT]: the measurements
+//      itemOf      -- [IN]: trace key -> heap item
+//      keyOf       -- [IN]: heap item -> trace key
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapType, class ItemOf, class KeyOf>
+void ReplayHeapTrace(const std::vector<CHeapTraceRecord> &records,
+                     HeapType &heap, CHeapReplayStats &stats, ItemOf itemOf,
+                     KeyOf keyOf)
+{
+    typedef std::chrono::steady_clock   Clock;
+    typedef decltype(itemOf(0))         ItemType;
+
+    ItemType item = ItemType();
+    int64_t key = 0;
+
+    for (int opType = TRACE_INSERT; opType < TRACE_NUM_OP_TYPES; ++opType)
+    {
+        stats.m_latencyNs[opType].clear();
+    }
+    stats.m_latencyNs[TRACE_INSERT].reserve(records.size());
+    stats.m_numMismatches = 0;
+
+    Clock::time_point replayStart = Clock::now();
+    for (size_t index = 0; index < records.size(); ++index)
+    {
+        const CHeapTraceRecord &record = records[index];
+
+        if ((record.m_opType != TRACE_INSERT) && heap.IsEmpty())
+        {
+            continue;
+        }
+
+        Clock::time_point opStart = Clock::now();
+        switch (record.m_opType)
+        {
+        case TRACE_INSERT:
+            heap.Insert(itemOf(record.m_key));
+            break;
+        case TRACE_REMOVE:
+            heap.Remove(item);
+            key = static_cast<int64_t>(keyOf(item));
+            break;
+        default:
+            key = static_cast<int64_t>(keyOf(heap.PeekTop()));
+            break;
+        }
+        Clock::time_point opEnd = Clock::now();
+
+        if ((record.m_opType != TRACE_INSERT) && (key != record.m_key))
+        {
+            stats.m_numMismatches++;
+        }
+
+        stats.m_latencyNs[record.m_opType].push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                opEnd - opStart).count()));
+    }
+
+    stats.m_seconds = std::chrono::duration<double>(Clock::now()
+                                                    - replayStart).count();
+}
+
+template <class HeapType>
+void ReplayHeapTrace(const std::vector<CHeapTraceRecord> &records,
+                     HeapType &heap, CHeapReplayStats &stats)
+{
+    typedef typename std::decay<decltype(heap.PeekTop())>::type ItemType;
+
+    ReplayHeapTrace(records, heap, stats, CHeapReplayItemOf<ItemType>(),
+                    CDefaultPriorityOf());
+}
+// end of ReplayHeapTrace()
+
+#endif // HEAPTRACE_H
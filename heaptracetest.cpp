@@ -0,0 +1,441 @@
+// ============================================================================
+// File: heaptracetest.cpp
+// ============================================================================
+// This is a driver that checks the heap trace format (heaptrace.h): records
+// written by CHeapTraceWriter come back unchanged from CHeapTraceReader,
+// including negative, INT64_MIN and INT64_MAX keys, zero and large time
+// deltas and files longer than one buffer; damaged files raise
+// HEAP_TRACE_BAD_FORMAT; and a CTracingMaxMinHeap trace replays without a
+// mismatch.
+//
+//      heaptracetest [directory]
+//              runs every check with its trace files in directory (the
+//              current directory by default); prints the failures and
+//              exits with 1 if there are any
+// ============================================================================
+
+#include    <iostream>
+#include    <cstdint>
+#include    <cstdio>
+#include    <fstream>
+#include    <iterator>
+#include    <limits>
+#include    <random>
+#include    <string>
+#include    <vector>
+using namespace std;
+#include    "cmaxminheap.h"
+#include    "heaptrace.h"
+
+// constants
+const   int     NUM_LONG_RECORDS = 100000;  // spans several write buffers
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== MakeRecord ============================================================
+//
+// This function fills in a trace record.
+//
+// Input:
+//      opType      -- [IN]: TRACE_INSERT, TRACE_REMOVE or TRACE_PEEK
+//      key         -- [IN]: the key
+//      timeNs      -- [IN]: the time of the record
+//
+// Output:
+//      CHeapTraceRecord -- [OUT]: the record
+// ============================================================================
+CHeapTraceRecord    MakeRecord(int opType, int64_t key, uint64_t timeNs)
+{
+    CHeapTraceRecord record;
+
+    record.m_opType = opType;
+    record.m_key = key;
+    record.m_timeNs = timeNs;
+
+    return record;
+}
+// end of MakeRecord()
+
+
+// ==== WriteRecords / ReadRecords ============================================
+//
+// These functions write records to a new trace file and read a trace file
+// back.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//      heapType    -- [IN]: MAX or MIN, for the header
+//      records     -- [IN]/[OUT]: the records
+//
+// Output:
+//      int -- [OUT]: ReadRecords returns the heap type of the header
+// ============================================================================
+void    WriteRecords(const string &fileName, int heapType,
+                     const vector<CHeapTraceRecord> &records)
+{
+    CHeapTraceWriter writer(fileName, heapType);
+
+    for (const CHeapTraceRecord &record : records)
+    {
+        writer.Write(record);
+    }
+    writer.Flush();
+}
+
+int     ReadRecords(const string &fileName, vector<CHeapTraceRecord> &records)
+{
+    CHeapTraceReader reader(fileName);
+    CHeapTraceRecord record;
+
+    records.clear();
+    while (reader.Read(record))
+    {
+        records.push_back(record);
+    }
+
+    return reader.GetHeapType();
+}
+// end of WriteRecords() / ReadRecords()
+
+
+// ==== ReadsAsBadFormat ======================================================
+//
+// This function reads a whole trace file and reports whether it was
+// rejected with HEAP_TRACE_BAD_FORMAT.
+//
+// Input:
+//      fileName    -- [IN]: the trace file
+//
+// Output:
+//      bool -- [OUT]: true if HEAP_TRACE_BAD_FORMAT was thrown
+// ============================================================================
+bool    ReadsAsBadFormat(const string &fileName)
+{
+    vector<CHeapTraceRecord> records;
+
+    try
+    {
+        ReadRecords(fileName, records);
+    }
+    catch (const CHeapTraceException &exceptObj)
+    {
+        return (exceptObj.GetException() == HEAP_TRACE_BAD_FORMAT);
+    }
+
+    return false;
+}
+// end of ReadsAsBadFormat()
+
+
+// ==== LoadBytes / SaveBytes =================================================
+//
+// These functions read a whole file into memory and write it back.
+//
+// Input:
+//      fileName    -- [IN]: the file
+//      bytes       -- [IN]/[OUT]: its contents
+//
+// Output:
+//      void
+// ============================================================================
+void    LoadBytes(const string &fileName, vector<char> &bytes)
+{
+    ifstream file(fileName.c_str(), ios::binary);
+
+    bytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+void    SaveBytes(const string &fileName, const vector<char> &bytes)
+{
+    ofstream file(fileName.c_str(), ios::binary | ios::trunc);
+
+    file.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+}
+// end of LoadBytes() / SaveBytes()
+
+
+// ==== CheckRoundTrip ========================================================
+//
+// This function writes records with extreme keys and time deltas and checks
+// they read back unchanged, a decreasing time reading back clamped.
+//
+// Input:
+//      fileName    -- [IN]: the scratch trace file
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckRoundTrip(const string &fileName)
+{
+    const int64_t KEYS[] = { 0, 1, -1, 63, -64, 64, -65, 127, 128, -129,
+                             numeric_limits<int32_t>::min(),
+                             numeric_limits<int64_t>::min(),
+                             numeric_limits<int64_t>::min() + 1,
+                             numeric_limits<int64_t>::max(),
+                             numeric_limits<int64_t>::max() - 1 };
+    vector<CHeapTraceRecord>    written;
+    vector<CHeapTraceRecord>    read;
+    uint64_t                    timeNs = 0;
+    int                         opType = TRACE_INSERT;
+
+    for (int64_t key : KEYS)
+    {
+        written.push_back(MakeRecord(opType, key, timeNs));
+        opType = (opType % (TRACE_NUM_OP_TYPES - 1)) + 1;
+    }
+    written.push_back(MakeRecord(TRACE_REMOVE, -5, timeNs));            // no delta
+    written.push_back(MakeRecord(TRACE_PEEK, 5, timeNs + 1));
+    written.push_back(MakeRecord(TRACE_INSERT, 7, timeNs + (1ull << 40)));
+    written.push_back(MakeRecord(TRACE_INSERT, 8,
+                                 numeric_limits<uint64_t>::max()));     // 10-byte delta
+
+    WriteRecords(fileName, MIN, written);
+    Check(ReadRecords(fileName, read) == MIN, "the header keeps the heap type");
+
+    bool matches = (read.size() == written.size());
+    for (size_t index = 0; matches && (index < read.size()); ++index)
+    {
+        matches = (read[index].m_opType == written[index].m_opType)
+                  && (read[index].m_key == written[index].m_key)
+                  && (read[index].m_timeNs == written[index].m_timeNs);
+    }
+    Check(matches, "records, keys and times read back unchanged");
+
+    // a time before the last one is stored as a zero delta
+    written.assign(1, MakeRecord(TRACE_INSERT, 1, 1000));
+    written.push_back(MakeRecord(TRACE_INSERT, 2, 10));
+    WriteRecords(fileName, MAX, written);
+    ReadRecords(fileName, read);
+    Check((read.size() == 2) && (read[1].m_timeNs == 1000),
+          "a decreasing time reads back as the previous time");
+}
+// end of CheckRoundTrip()
+
+
+// ==== CheckLongTrace ========================================================
+//
+// This function round-trips random records over several write and read
+// buffers.
+//
+// Input:
+//      fileName    -- [IN]: the scratch trace file
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckLongTrace(const string &fileName, mt19937_64 &random)
+{
+    vector<CHeapTraceRecord>    written;
+    vector<CHeapTraceRecord>    read;
+    uint64_t                    timeNs = 0;
+
+    for (int index = 0; index < NUM_LONG_RECORDS; ++index)
+    {
+        int     shift = static_cast<int>(random() % 64);
+        int64_t key = static_cast<int64_t>(random()) >> shift;
+
+        timeNs += random() % 100000;
+        written.push_back(MakeRecord(static_cast<int>(random() % 3) + 1, key,
+                                     timeNs));
+    }
+
+    WriteRecords(fileName, MAX, written);
+    ReadRecords(fileName, read);
+
+    bool matches = (read.size() == written.size());
+    for (size_t index = 0; matches && (index < read.size()); ++index)
+    {
+        matches = (read[index].m_opType == written[index].m_opType)
+                  && (read[index].m_key == written[index].m_key)
+                  && (read[index].m_timeNs == written[index].m_timeNs);
+    }
+    Check(matches, "a trace longer than a buffer reads back unchanged");
+}
+// end of CheckLongTrace()
+
+
+// ==== CheckDamagedFiles =====================================================
+//
+// This function cuts and corrupts a trace file and checks the reader
+// rejects it with HEAP_TRACE_BAD_FORMAT, and that a missing file raises
+// HEAP_TRACE_OPEN_FAILED.
+//
+// Input:
+//      fileName    -- [IN]: the scratch trace file
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckDamagedFiles(const string &fileName)
+{
+    vector<CHeapTraceRecord>    written;
+    vector<CHeapTraceRecord>    read;
+    vector<char>                bytes;
+    vector<char>                damaged;
+
+    written.push_back(MakeRecord(TRACE_INSERT, numeric_limits<int64_t>::min(), 5));
+    written.push_back(MakeRecord(TRACE_REMOVE, -300, 1000000));
+    WriteRecords(fileName, MAX, written);
+    LoadBytes(fileName, bytes);
+
+    // the last record is 6 bytes: the operation, a 3-byte time delta and a
+    // 2-byte key; every cut inside it leaves a truncated varint
+    bool allRejected = true;
+    for (size_t cut = 1; cut < 6; ++cut)
+    {
+        damaged.assign(bytes.begin(), bytes.end() - cut);
+        SaveBytes(fileName, damaged);
+        allRejected = allRejected && ReadsAsBadFormat(fileName);
+    }
+    Check(allRejected, "a truncated record raises HEAP_TRACE_BAD_FORMAT");
+
+    // a cut between records is just a shorter trace
+    damaged.assign(bytes.begin(), bytes.end() - 6);
+    SaveBytes(fileName, damaged);
+    Check(!ReadsAsBadFormat(fileName) && (ReadRecords(fileName, read) == MAX)
+          && (read.size() == 1) && (read[0].m_key == written[0].m_key),
+          "a trace cut between records reads the records before the cut");
+
+    damaged.assign(bytes.begin(), bytes.begin() + sizeof(CHeapTraceHeader) - 1);
+    SaveBytes(fileName, damaged);
+    Check(ReadsAsBadFormat(fileName), "a truncated header raises HEAP_TRACE_BAD_FORMAT");
+
+    damaged = bytes;
+    damaged[0] = 'X';
+    SaveBytes(fileName, damaged);
+    Check(ReadsAsBadFormat(fileName), "a wrong magic raises HEAP_TRACE_BAD_FORMAT");
+
+    damaged = bytes;
+    damaged[sizeof(CHeapTraceHeader)] = TRACE_NUM_OP_TYPES;
+    SaveBytes(fileName, damaged);
+    Check(ReadsAsBadFormat(fileName), "an unknown operation raises HEAP_TRACE_BAD_FORMAT");
+
+    damaged = bytes;
+    damaged.resize(sizeof(CHeapTraceHeader) + 2);
+    damaged.insert(damaged.end(), 11, static_cast<char>(0xff));
+    SaveBytes(fileName, damaged);
+    Check(ReadsAsBadFormat(fileName), "an overlong varint raises HEAP_TRACE_BAD_FORMAT");
+
+    remove(fileName.c_str());
+    bool openFailed = false;
+    try
+    {
+        CHeapTraceReader reader(fileName);
+    }
+    catch (const CHeapTraceException &exceptObj)
+    {
+        openFailed = (exceptObj.GetException() == HEAP_TRACE_OPEN_FAILED);
+    }
+    Check(openFailed, "a missing file raises HEAP_TRACE_OPEN_FAILED");
+}
+// end of CheckDamagedFiles()
+
+
+// ==== CheckTracingHeap ======================================================
+//
+// This function records a CTracingMaxMinHeap, loads the trace and replays it
+// against a fresh heap, which must see the same keys.
+//
+// Input:
+//      fileName    -- [IN]: the scratch trace file
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckTracingHeap(const string &fileName, mt19937_64 &random)
+{
+    int numOps = 0;
+    {
+        CHeapTraceWriter                writer(fileName, MIN);
+        CTracingMaxMinHeap<long long>   heap(&writer, MIN);
+        long long                       item;
+
+        for (int index = 0; index < 5000; ++index)
+        {
+            if (heap.IsEmpty() || (random() % 3 != 0))
+            {
+                heap.Insert(static_cast<long long>(random() % 2000) - 1000);
+            }
+            else if (random() % 2 == 0)
+            {
+                heap.Remove(item);
+            }
+            else
+            {
+                heap.PeekTop();
+            }
+            ++numOps;
+        }
+        Check(writer.GetNumRecords() == static_cast<uint64_t>(numOps),
+              "the tracing heap records every operation");
+    }
+
+    vector<CHeapTraceRecord>    records;
+    CMaxMinHeap<long long>      replayed(LoadHeapTrace(fileName, records));
+    CHeapReplayStats            stats;
+
+    ReplayHeapTrace(records, replayed, stats);
+    Check((records.size() == static_cast<size_t>(numOps))
+          && (stats.m_numMismatches == 0),
+          "a recorded trace replays without a mismatch");
+    remove(fileName.c_str());
+}
+// end of CheckTracingHeap()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      argc, argv  -- [IN]: an optional directory for the trace files
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(int argc, char *argv[])
+{
+    string      fileName = string((argc > 1) ? argv[1] : ".") + "/heaptracetest.trace";
+    mt19937_64  random(7);
+
+    CheckRoundTrip(fileName);
+    CheckLongTrace(fileName, random);
+    CheckDamagedFiles(fileName);
+    CheckTracingHeap(fileName, random);
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all heap trace checks passed" << endl;
+    return 0;
+}
+// end of main()
@@ -0,0 +1,119 @@
+// ============================================================================
+// File: internedpersoninfo.h
+// ============================================================================
+// Header file for the InternedPersonInfo, a PersonInfo whose name lives in a
+// CNameArena and is referred to by a 32-bit id.
+//
+// Without the std::string member the record is trivially copyable: CList can
+// grow and swap it with plain memory copies, and it can be stored by
+// CMappedMaxMinHeap and CExternalMaxMinHeap. It prints and compares exactly
+// like PersonInfo.
+// ============================================================================
+#ifndef INTERNEDPERSONINFO_H
+#define INTERNEDPERSONINFO_H
+
+#include    <cstdint>
+#include    <iostream>
+#include    <string>
+#include    <type_traits>
+#include    "cnamearena.h"
+#include    "heapsift.h"
+#include    "personinfo.h"
+
+
+template <class T>
+struct   InternedPersonInfo
+{
+    // constructors
+    // the default arguments keep the record default constructible for CList
+    InternedPersonInfo(double weight = 0, double height = 0, int age = 0,
+                       uint32_t nameId = NAME_ID_NONE, T priority = 0)
+                     : m_weight(weight), m_height(height), m_age(age),
+                       m_nameId(nameId), m_priority(priority) {}
+
+    InternedPersonInfo(CNameArena &arena, const PersonInfo<T> &person)
+                     : m_weight(person.m_weight), m_height(person.m_height),
+                       m_age(person.m_age),
+                       m_nameId(arena.Intern(person.m_fullName)),
+                       m_priority(person.m_priority) {}
+
+    // member functions
+    std::string ToPersonInfoName(void) const;
+
+    // data members
+    double      m_weight;   // pounds
+    double      m_height;   // inches
+    int         m_age;      // years
+    uint32_t    m_nameId;   // person's name, interned in a CNameArena
+    T           m_priority; // priority number (the higher the # the greater
+                            // the priority).
+};
+
+static_assert(std::is_trivially_copyable<InternedPersonInfo<int> >::value,
+              "InternedPersonInfo must stay trivially copyable");
+
+
+// ==== InternedPersonInfo::ToPersonInfoName ==================================
+//
+// This function returns a copy of the person's name, or an empty string if
+// the name id does not belong to a live arena.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::string -- [OUT]: the name
+// ============================================================================
+template <class T>
+std::string InternedPersonInfo<T>::ToPersonInfoName(void) const
+{
+    std::string name;
+
+    CNameArena::CopyName(m_nameId, name);
+
+    return name;
+}
+// end of InternedPersonInfo::ToPersonInfoName()
+
+
+// overloaded stream operator (same output as PersonInfo)
+template <class T>
+std::ostream& operator<<(std::ostream &outStream,
+                         const InternedPersonInfo<T> &person)
+{
+    std::string name;
+
+    CNameArena::CopyName(person.m_nameId, name);
+    outStream << name << " ";
+
+    return outStream;
+}
+
+
+// overloaded comparison operators
+template<class T>
+bool operator<(const InternedPersonInfo<T> &lhs, const InternedPersonInfo<T> &rhs)
+{
+    return (lhs.m_priority < rhs.m_priority);
+}
+
+template<class T>
+bool operator>(const InternedPersonInfo<T> &lhs, const InternedPersonInfo<T> &rhs)
+{
+    return (lhs.m_priority > rhs.m_priority);
+}
+
+template<class T>
+bool operator==(const InternedPersonInfo<T> &lhs, const InternedPersonInfo<T> &rhs)
+{
+    return (lhs.m_priority == rhs.m_priority);
+}
+
+// heaps compare a InternedPersonInfo by its priority alone: use the branchless
+// sift-down when that priority is arithmetic
+template <class T>
+struct  CHeapBranchlessItem<InternedPersonInfo<T> > : std::is_arithmetic<T>
+{
+};
+
+#endif // INTERNEDPERSONINFO_H
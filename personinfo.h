@@ -5,6 +5,11 @@
 #ifndef PERSONINFO_H
 #define PERSONINFO_H
 
+#include    <iostream>
+#include    <string>
+#include    <type_traits>
+#include    "heapsift.h"
+
 
 template <class T>
 struct   PersonInfo
@@ -33,7 +38,7 @@ struct   PersonInfo
 
 // overloaded stream operators
 template <class T>
-ostream& operator<<(ostream &outStream, const PersonInfo<T> &person)
+std::ostream& operator<<(std::ostream &outStream, const PersonInfo<T> &person)
 {
     outStream << person.m_fullName << " ";
 
@@ -41,7 +46,7 @@ ostream& operator<<(ostream &outStream, const PersonInfo<T> &person)
 }
 
 template <class T>
-istream& operator>>(istream &inStream, const PersonInfo<T> &person)
+std::istream& operator>>(std::istream &inStream, PersonInfo<T> &person)
 {
     double weight;
     double height;
@@ -53,8 +58,8 @@ istream& operator>>(istream &inStream, const PersonInfo<T> &person)
     std::cout << "Weight, Height, Age, Priority Level, Full Name \n";
     inStream >> weight >> height >> age>> priority ;
 
-    cin.ignore();
-    std::getline(std::cin, name);
+    inStream.ignore();
+    std::getline(inStream, name);
 
     person.m_weight = weight;
     person.m_height = height;
@@ -107,4 +112,11 @@ bool operator==(const PersonInfo<T> &lhs, const PersonInfo<T> &rhs)
     }
 }
 
+// heaps compare a PersonInfo by its priority alone: use the branchless
+// sift-down when that priority is arithmetic
+template <class T>
+struct  CHeapBranchlessItem<PersonInfo<T> > : std::is_arithmetic<T>
+{
+};
+
 #endif // PERSONINFO_H
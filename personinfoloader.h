@@ -0,0 +1,454 @@
+// ============================================================================
+// File: personinfoloader.h
+// ============================================================================
+// Header file for the PersonInfo bulk loaders.
+//
+// The loaders map the whole input file with mmap, parse it in place with
+// std::from_chars and fill each record directly in the heap's storage
+// (CMaxMinHeap::AppendUnordered). The heap order is restored once at the
+// end with CMaxMinHeap::Heapify, so loading n records costs O(n).
+//
+// CSV format, one record per line, in the order operator>> reads them:
+//
+//      weight,height,age,priority,full name
+//
+// The name is the rest of the line and may contain commas. Blank lines and
+// lines starting with '#' are skipped.
+//
+// Binary format (written by SavePersonInfoBinary), little endian host order:
+//
+//      header  -- CPersonInfoFileHeader
+//      records -- double weight, double height, int32 age, T priority,
+//                 uint32 name length, name bytes (no terminator)
+// ============================================================================
+#ifndef PERSONINFOLOADER_H
+#define PERSONINFOLOADER_H
+
+#include    <charconv>
+#include    <climits>
+#include    <cstdint>
+#include    <cstdio>
+#include    <cstring>
+#include    <string>
+#include    <type_traits>
+#include    <fcntl.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+#include    "cmaxminheap.h"
+#include    "personinfo.h"
+
+// constants
+const   char        PERSONINFO_FILE_MAGIC[8] = "PINFBIN";
+const   uint32_t    PERSONINFO_FILE_VERSION = 1;
+
+// enumerate list for CPersonInfoLoaderException class
+enum    CPersonInfoLoaderExceptionType  { LOADER_OPEN_FAILED,
+                                          LOADER_BAD_FORMAT,
+                                          LOADER_IO_ERROR
+                                        };
+
+
+// exception class for the PersonInfo loaders
+class CPersonInfoLoaderException
+{
+public:
+    // constructor
+    CPersonInfoLoaderException(CPersonInfoLoaderExceptionType   exceptType,
+                               long long lineNumber = 0)
+            : m_exceptType(exceptType), m_lineNumber(lineNumber) {}
+
+    // member functions
+    CPersonInfoLoaderExceptionType GetException() const {return m_exceptType;}
+    long long GetLineNumber() const {return m_lineNumber;}
+
+private:
+    CPersonInfoLoaderExceptionType  m_exceptType;
+    long long                       m_lineNumber; // CSV line, or record
+};
+
+
+// binary file header
+struct  CPersonInfoFileHeader
+{
+    char        m_magic[8];     // PERSONINFO_FILE_MAGIC
+    uint32_t    m_version;      // PERSONINFO_FILE_VERSION
+    uint32_t    m_prioritySize; // sizeof(T) of the writer
+    uint64_t    m_numRecords;   // number of records that follow
+};
+
+
+// read-only mapping of a whole input file
+class   CMappedInputFile
+{
+public:
+    // constructor and destructor
+    CMappedInputFile(const char *fileName);
+    ~CMappedInputFile();
+
+    // member functions
+    const char*     GetData(void) const {return m_data;}
+    size_t          GetSize(void) const {return m_size;}
+
+private:
+    // a mapping cannot be shared by two objects
+    CMappedInputFile(const CMappedInputFile &otherObj);
+    CMappedInputFile& operator=(const CMappedInputFile &rhs);
+
+    // data members
+    int         m_fileDesc;
+    const char  *m_data;
+    size_t      m_size;
+};
+
+
+// ==== CMappedInputFile::CMappedInputFile ====================================
+//
+// This constructor maps the whole file for sequential reading. An empty file
+// is not mapped and has a size of zero.
+//
+// ============================================================================
+inline CMappedInputFile::CMappedInputFile(const char *fileName)
+: m_fileDesc(-1), m_data(NULL), m_size(0)
+{
+    struct stat fileStatus;
+
+    m_fileDesc = open(fileName, O_RDONLY);
+    if ((m_fileDesc < 0) || (fstat(m_fileDesc, &fileStatus) != 0))
+    {
+        if (m_fileDesc >= 0)
+        {
+            close(m_fileDesc);
+        }
+        throw CPersonInfoLoaderException(LOADER_OPEN_FAILED);
+    }
+
+    m_size = fileStatus.st_size;
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    void *address = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fileDesc, 0);
+    if (address == MAP_FAILED)
+    {
+        close(m_fileDesc);
+        throw CPersonInfoLoaderException(LOADER_IO_ERROR);
+    }
+    madvise(address, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char *>(address);
+}
+// end of CMappedInputFile::CMappedInputFile()
+
+
+// ==== CMappedInputFile::~CMappedInputFile ===================================
+//
+// This is the destructor.
+//
+// ============================================================================
+inline CMappedInputFile::~CMappedInputFile()
+{
+    if (m_data != NULL)
+    {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+    close(m_fileDesc);
+}
+// end of CMappedInputFile::~CMappedInputFile()
+
+
+// ==== ParseCsvField =========================================================
+//
+// This function parses one numeric CSV field ending at the next comma. Spaces
+// around the number are allowed.
+//
+// Input:
+//      cursor  -- [IN/OUT]: the start of the field, moved past its comma
+//      lineEnd -- [IN]: the end of the line
+//      value   -- [OUT]: the parsed value
+//
+// Output:
+//      bool    -- [OUT]: false if the field is missing or not a number
+// ============================================================================
+template <class ValueType>
+bool ParseCsvField(const char *&cursor, const char *lineEnd, ValueType &value)
+{
+    while ((cursor < lineEnd) && (*cursor == ' '))
+    {
+        ++cursor;
+    }
+
+    std::from_chars_result result = std::from_chars(cursor, lineEnd, value);
+    if (result.ec != std::errc())
+    {
+        return false;
+    }
+
+    cursor = result.ptr;
+    while ((cursor < lineEnd) && (*cursor == ' '))
+    {
+        ++cursor;
+    }
+    if ((cursor == lineEnd) || (*cursor != ','))
+    {
+        return false;
+    }
+
+    ++cursor;
+    return true;
+}
+// end of ParseCsvField()
+
+
+// ==== LoadPersonInfoCSV =====================================================
+//
+// This function loads every record of a CSV file into a heap. The records
+// are added to the items already in the heap.
+//
+// Input:
+//      fileName    -- [IN]: the CSV file
+//      heap        -- [IN/OUT]: the heap that receives the records
+//
+// Output:
+//      long long   -- [OUT]: the number of records loaded
+// ============================================================================
+template <class T>
+long long LoadPersonInfoCSV(const char *fileName, CMaxMinHeap<PersonInfo<T> > &heap)
+{
+    CMappedInputFile file(fileName);
+    const char *cursor = file.GetData();
+    const char *fileEnd = cursor + file.GetSize();
+    long long numLines = 0;
+    long long numLoaded = 0;
+
+    // one fast pass over the newlines sizes the heap exactly once
+    for (const char *scan = cursor; scan < fileEnd; ++numLines)
+    {
+        const char *newLine = static_cast<const char *>(
+                              std::memchr(scan, '\n', fileEnd - scan));
+        scan = (newLine != NULL) ? newLine + 1 : fileEnd;
+    }
+    if (numLines > INT_MAX - heap.GetNumItems())
+    {
+        throw CPersonInfoLoaderException(LOADER_BAD_FORMAT);
+    }
+    heap.Reserve(heap.GetNumItems() + static_cast<int>(numLines));
+
+    for (long long lineNumber = 1; cursor < fileEnd; ++lineNumber)
+    {
+        const char *lineEnd = static_cast<const char *>(
+                              std::memchr(cursor, '\n', fileEnd - cursor));
+        const char *nextLine = (lineEnd != NULL) ? lineEnd + 1 : fileEnd;
+        if (lineEnd == NULL)
+        {
+            lineEnd = fileEnd;
+        }
+        if ((lineEnd > cursor) && (lineEnd[-1] == '\r'))
+        {
+            --lineEnd;
+        }
+
+        // skip blank and comment lines
+        if ((cursor == lineEnd) || (*cursor == '#'))
+        {
+            cursor = nextLine;
+            continue;
+        }
+
+        double weight;
+        double height;
+        int age;
+        T priority;
+
+        if (!ParseCsvField(cursor, lineEnd, weight)
+            || !ParseCsvField(cursor, lineEnd, height)
+            || !ParseCsvField(cursor, lineEnd, age)
+            || !ParseCsvField(cursor, lineEnd, priority))
+        {
+            heap.Heapify();
+            throw CPersonInfoLoaderException(LOADER_BAD_FORMAT, lineNumber);
+        }
+        while ((cursor < lineEnd) && (*cursor == ' '))
+        {
+            ++cursor;
+        }
+
+        // fill the record in the heap storage
+        PersonInfo<T> &person = heap.AppendUnordered();
+        person.m_weight = weight;
+        person.m_height = height;
+        person.m_age = age;
+        person.m_priority = priority;
+        person.m_fullName.assign(cursor, lineEnd - cursor);
+
+        numLoaded++;
+        cursor = nextLine;
+    }
+
+    heap.Heapify();
+
+    return numLoaded;
+}
+// end of LoadPersonInfoCSV()
+
+
+// ==== LoadPersonInfoBinary ==================================================
+//
+// This function loads every record of a binary file written by
+// SavePersonInfoBinary into a heap. The records are added to the items
+// already in the heap.
+//
+// Input:
+//      fileName    -- [IN]: the binary file
+//      heap        -- [IN/OUT]: the heap that receives the records
+//
+// Output:
+//      long long   -- [OUT]: the number of records loaded
+// ============================================================================
+template <class T>
+long long LoadPersonInfoBinary(const char *fileName, CMaxMinHeap<PersonInfo<T> > &heap)
+{
+    static_assert(std::is_arithmetic<T>::value,
+                  "binary PersonInfo files store the priority as raw bytes");
+
+    CMappedInputFile file(fileName);
+    const char *cursor = file.GetData();
+    const char *fileEnd = cursor + file.GetSize();
+    CPersonInfoFileHeader header;
+
+    if ((file.GetSize() < sizeof(header)))
+    {
+        throw CPersonInfoLoaderException(LOADER_BAD_FORMAT);
+    }
+    std::memcpy(&header, cursor, sizeof(header));
+    cursor += sizeof(header);
+
+    if ((std::memcmp(header.m_magic, PERSONINFO_FILE_MAGIC,
+                     sizeof(header.m_magic)) != 0)
+        || (header.m_version != PERSONINFO_FILE_VERSION)
+        || (header.m_prioritySize != sizeof(T)))
+    {
+        throw CPersonInfoLoaderException(LOADER_BAD_FORMAT);
+    }
+
+    const size_t fixedSize = 2 * sizeof(double) + sizeof(int32_t)
+                             + sizeof(T) + sizeof(uint32_t);
+
+    // the header is not trusted: every record needs at least fixedSize bytes
+    // and the heap is indexed by int
+    if ((header.m_numRecords > static_cast<uint64_t>(fileEnd - cursor) / fixedSize)
+        || (header.m_numRecords
+            > static_cast<uint64_t>(INT_MAX - heap.GetNumItems())))
+    {
+        throw CPersonInfoLoaderException(LOADER_BAD_FORMAT);
+    }
+    heap.Reserve(heap.GetNumItems() + static_cast<int>(header.m_numRecords));
+
+    for (uint64_t record = 0; record < header.m_numRecords; ++record)
+    {
+        double weight;
+        double height;
+        int32_t age;
+        T priority;
+        uint32_t nameLength;
+
+        if (static_cast<size_t>(fileEnd - cursor) < fixedSize)
+        {
+            heap.Heapify();
+            throw CPersonInfoLoaderException(LOADER_BAD_FORMAT, record + 1);
+        }
+
+        // fields are unaligned in the file, so copy them out
+        std::memcpy(&weight, cursor, sizeof(double));
+        cursor += sizeof(double);
+        std::memcpy(&height, cursor, sizeof(double));
+        cursor += sizeof(double);
+        std::memcpy(&age, cursor, sizeof(int32_t));
+        cursor += sizeof(int32_t);
+        std::memcpy(&priority, cursor, sizeof(T));
+        cursor += sizeof(T);
+        std::memcpy(&nameLength, cursor, sizeof(uint32_t));
+        cursor += sizeof(uint32_t);
+
+        if (static_cast<size_t>(fileEnd - cursor) < nameLength)
+        {
+            heap.Heapify();
+            throw CPersonInfoLoaderException(LOADER_BAD_FORMAT, record + 1);
+        }
+
+        // the record is complete, fill it in the heap storage
+        PersonInfo<T> &person = heap.AppendUnordered();
+        person.m_weight = weight;
+        person.m_height = height;
+        person.m_age = age;
+        person.m_priority = priority;
+        person.m_fullName.assign(cursor, nameLength);
+        cursor += nameLength;
+    }
+
+    heap.Heapify();
+
+    return static_cast<long long>(header.m_numRecords);
+}
+// end of LoadPersonInfoBinary()
+
+
+// ==== SavePersonInfoBinary ==================================================
+//
+// This function writes records in the binary format read by
+// LoadPersonInfoBinary.
+//
+// Input:
+//      fileName    -- [IN]: the binary file
+//      people      -- [IN]: the records to write
+//      numPeople   -- [IN]: the number of records
+//
+// Output:
+//      void
+// ============================================================================
+template <class T>
+void SavePersonInfoBinary(const char *fileName, const PersonInfo<T> *people,
+                          long long numPeople)
+{
+    static_assert(std::is_arithmetic<T>::value,
+                  "binary PersonInfo files store the priority as raw bytes");
+
+    FILE *file = std::fopen(fileName, "wb");
+    if (file == NULL)
+    {
+        throw CPersonInfoLoaderException(LOADER_OPEN_FAILED);
+    }
+
+    CPersonInfoFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.m_magic, PERSONINFO_FILE_MAGIC, sizeof(header.m_magic));
+    header.m_version = PERSONINFO_FILE_VERSION;
+    header.m_prioritySize = sizeof(T);
+    header.m_numRecords = numPeople;
+
+    bool success = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+
+    for (long long index = 0; (index < numPeople) && success; ++index)
+    {
+        const PersonInfo<T> &person = people[index];
+        int32_t age = person.m_age;
+        uint32_t nameLength = static_cast<uint32_t>(person.m_fullName.size());
+
+        success = (std::fwrite(&person.m_weight, sizeof(double), 1, file) == 1)
+                  && (std::fwrite(&person.m_height, sizeof(double), 1, file) == 1)
+                  && (std::fwrite(&age, sizeof(int32_t), 1, file) == 1)
+                  && (std::fwrite(&person.m_priority, sizeof(T), 1, file) == 1)
+                  && (std::fwrite(&nameLength, sizeof(uint32_t), 1, file) == 1)
+                  && (std::fwrite(person.m_fullName.data(), 1, nameLength, file)
+                      == nameLength);
+    }
+
+    if ((std::fclose(file) != 0) || !success)
+    {
+        throw CPersonInfoLoaderException(LOADER_IO_ERROR);
+    }
+}
+// end of SavePersonInfoBinary()
+
+#endif // PERSONINFOLOADER_H
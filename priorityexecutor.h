@@ -0,0 +1,477 @@
+// ============================================================================
+// File: priorityexecutor.h
+// ============================================================================
+// Header file for the PriorityExecutor class, a thread pool that runs the
+// callables submitted to it in priority order: the highest priority first,
+// and tasks of equal priority in submission order.
+//
+// Every task carries a sequence number taken at submission, and tasks are
+// ordered by (priority, sequence) rather than by priority alone, so the heap
+// never sees two equal tasks and FIFO order within a priority is exact.
+//
+// With SHARED_QUEUE (the default) all workers take from one heap and the
+// order is global. With LOCAL_QUEUES every worker owns a heap: a task
+// submitted by a worker goes to that worker's heap and others are spread
+// round-robin, a worker runs its own best task first, and an idle worker
+// steals the best task among the other heaps. That cuts lock contention at
+// the price of a priority order that holds per worker rather than globally.
+// ============================================================================
+#ifndef PRIORITYEXECUTOR_H
+#define PRIORITYEXECUTOR_H
+
+#include    <atomic>
+#include    <chrono>
+#include    <condition_variable>
+#include    <cstdint>
+#include    <functional>
+#include    <memory>
+#include    <mutex>
+#include    <thread>
+#include    <utility>
+#include    <vector>
+#include    "cmaxminheap.h"
+
+// queue modes
+enum    CPriorityQueueMode  { SHARED_QUEUE, LOCAL_QUEUES };
+
+
+// ==== CPriorityTask =========================================================
+//
+// A queued callable. Higher priority wins; on equal priority the lower
+// (earlier) sequence number wins.
+//
+// ============================================================================
+struct  CPriorityTask
+{
+    int                                     m_priority;
+    uint64_t                                m_sequence;
+    std::chrono::steady_clock::time_point   m_submitTime;
+    std::function<void()>                   m_work;
+
+    bool operator>(const CPriorityTask &rhs) const
+    {
+        return (m_priority != rhs.m_priority) ? (m_priority > rhs.m_priority)
+                                              : (m_sequence < rhs.m_sequence);
+    }
+
+    bool operator<(const CPriorityTask &rhs) const
+    {
+        return (rhs > *this);
+    }
+};
+
+
+// ==== CPriorityExecutorStats ================================================
+//
+// A snapshot of the executor's counters. Wait time runs from Submit to the
+// moment a worker takes the task.
+//
+// ============================================================================
+struct  CPriorityExecutorStats
+{
+    uint64_t    m_numSubmitted;     // tasks accepted by Submit
+    uint64_t    m_numCompleted;     // tasks run, including failed ones
+    uint64_t    m_numFailed;        // tasks that threw
+    uint64_t    m_numStolen;        // tasks taken from another worker
+    int         m_queueDepth;       // tasks waiting now
+    int         m_maxQueueDepth;    // most tasks ever waiting at once
+    double      m_meanWaitNs;       // mean wait of the tasks taken
+    uint64_t    m_maxWaitNs;        // longest wait of a task taken
+};
+
+
+// class declaration
+class   PriorityExecutor
+{
+public:
+    // constructor and destructor
+    PriorityExecutor(int numThreads, int queueMode = SHARED_QUEUE);
+    virtual ~PriorityExecutor();
+
+    // member functions
+    void        Submit(int priority, std::function<void()> work);
+
+    // Helper functions
+    int         GetNumThreads(void) const;
+    int         GetQueueDepth(void) const;
+    CPriorityExecutorStats  GetStats(void) const;
+
+private:
+    // one heap of tasks; padded so that neighbouring queues' locks do not
+    // share a cache line
+    struct  alignas(64) CTaskQueue
+    {
+        std::mutex                  m_lock;
+        CMaxMinHeap<CPriorityTask>  m_heap;
+    };
+
+    // data members
+    std::vector<std::unique_ptr<CTaskQueue>>    m_queues;
+    std::vector<std::thread>                    m_threads;
+    std::mutex                      m_sleepLock;        // for m_wakeup
+    std::condition_variable         m_wakeup;           // work or m_stop
+    bool                            m_stop;             // set by destructor
+    std::atomic<int>                m_numPending;       // queued tasks
+    std::atomic<int>                m_maxPending;
+    std::atomic<uint64_t>           m_nextSequence;     // FIFO among equals
+    std::atomic<uint64_t>           m_numSubmitted;     // inserted tasks
+    std::atomic<uint64_t>           m_numTaken;         // in m_totalWaitNs
+    std::atomic<unsigned>           m_nextQueue;        // round-robin
+    std::atomic<uint64_t>           m_numCompleted;
+    std::atomic<uint64_t>           m_numFailed;
+    std::atomic<uint64_t>           m_numStolen;
+    std::atomic<uint64_t>           m_totalWaitNs;
+    std::atomic<uint64_t>           m_maxWaitNs;
+
+    // no copying: the executor owns its threads
+    PriorityExecutor(const PriorityExecutor &);
+    PriorityExecutor&   operator=(const PriorityExecutor &);
+
+    // utility functions
+    static PriorityExecutor*&   CurrentExecutor(void);
+    static int&                 CurrentWorker(void);
+    bool        TakeTask(int homeQueue, CPriorityTask &task);
+    void        RecordWait(const CPriorityTask &task);
+    void        WorkerLoop(int worker);
+};
+
+
+// ==== PriorityExecutor::PriorityExecutor ====================================
+//
+// This is the constructor. It starts the worker threads.
+//
+// Input:
+//      numThreads  -- [IN]: the number of workers, at least one
+//      queueMode   -- [IN]: SHARED_QUEUE or LOCAL_QUEUES
+//
+// ============================================================================
+inline PriorityExecutor::PriorityExecutor(int numThreads, int queueMode)
+: m_stop(false), m_numPending(0), m_maxPending(0), m_nextSequence(0),
+  m_numSubmitted(0), m_numTaken(0), m_nextQueue(0), m_numCompleted(0), m_numFailed(0), m_numStolen(0),
+  m_totalWaitNs(0), m_maxWaitNs(0)
+{
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+
+    int numQueues = (queueMode == LOCAL_QUEUES) ? numThreads : 1;
+    for (int index = 0; index < numQueues; ++index)
+    {
+        m_queues.emplace_back(new CTaskQueue);
+    }
+
+    m_threads.reserve(numThreads);
+    for (int index = 0; index < numThreads; ++index)
+    {
+        m_threads.emplace_back(&PriorityExecutor::WorkerLoop, this, index);
+    }
+}
+// end of PriorityExecutor::PriorityExecutor()
+
+
+// ==== PriorityExecutor::~PriorityExecutor ===================================
+//
+// This is the destructor. The workers run every task already submitted,
+// including the ones those tasks submit, then exit and are joined.
+//
+// ============================================================================
+inline PriorityExecutor::~PriorityExecutor()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+
+    for (std::thread &worker : m_threads)
+    {
+        worker.join();
+    }
+}
+// end of PriorityExecutor::~PriorityExecutor()
+
+
+// ==== PriorityExecutor::CurrentExecutor =====================================
+//
+// These functions return the executor and worker index of the calling
+// thread; the executor is NULL on a thread that is not a worker.
+// ============================================================================
+inline PriorityExecutor*& PriorityExecutor::CurrentExecutor(void)
+{
+    static thread_local PriorityExecutor *currentExecutor = NULL;
+
+    return currentExecutor;
+}
+
+inline int& PriorityExecutor::CurrentWorker(void)
+{
+    static thread_local int currentWorker = 0;
+
+    return currentWorker;
+}
+// end of PriorityExecutor::CurrentExecutor()
+
+
+// ==== PriorityExecutor::Submit ==============================================
+//
+// This function queues a callable. It may be called from any thread,
+// including the executor's own workers.
+//
+// Input:
+//      priority    -- [IN]: the higher, the sooner the task runs
+//      work        -- [IN]: the callable
+//
+// Output:
+//      void; CMaxMinHeapException(HEAP_FULL) is thrown if there is no
+//      memory for the task
+// ============================================================================
+inline void PriorityExecutor::Submit(int priority, std::function<void()> work)
+{
+    CPriorityTask task;
+    int queue = 0;
+
+    task.m_priority = priority;
+    task.m_sequence = m_nextSequence.fetch_add(1, std::memory_order_relaxed);
+    task.m_submitTime = std::chrono::steady_clock::now();
+    task.m_work = std::move(work);
+
+    if (m_queues.size() > 1)
+    {
+        queue = (CurrentExecutor() == this)
+                ? CurrentWorker()
+                : static_cast<int>(m_nextQueue.fetch_add(1, std::memory_order_relaxed)
+                                   % m_queues.size());
+    }
+
+    // count the task only once it is queued, and under the queue lock that
+    // a worker holds to take it and decrement m_numPending again; a failed
+    // Insert only leaves a gap in the sequence numbers
+    int numPending;
+    {
+        std::lock_guard<std::mutex> guard(m_queues[queue]->m_lock);
+        m_queues[queue]->m_heap.Insert(task);
+        numPending = m_numPending.fetch_add(1) + 1;
+        m_numSubmitted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int maxPending = m_maxPending.load(std::memory_order_relaxed);
+    while ((numPending > maxPending)
+           && !m_maxPending.compare_exchange_weak(maxPending, numPending,
+                                                  std::memory_order_relaxed))
+    {
+    }
+
+    // taking the lock orders this wakeup after a worker's check of
+    // m_numPending, so the wakeup cannot be lost
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+    }
+    m_wakeup.notify_one();
+}
+// end of PriorityExecutor::Submit()
+
+
+// ==== PriorityExecutor::TakeTask ============================================
+//
+// This function removes the next task for a worker: the best task of its
+// home queue or, if that is empty, the best task among the other queues.
+//
+// Input:
+//      homeQueue   -- [IN]: the worker's own queue
+//      task        -- [OUT]: the task
+//
+// Output:
+//      bool -- [OUT]: false if every queue was empty
+// ============================================================================
+inline bool PriorityExecutor::TakeTask(int homeQueue, CPriorityTask &task)
+{
+    int numQueues = static_cast<int>(m_queues.size());
+
+    {
+        CTaskQueue &home = *m_queues[homeQueue];
+        std::lock_guard<std::mutex> guard(home.m_lock);
+
+        if (!home.m_heap.IsEmpty())
+        {
+            home.m_heap.Remove(task);
+            m_numPending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // pick the victim by peeking, then take its top; another worker may
+    // have got there first, in which case scan again
+    for (;;)
+    {
+        int victim = -1;
+        int bestPriority = 0;
+        uint64_t bestSequence = 0;
+
+        for (int index = 1; index < numQueues; ++index)
+        {
+            int queue = (homeQueue + index) % numQueues;
+            CTaskQueue &other = *m_queues[queue];
+            std::lock_guard<std::mutex> guard(other.m_lock);
+            const CPriorityTask *top = other.m_heap.TryPeek();
+
+            if ((top != NULL)
+                && ((victim < 0) || (top->m_priority > bestPriority)
+                    || ((top->m_priority == bestPriority)
+                        && (top->m_sequence < bestSequence))))
+            {
+                victim = queue;
+                bestPriority = top->m_priority;
+                bestSequence = top->m_sequence;
+            }
+        }
+
+        if (victim < 0)
+        {
+            return false;
+        }
+
+        CTaskQueue &other = *m_queues[victim];
+        std::lock_guard<std::mutex> guard(other.m_lock);
+        if (!other.m_heap.IsEmpty())
+        {
+            other.m_heap.Remove(task);
+            m_numPending.fetch_sub(1);
+            m_numStolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+// end of PriorityExecutor::TakeTask()
+
+
+// ==== PriorityExecutor::RecordWait ==========================================
+//
+// This function adds a task's wait time to the statistics.
+//
+// Input:
+//      task    -- [IN]: the task just taken
+//
+// Output:
+//      void
+// ============================================================================
+inline void PriorityExecutor::RecordWait(const CPriorityTask &task)
+{
+    uint64_t waitNs = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now()
+                            - task.m_submitTime).count());
+    uint64_t maxWaitNs = m_maxWaitNs.load(std::memory_order_relaxed);
+
+    m_totalWaitNs.fetch_add(waitNs, std::memory_order_relaxed);
+    m_numTaken.fetch_add(1, std::memory_order_relaxed);
+    while ((waitNs > maxWaitNs)
+           && !m_maxWaitNs.compare_exchange_weak(maxWaitNs, waitNs,
+                                                 std::memory_order_relaxed))
+    {
+    }
+}
+// end of PriorityExecutor::RecordWait()
+
+
+// ==== PriorityExecutor::WorkerLoop ==========================================
+//
+// This function is the body of every worker thread. An exception thrown by
+// a task is counted and otherwise ignored.
+//
+// Input:
+//      worker  -- [IN]: the worker's index
+//
+// Output:
+//      void
+// ============================================================================
+inline void PriorityExecutor::WorkerLoop(int worker)
+{
+    int homeQueue = worker % static_cast<int>(m_queues.size());
+    CPriorityTask task;
+
+    CurrentExecutor() = this;
+    CurrentWorker() = homeQueue;
+
+    for (;;)
+    {
+        if (!TakeTask(homeQueue, task))
+        {
+            std::unique_lock<std::mutex> guard(m_sleepLock);
+
+            if (m_stop && (m_numPending.load() == 0))
+            {
+                break;
+            }
+            m_wakeup.wait(guard, [this]
+                          { return m_stop || (m_numPending.load() > 0); });
+            continue;
+        }
+
+        RecordWait(task);
+        try
+        {
+            task.m_work();
+        }
+        catch (...)
+        {
+            m_numFailed.fetch_add(1, std::memory_order_relaxed);
+        }
+        task.m_work = nullptr;
+        m_numCompleted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    CurrentExecutor() = NULL;
+}
+// end of PriorityExecutor::WorkerLoop()
+
+
+// ==== PriorityExecutor::GetNumThreads =======================================
+//
+// This function returns the number of worker threads.
+// ============================================================================
+inline int PriorityExecutor::GetNumThreads(void) const
+{
+    return static_cast<int>(m_threads.size());
+}
+// end of PriorityExecutor::GetNumThreads()
+
+
+// ==== PriorityExecutor::GetQueueDepth =======================================
+//
+// This function returns the number of tasks waiting to run.
+// ============================================================================
+inline int PriorityExecutor::GetQueueDepth(void) const
+{
+    return m_numPending.load();
+}
+// end of PriorityExecutor::GetQueueDepth()
+
+
+// ==== PriorityExecutor::GetStats ============================================
+//
+// This function returns a snapshot of the counters. They are read one by
+// one, so a snapshot taken while tasks run may be slightly inconsistent.
+// ============================================================================
+inline CPriorityExecutorStats PriorityExecutor::GetStats(void) const
+{
+    CPriorityExecutorStats stats;
+    uint64_t numTaken = m_numTaken.load(std::memory_order_relaxed);
+
+    stats.m_numSubmitted = m_numSubmitted.load(std::memory_order_relaxed);
+    stats.m_numCompleted = m_numCompleted.load(std::memory_order_relaxed);
+    stats.m_numFailed = m_numFailed.load(std::memory_order_relaxed);
+    stats.m_numStolen = m_numStolen.load(std::memory_order_relaxed);
+    stats.m_queueDepth = m_numPending.load();
+    stats.m_maxQueueDepth = m_maxPending.load(std::memory_order_relaxed);
+    stats.m_maxWaitNs = m_maxWaitNs.load(std::memory_order_relaxed);
+
+    stats.m_meanWaitNs = (numTaken == 0) ? 0.0
+                         : static_cast<double>(m_totalWaitNs.load(std::memory_order_relaxed))
+                           / static_cast<double>(numTaken);
+
+    return stats;
+}
+// end of PriorityExecutor::GetStats()
+
+#endif // PRIORITYEXECUTOR_H
@@ -0,0 +1,343 @@
+// ============================================================================
+// File: priorityexecutortest.cpp
+// ============================================================================
+// This is a driver that checks PriorityExecutor: priority order with FIFO
+// order among equal priorities, the drain on destruction (tasks that submit
+// tasks included), failed tasks, stealing between LOCAL_QUEUES workers, and
+// the queue depth and wait statistics.
+//
+//      priorityexecutortest
+//              runs every check; prints the failures and exits with 1 if
+//              there are any
+// ============================================================================
+
+#include    <iostream>
+#include    <atomic>
+#include    <chrono>
+#include    <mutex>
+#include    <stdexcept>
+#include    <thread>
+#include    <utility>
+#include    <vector>
+using namespace std;
+#include    "priorityexecutor.h"
+
+// constants
+const   int     NUM_ORDERED_TASKS = 200;
+const   int     NUM_DRAIN_TASKS = 10000;
+const   int     GATE_MILLISECONDS = 20;     // how long a gate holds a worker
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== HoldWorker ============================================================
+//
+// This function submits a task that keeps a worker busy until open is set,
+// and returns once a worker has taken it.
+//
+// Input:
+//      executor    -- [IN/OUT]: the executor
+//      open        -- [IN]: set by the caller to let the worker go
+//
+// Output:
+//      void
+// ============================================================================
+void    HoldWorker(PriorityExecutor &executor, atomic<bool> &open)
+{
+    executor.Submit(0, [&open]
+                       {
+                           while (!open)
+                           {
+                               this_thread::yield();
+                           }
+                       });
+    while (executor.GetQueueDepth() > 0)
+    {
+        this_thread::yield();
+    }
+}
+// end of HoldWorker()
+
+
+// ==== WaitForCompleted ======================================================
+//
+// This function waits until the executor has completed numTasks tasks.
+//
+// Input:
+//      executor    -- [IN]: the executor
+//      numTasks    -- [IN]: the number of tasks
+//
+// Output:
+//      void
+// ============================================================================
+void    WaitForCompleted(const PriorityExecutor &executor, uint64_t numTasks)
+{
+    while (executor.GetStats().m_numCompleted < numTasks)
+    {
+        this_thread::yield();
+    }
+}
+// end of WaitForCompleted()
+
+
+// ==== CheckOrder ============================================================
+//
+// This function queues tasks behind a held single worker and checks they
+// run by priority, and in submission order within a priority.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckOrder(void)
+{
+    PriorityExecutor        executor(1);
+    atomic<bool>            open(false);
+    mutex                   ranLock;
+    vector<pair<int, int>>  ran;            // (priority, submission number)
+
+    HoldWorker(executor, open);
+    for (int index = 0; index < NUM_ORDERED_TASKS; ++index)
+    {
+        int priority = (index * 7) % 5;
+
+        executor.Submit(priority, [&ranLock, &ran, priority, index]
+                                  {
+                                      lock_guard<mutex> guard(ranLock);
+                                      ran.push_back(make_pair(priority, index));
+                                  });
+    }
+    open = true;
+    WaitForCompleted(executor, NUM_ORDERED_TASKS + 1);
+
+    // the completion count is relaxed; the lock orders the reads of ran
+    lock_guard<mutex> guard(ranLock);
+    bool inOrder = (ran.size() == NUM_ORDERED_TASKS);
+    for (size_t index = 1; inOrder && (index < ran.size()); ++index)
+    {
+        inOrder = (ran[index - 1].first > ran[index].first)
+                  || ((ran[index - 1].first == ran[index].first)
+                      && (ran[index - 1].second < ran[index].second));
+    }
+    Check(inOrder, "tasks run by priority, then in submission order");
+}
+// end of CheckOrder()
+
+
+// ==== CheckDrainOnDestruction ===============================================
+//
+// This function destroys executors with work still queued, some of it
+// submitting more work, and checks every task ran before the destructor
+// returned.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckDrainOnDestruction(void)
+{
+    for (int queueMode : { SHARED_QUEUE, LOCAL_QUEUES })
+    {
+        atomic<int> numRun(0);
+        {
+            PriorityExecutor executor(4, queueMode);
+
+            for (int index = 0; index < NUM_DRAIN_TASKS; ++index)
+            {
+                executor.Submit(index % 10, [&executor, &numRun, index]
+                                {
+                                    ++numRun;
+                                    if (index % 100 == 0)
+                                    {
+                                        executor.Submit(-1, [&numRun] { ++numRun; });
+                                    }
+                                });
+            }
+        }
+        Check(numRun == NUM_DRAIN_TASKS + NUM_DRAIN_TASKS / 100,
+              "the destructor runs every task, including submitted ones");
+    }
+}
+// end of CheckDrainOnDestruction()
+
+
+// ==== CheckFailedTasks ======================================================
+//
+// This function runs tasks that throw and checks they are counted as failed
+// and completed, and that the workers go on running the other tasks.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckFailedTasks(void)
+{
+    PriorityExecutor    executor(2);
+    atomic<int>         numRun(0);
+
+    for (int index = 0; index < 100; ++index)
+    {
+        if (index % 4 == 0)
+        {
+            executor.Submit(index, [] { throw runtime_error("task failed"); });
+        }
+        else
+        {
+            executor.Submit(index, [&numRun] { ++numRun; });
+        }
+    }
+    WaitForCompleted(executor, 100);
+
+    CPriorityExecutorStats stats = executor.GetStats();
+    Check((stats.m_numFailed == 25) && (stats.m_numCompleted == 100),
+          "a throwing task counts as failed and completed");
+    Check(numRun == 75, "a throwing task does not stop its worker");
+}
+// end of CheckFailedTasks()
+
+
+// ==== CheckStealing =========================================================
+//
+// This function has one LOCAL_QUEUES worker queue tasks on its own heap
+// while it stays busy, and checks the idle worker steals and runs them.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckStealing(void)
+{
+    PriorityExecutor    executor(2, LOCAL_QUEUES);
+    atomic<int>         numRun(0);
+    atomic<bool>        submitted(false);
+
+    executor.Submit(0, [&executor, &numRun, &submitted]
+                       {
+                           for (int index = 0; index < 100; ++index)
+                           {
+                               executor.Submit(index, [&numRun] { ++numRun; });
+                           }
+                           submitted = true;
+
+                           // stay busy until the other worker has stolen
+                           // everything
+                           while (numRun < 100)
+                           {
+                               this_thread::yield();
+                           }
+                       });
+    WaitForCompleted(executor, 101);
+
+    CPriorityExecutorStats stats = executor.GetStats();
+    Check(submitted && (numRun == 100), "every task queued by a busy worker runs");
+    // the first task may itself be stolen, if the other worker wakes first
+    Check(stats.m_numStolen >= 100, "an idle worker steals a busy worker's tasks");
+}
+// end of CheckStealing()
+
+
+// ==== CheckStats ============================================================
+//
+// This function queues tasks behind a held worker and checks the queue
+// depth, the submission and completion counts and the wait times.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckStats(void)
+{
+    PriorityExecutor    executor(1);
+    atomic<bool>        open(false);
+
+    CPriorityExecutorStats stats = executor.GetStats();
+    Check((stats.m_numSubmitted == 0) && (stats.m_queueDepth == 0)
+          && (stats.m_meanWaitNs == 0) && (stats.m_maxWaitNs == 0),
+          "a new executor has empty statistics");
+
+    HoldWorker(executor, open);
+    for (int index = 0; index < 10; ++index)
+    {
+        executor.Submit(index, [] {});
+    }
+    Check(executor.GetQueueDepth() == 10, "the queue depth counts waiting tasks");
+
+    this_thread::sleep_for(chrono::milliseconds(GATE_MILLISECONDS));
+    open = true;
+    WaitForCompleted(executor, 11);
+
+    stats = executor.GetStats();
+    uint64_t gateNs = static_cast<uint64_t>(GATE_MILLISECONDS) * 1000000;
+    Check((stats.m_numSubmitted == 11) && (stats.m_numCompleted == 11),
+          "every submitted task is counted");
+    Check((stats.m_queueDepth == 0) && (stats.m_maxQueueDepth == 10),
+          "the queue depth drains and its maximum is kept");
+    Check(stats.m_maxWaitNs >= gateNs, "the longest wait covers the held worker");
+    Check((stats.m_meanWaitNs > 0) && (stats.m_meanWaitNs <= stats.m_maxWaitNs),
+          "the mean wait lies within the longest");
+    Check(executor.GetNumThreads() == 1, "the executor reports its threads");
+}
+// end of CheckStats()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(void)
+{
+    CheckOrder();
+    CheckDrainOnDestruction();
+    CheckFailedTasks();
+    CheckStealing();
+    CheckStats();
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all priority executor checks passed" << endl;
+    return 0;
+}
+// end of main()
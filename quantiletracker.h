@@ -0,0 +1,578 @@
+// ============================================================================
+// File: quantiletracker.h
+// ============================================================================
+// Header file for the streaming quantile classes:
+//
+//      QuantileTracker<T>          -- one fixed quantile of every sample seen
+//      RunningMedian<T>            -- QuantileTracker at 0.5, with the mean
+//                                     of the two middle samples
+//      SlidingQuantileTracker<T>   -- one fixed quantile of a window of
+//                                     recent samples
+//
+// Each keeps the samples split between two heaps: a MAX heap holding the
+// lowest floor(q * (n - 1)) + 1 samples and a MIN heap holding the rest.
+// The quantile, by nearest rank below, is then the top of the MAX heap and
+// the sample just above it the top of the MIN heap, so a query is O(1) and
+// an insert is O(log n): one heap insert and at most one top moved across.
+//
+// The sliding variant keeps its samples in CTombstoneMaxMinHeaps and evicts
+// expired samples through their handles, in O(log n) amortised, instead of
+// re-sorting the window.
+// ============================================================================
+#ifndef QUANTILETRACKER_H
+#define QUANTILETRACKER_H
+
+#include    <cstdint>
+#include    <deque>
+#include    <type_traits>
+#include    "cmaxminheap.h"
+#include    "ctombstonemaxminheap.h"
+
+
+// ==== GetQuantileRankCount ==================================================
+//
+// This function returns how many of numSamples sorted samples lie at or
+// below the nearest-rank quantile: floor(quantile * (numSamples - 1)) + 1.
+//
+// Input:
+//      quantile    -- [IN]: the quantile, in [0, 1]
+//      numSamples  -- [IN]: the number of samples
+//
+// Output:
+//      int -- [OUT]: the size of the lower heap, 0 if there are no samples
+// ============================================================================
+inline int GetQuantileRankCount(double quantile, int numSamples)
+{
+    if (numSamples == 0)
+    {
+        return 0;
+    }
+
+    return static_cast<int>(quantile * (numSamples - 1)) + 1;
+}
+// end of GetQuantileRankCount()
+
+
+// class declaration
+template <class SampleType>
+class   QuantileTracker
+{
+public:
+    // constructor and destructor
+    QuantileTracker(double quantile);
+    virtual ~QuantileTracker();
+
+    // member functions
+    void            Insert(const SampleType &sample);
+    SampleType      GetQuantile(void) const;
+    double          GetInterpolatedQuantile(void) const;
+    void            Clear(void);
+
+    // Helper functions
+    double          GetQuantileLevel(void) const { return m_quantile; }
+    int             GetNumSamples(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    // data members
+    double                  m_quantile; // in [0, 1]
+    CMaxMinHeap<SampleType> m_lower;    // samples up to the quantile, MAX
+    CMaxMinHeap<SampleType> m_upper;    // samples above it, MIN
+
+    // utility functions
+    void            Rebalance(void);
+};
+
+
+// ==== QuantileTracker::QuantileTracker ======================================
+//
+// This is the constructor.
+//
+// Input:
+//      quantile    -- [IN]: the quantile to track, clamped to [0, 1]
+//
+// ============================================================================
+template <class SampleType>
+QuantileTracker<SampleType>::QuantileTracker(double quantile)
+: m_quantile((quantile < 0) ? 0 : ((quantile > 1) ? 1 : quantile)),
+  m_lower(MAX), m_upper(MIN)
+{
+}
+// end of QuantileTracker::QuantileTracker()
+
+
+// ==== QuantileTracker::~QuantileTracker =====================================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class SampleType>
+QuantileTracker<SampleType>::~QuantileTracker()
+{
+}
+// end of QuantileTracker::~QuantileTracker()
+
+
+// ==== QuantileTracker::Rebalance ============================================
+//
+// This function moves tops between the heaps until the lower heap holds
+// exactly the samples at or below the quantile.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void QuantileTracker<SampleType>::Rebalance(void)
+{
+    int lowerCount = GetQuantileRankCount(m_quantile, GetNumSamples());
+    SampleType sample;
+
+    while (m_lower.GetNumItems() > lowerCount)
+    {
+        m_lower.Remove(sample);
+        m_upper.Insert(sample);
+    }
+    while (m_lower.GetNumItems() < lowerCount)
+    {
+        m_upper.Remove(sample);
+        m_lower.Insert(sample);
+    }
+}
+// end of QuantileTracker::Rebalance()
+
+
+// ==== QuantileTracker::Insert ===============================================
+//
+// This function adds a sample in O(log n).
+//
+// Input:
+//      sample  -- [IN]: the sample
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void QuantileTracker<SampleType>::Insert(const SampleType &sample)
+{
+    if (m_lower.IsEmpty() || !(sample > m_lower.PeekTop()))
+    {
+        m_lower.Insert(sample);
+    }
+    else
+    {
+        m_upper.Insert(sample);
+    }
+
+    Rebalance();
+}
+// end of QuantileTracker::Insert()
+
+
+// ==== QuantileTracker::GetQuantile ==========================================
+//
+// This function returns the quantile by nearest rank below: the sample of
+// rank floor(q * (n - 1)) in sorted order, in O(1).
+//
+// Input:
+//      void
+//
+// Output:
+//      SampleType -- [OUT]: the sample; CMaxMinHeapException(HEAP_EMPTY)
+//                    is thrown if there are no samples
+// ============================================================================
+template <class SampleType>
+SampleType QuantileTracker<SampleType>::GetQuantile(void) const
+{
+    return m_lower.PeekTop();
+}
+// end of QuantileTracker::GetQuantile()
+
+
+// ==== QuantileTracker::GetInterpolatedQuantile ==============================
+//
+// This function returns the quantile interpolated linearly between the two
+// samples around position q * (n - 1), for arithmetic samples, in O(1).
+//
+// Input:
+//      void
+//
+// Output:
+//      double -- [OUT]: the quantile; CMaxMinHeapException(HEAP_EMPTY) is
+//                thrown if there are no samples
+// ============================================================================
+template <class SampleType>
+double QuantileTracker<SampleType>::GetInterpolatedQuantile(void) const
+{
+    static_assert(std::is_arithmetic<SampleType>::value,
+                  "GetInterpolatedQuantile needs arithmetic samples");
+
+    double below = static_cast<double>(m_lower.PeekTop());
+    double position = m_quantile * (GetNumSamples() - 1);
+    double fraction = position - static_cast<int>(position);
+
+    if ((fraction == 0) || m_upper.IsEmpty())
+    {
+        return below;
+    }
+
+    return below + fraction * (static_cast<double>(m_upper.PeekTop()) - below);
+}
+// end of QuantileTracker::GetInterpolatedQuantile()
+
+
+// ==== QuantileTracker::Clear ================================================
+//
+// This function forgets every sample. The heaps are emptied in place, not
+// destroyed, so the lower one stays a MAX heap and the upper one a MIN heap.
+// ============================================================================
+template <class SampleType>
+void QuantileTracker<SampleType>::Clear(void)
+{
+    m_lower.RemoveIf([](const SampleType &) { return true; });
+    m_upper.RemoveIf([](const SampleType &) { return true; });
+}
+// end of QuantileTracker::Clear()
+
+
+// ==== QuantileTracker::GetNumSamples ========================================
+//
+// This function returns the number of samples.
+// ============================================================================
+template <class SampleType>
+int QuantileTracker<SampleType>::GetNumSamples(void) const
+{
+    return m_lower.GetNumItems() + m_upper.GetNumItems();
+}
+// end of QuantileTracker::GetNumSamples()
+
+
+// ==== QuantileTracker::IsEmpty ==============================================
+//
+// This function returns a boolean value if there are no samples.
+// ============================================================================
+template <class SampleType>
+bool QuantileTracker<SampleType>::IsEmpty(void) const
+{
+    return m_lower.IsEmpty();
+}
+// end of QuantileTracker::IsEmpty()
+
+
+// ==== RunningMedian =========================================================
+//
+// The running median: the lower median by GetQuantile, the mean of the two
+// middle samples by GetMedian.
+//
+// ============================================================================
+template <class SampleType>
+class   RunningMedian : public QuantileTracker<SampleType>
+{
+public:
+    RunningMedian() : QuantileTracker<SampleType>(0.5) {}
+
+    double  GetMedian(void) const
+    {
+        return QuantileTracker<SampleType>::GetInterpolatedQuantile();
+    }
+};
+
+
+// a sample in a sliding window, with its arrival number
+template <class SampleType>
+struct  CWindowSample
+{
+    SampleType  m_value;
+    uint64_t    m_sequence;
+};
+
+template <class SampleType>
+bool operator<(const CWindowSample<SampleType> &lhs,
+               const CWindowSample<SampleType> &rhs)
+{
+    return (lhs.m_value < rhs.m_value);
+}
+
+template <class SampleType>
+bool operator>(const CWindowSample<SampleType> &lhs,
+               const CWindowSample<SampleType> &rhs)
+{
+    return (lhs.m_value > rhs.m_value);
+}
+
+
+// class declaration
+template <class SampleType>
+class   SlidingQuantileTracker
+{
+public:
+    // constructor and destructor
+    SlidingQuantileTracker(double quantile, int maxSamples = 0);
+    virtual ~SlidingQuantileTracker();
+
+    // member functions
+    void            Insert(const SampleType &sample, uint64_t time = 0);
+    int             ExpireBefore(uint64_t time);
+    SampleType      GetQuantile(void) const;
+
+    // Helper functions
+    double          GetQuantileLevel(void) const { return m_quantile; }
+    int             GetNumSamples(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    typedef CWindowSample<SampleType>   EntryType;
+
+    // where a sample of the window is
+    struct  CWindowSlot
+    {
+        uint64_t    m_time;     // arrival time, for ExpireBefore
+        bool        m_isLower;  // in m_lower rather than m_upper
+        CHeapHandle m_handle;   // its handle in that heap
+    };
+
+    // data members
+    double                          m_quantile;     // in [0, 1]
+    int                             m_maxSamples;   // 0 for no count limit
+    CTombstoneMaxMinHeap<EntryType> m_lower;        // up to the quantile, MAX
+    CTombstoneMaxMinHeap<EntryType> m_upper;        // above it, MIN
+    std::deque<CWindowSlot>         m_window;       // oldest sample first
+    uint64_t                        m_firstSequence;    // of m_window.front()
+
+    // utility functions
+    void            Place(const EntryType &entry, bool isLower);
+    void            EvictOldest(void);
+    void            Rebalance(void);
+};
+
+
+// ==== SlidingQuantileTracker::SlidingQuantileTracker ========================
+//
+// This is the constructor.
+//
+// Input:
+//      quantile    -- [IN]: the quantile to track, clamped to [0, 1]
+//      maxSamples  -- [IN]: the window length in samples; 0 keeps samples
+//                     until ExpireBefore evicts them
+//
+// ============================================================================
+template <class SampleType>
+SlidingQuantileTracker<SampleType>::SlidingQuantileTracker(double quantile,
+                                                           int maxSamples)
+: m_quantile((quantile < 0) ? 0 : ((quantile > 1) ? 1 : quantile)),
+  m_maxSamples(maxSamples), m_lower(MAX), m_upper(MIN), m_firstSequence(0)
+{
+}
+// end of SlidingQuantileTracker::SlidingQuantileTracker()
+
+
+// ==== SlidingQuantileTracker::~SlidingQuantileTracker =======================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class SampleType>
+SlidingQuantileTracker<SampleType>::~SlidingQuantileTracker()
+{
+}
+// end of SlidingQuantileTracker::~SlidingQuantileTracker()
+
+
+// ==== SlidingQuantileTracker::Place =========================================
+//
+// This function inserts a sample into one heap and records its handle.
+//
+// Input:
+//      entry   -- [IN]: the sample
+//      isLower -- [IN]: true for the lower heap
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void SlidingQuantileTracker<SampleType>::Place(const EntryType &entry, bool isLower)
+{
+    CWindowSlot &slot = m_window[entry.m_sequence - m_firstSequence];
+
+    slot.m_isLower = isLower;
+    slot.m_handle = isLower ? m_lower.Insert(entry) : m_upper.Insert(entry);
+}
+// end of SlidingQuantileTracker::Place()
+
+
+// ==== SlidingQuantileTracker::Rebalance =====================================
+//
+// This function moves tops between the heaps until the lower heap holds
+// exactly the samples at or below the quantile.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void SlidingQuantileTracker<SampleType>::Rebalance(void)
+{
+    int lowerCount = GetQuantileRankCount(m_quantile, GetNumSamples());
+    EntryType entry;
+
+    while (m_lower.GetNumItems() > lowerCount)
+    {
+        m_lower.Remove(entry);
+        Place(entry, false);
+    }
+    while (m_lower.GetNumItems() < lowerCount)
+    {
+        m_upper.Remove(entry);
+        Place(entry, true);
+    }
+}
+// end of SlidingQuantileTracker::Rebalance()
+
+
+// ==== SlidingQuantileTracker::EvictOldest ===================================
+//
+// This function drops the oldest sample of the window through its handle.
+// The heaps are rebalanced by the caller.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void SlidingQuantileTracker<SampleType>::EvictOldest(void)
+{
+    const CWindowSlot &slot = m_window.front();
+
+    if (slot.m_isLower)
+    {
+        m_lower.MarkDeleted(slot.m_handle);
+    }
+    else
+    {
+        m_upper.MarkDeleted(slot.m_handle);
+    }
+
+    m_window.pop_front();
+    m_firstSequence++;
+}
+// end of SlidingQuantileTracker::EvictOldest()
+
+
+// ==== SlidingQuantileTracker::Insert ========================================
+//
+// This function adds a sample, evicting the oldest one if the window is at
+// its maximum length.
+//
+// Input:
+//      sample  -- [IN]: the sample
+//      time    -- [IN]: its arrival time, in the caller's unit, for
+//                 ExpireBefore; times must not decrease
+//
+// Output:
+//      void
+// ============================================================================
+template <class SampleType>
+void SlidingQuantileTracker<SampleType>::Insert(const SampleType &sample,
+                                                uint64_t time)
+{
+    if ((m_maxSamples > 0) && (static_cast<int>(m_window.size()) >= m_maxSamples))
+    {
+        EvictOldest();
+        Rebalance();
+    }
+
+    EntryType entry;
+    entry.m_value = sample;
+    entry.m_sequence = m_firstSequence + m_window.size();
+
+    CWindowSlot slot;
+    slot.m_time = time;
+    m_window.push_back(slot);
+
+    Place(entry, m_lower.IsEmpty() || !(sample > m_lower.PeekTop().m_value));
+    Rebalance();
+}
+// end of SlidingQuantileTracker::Insert()
+
+
+// ==== SlidingQuantileTracker::ExpireBefore ==================================
+//
+// This function evicts every sample that arrived before a time.
+//
+// Input:
+//      time    -- [IN]: the oldest arrival time to keep
+//
+// Output:
+//      int -- [OUT]: the number of samples evicted
+// ============================================================================
+template <class SampleType>
+int SlidingQuantileTracker<SampleType>::ExpireBefore(uint64_t time)
+{
+    int numEvicted = 0;
+
+    while (!m_window.empty() && (m_window.front().m_time < time))
+    {
+        EvictOldest();
+        numEvicted++;
+    }
+
+    if (numEvicted > 0)
+    {
+        Rebalance();
+    }
+
+    return numEvicted;
+}
+// end of SlidingQuantileTracker::ExpireBefore()
+
+
+// ==== SlidingQuantileTracker::GetQuantile ===================================
+//
+// This function returns the quantile of the window by nearest rank below,
+// in O(1).
+//
+// Input:
+//      void
+//
+// Output:
+//      SampleType -- [OUT]: the sample; CMaxMinHeapException(HEAP_EMPTY)
+//                    is thrown if the window is empty
+// ============================================================================
+template <class SampleType>
+SampleType SlidingQuantileTracker<SampleType>::GetQuantile(void) const
+{
+    return m_lower.PeekTop().m_value;
+}
+// end of SlidingQuantileTracker::GetQuantile()
+
+
+// ==== SlidingQuantileTracker::GetNumSamples =================================
+//
+// This function returns the number of samples in the window.
+// ============================================================================
+template <class SampleType>
+int SlidingQuantileTracker<SampleType>::GetNumSamples(void) const
+{
+    return static_cast<int>(m_window.size());
+}
+// end of SlidingQuantileTracker::GetNumSamples()
+
+
+// ==== SlidingQuantileTracker::IsEmpty =======================================
+//
+// This function returns a boolean value if the window is empty.
+// ============================================================================
+template <class SampleType>
+bool SlidingQuantileTracker<SampleType>::IsEmpty(void) const
+{
+    return m_window.empty();
+}
+// end of SlidingQuantileTracker::IsEmpty()
+
+#endif // QUANTILETRACKER_H
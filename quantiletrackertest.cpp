@@ -0,0 +1,284 @@
+// ============================================================================
+// File: quantiletrackertest.cpp
+// ============================================================================
+// This is a driver that checks QuantileTracker, RunningMedian and
+// SlidingQuantileTracker against a sorted copy of the samples: random
+// streams at several quantile levels, Clear followed by a new stream, and a
+// window that slides by count and by time.
+//
+//      quantiletrackertest [seed]
+//              runs every check; prints the failures and exits with 1 if
+//              there are any
+// ============================================================================
+
+#include    <iostream>
+#include    <algorithm>
+#include    <cstdlib>
+#include    <random>
+#include    <vector>
+using namespace std;
+#include    "quantiletracker.h"
+
+// constants
+const   double  QUANTILES[] = { 0.0, 0.1, 0.25, 0.5, 0.9, 0.99, 1.0 };
+const   int     NUM_SAMPLES = 2000;     // samples per random stream
+const   int     WINDOW_LENGTH = 50;     // samples in the sliding window
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== ExpectedQuantile ======================================================
+//
+// This function returns the nearest-rank-below quantile of some samples by
+// sorting a copy of them.
+//
+// Input:
+//      samples     -- [IN]: the samples, not empty
+//      quantile    -- [IN]: the quantile, in [0, 1]
+//
+// Output:
+//      int -- [OUT]: the quantile sample
+// ============================================================================
+int     ExpectedQuantile(vector<int> samples, double quantile)
+{
+    sort(samples.begin(), samples.end());
+    return samples[GetQuantileRankCount(quantile, static_cast<int>(samples.size())) - 1];
+}
+// end of ExpectedQuantile()
+
+
+// ==== CheckStream ===========================================================
+//
+// This function feeds a random stream to a tracker at every quantile level
+// and checks the quantile after each sample.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckStream(mt19937 &random)
+{
+    for (double quantile : QUANTILES)
+    {
+        QuantileTracker<int>    tracker(quantile);
+        vector<int>             samples;
+        bool                    matches = true;
+
+        Check(tracker.IsEmpty(), "a new tracker is empty");
+        for (int index = 0; index < NUM_SAMPLES; ++index)
+        {
+            int sample = static_cast<int>(random() % 500);
+
+            tracker.Insert(sample);
+            samples.push_back(sample);
+            if ((index % 37 == 0) || (index == NUM_SAMPLES - 1))
+            {
+                matches = matches
+                          && (tracker.GetQuantile() == ExpectedQuantile(samples, quantile));
+            }
+        }
+        Check(matches, "the tracker matches the sorted samples");
+        Check(tracker.GetNumSamples() == NUM_SAMPLES, "the tracker counts its samples");
+    }
+}
+// end of CheckStream()
+
+
+// ==== CheckClear ============================================================
+//
+// This function checks that a cleared tracker is empty and then tracks a new
+// stream as a new tracker would: both heaps must keep their order.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckClear(mt19937 &random)
+{
+    QuantileTracker<int>    tracker(0.5);
+
+    for (int sample = 1; sample <= 5; ++sample)
+    {
+        tracker.Insert(sample);
+    }
+    tracker.Clear();
+    Check(tracker.IsEmpty() && (tracker.GetNumSamples() == 0),
+          "Clear forgets every sample");
+
+    for (int sample = 1; sample <= 9; ++sample)
+    {
+        tracker.Insert(sample);
+    }
+    Check(tracker.GetQuantile() == 5, "the median of 1..9 after Clear is 5");
+
+    for (double quantile : QUANTILES)
+    {
+        QuantileTracker<int>    reused(quantile);
+        vector<int>             samples;
+
+        for (int round = 0; round < 3; ++round)
+        {
+            bool matches = true;
+
+            reused.Clear();
+            samples.clear();
+            for (int index = 0; index < 200; ++index)
+            {
+                int sample = static_cast<int>(random() % 100);
+
+                reused.Insert(sample);
+                samples.push_back(sample);
+                matches = matches
+                          && (reused.GetQuantile() == ExpectedQuantile(samples, quantile));
+            }
+            Check(matches, "a tracker reused after Clear matches the sorted samples");
+        }
+    }
+}
+// end of CheckClear()
+
+
+// ==== CheckRunningMedian ====================================================
+//
+// This function checks the lower median and the interpolated median of a
+// RunningMedian, with odd and even sample counts.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckRunningMedian(mt19937 &random)
+{
+    RunningMedian<int>  median;
+    vector<int>         samples;
+    bool                matches = true;
+
+    for (int index = 0; index < 500; ++index)
+    {
+        int sample = static_cast<int>(random() % 1000);
+
+        median.Insert(sample);
+        samples.push_back(sample);
+
+        vector<int> sorted(samples);
+        sort(sorted.begin(), sorted.end());
+
+        size_t  middle = (sorted.size() - 1) / 2;
+        double  expected = (sorted.size() % 2 == 1)
+                           ? sorted[middle]
+                           : (sorted[middle] + sorted[middle + 1]) / 2.0;
+        matches = matches && (median.GetQuantile() == sorted[middle])
+                  && (median.GetMedian() == expected);
+    }
+    Check(matches, "the running median matches the sorted samples");
+}
+// end of CheckRunningMedian()
+
+
+// ==== CheckSlidingWindow ====================================================
+//
+// This function checks a SlidingQuantileTracker that keeps the last
+// WINDOW_LENGTH samples, and one whose samples expire by time.
+//
+// Input:
+//      random      -- [IN/OUT]: the random generator
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckSlidingWindow(mt19937 &random)
+{
+    for (double quantile : QUANTILES)
+    {
+        SlidingQuantileTracker<int> byCount(quantile, WINDOW_LENGTH);
+        SlidingQuantileTracker<int> byTime(quantile);
+        vector<int>                 samples;
+        bool                        countMatches = true;
+        bool                        timeMatches = true;
+
+        for (int index = 0; index < NUM_SAMPLES; ++index)
+        {
+            int sample = static_cast<int>(random() % 300);
+
+            byCount.Insert(sample);
+            byTime.Insert(sample, index);
+            if (index + 1 >= WINDOW_LENGTH)
+            {
+                byTime.ExpireBefore(index + 1 - WINDOW_LENGTH);
+            }
+            samples.push_back(sample);
+
+            int         first = max(0, index + 1 - WINDOW_LENGTH);
+            vector<int> window(samples.begin() + first, samples.end());
+            int         expected = ExpectedQuantile(window, quantile);
+
+            countMatches = countMatches && (byCount.GetQuantile() == expected)
+                           && (byCount.GetNumSamples() == static_cast<int>(window.size()));
+            timeMatches = timeMatches && (byTime.GetQuantile() == expected)
+                          && (byTime.GetNumSamples() == static_cast<int>(window.size()));
+        }
+        Check(countMatches, "a count window matches the sorted window");
+        Check(timeMatches, "a time window matches the sorted window");
+    }
+}
+// end of CheckSlidingWindow()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      argc, argv  -- [IN]: an optional random seed
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(int argc, char *argv[])
+{
+    mt19937 random((argc > 1) ? static_cast<unsigned>(atoi(argv[1])) : 7);
+
+    CheckStream(random);
+    CheckClear(random);
+    CheckRunningMedian(random);
+    CheckSlidingWindow(random);
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all quantile tracker checks passed" << endl;
+    return 0;
+}
+// end of main()
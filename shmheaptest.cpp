@@ -0,0 +1,572 @@
+// ============================================================================
+// File: shmheaptest.cpp
+// ============================================================================
+// This is a driver that checks CShmMaxMinHeap across forked processes:
+// producers and consumers sharing one segment, a process that dies holding
+// the heap lock, a creator that dies before finishing the segment, corrupt
+// headers, and PopN with an output iterator that throws.
+//
+//      shmheaptest
+//              runs every check; prints the failures and exits with 1 if
+//              there are any
+//
+// Build with -pthread (and -lrt on older glibc).
+// ============================================================================
+
+#include    <iostream>
+#include    <algorithm>
+#include    <cstdlib>
+#include    <iterator>
+#include    <stdexcept>
+#include    <vector>
+#include    <sys/wait.h>
+using namespace std;
+#include    "cshmmaxminheap.h"
+
+// constants
+const   char    *SEGMENT_NAME = "/shmheaptest";
+const   int     NUM_JOBS = 20000;
+const   int     NUM_WORKERS = 4;
+
+// a job as the processes pass it around
+struct  CJob
+{
+    int     m_priority;
+    int     m_id;
+
+    bool operator<(const CJob &rhs) const { return (m_priority < rhs.m_priority); }
+    bool operator>(const CJob &rhs) const { return (m_priority > rhs.m_priority); }
+};
+
+// what a consumer reports back through its pipe
+struct  CConsumerReport
+{
+    long    m_numJobs;
+    long    m_sumOfIds;
+    long    m_inOrder;
+};
+
+// an output iterator that fails after a number of items
+class   CFailingOutput
+{
+public:
+    typedef output_iterator_tag     iterator_category;
+    typedef void                    value_type;
+    typedef void                    difference_type;
+    typedef void                    pointer;
+    typedef void                    reference;
+
+    CFailingOutput(vector<CJob> &target, int numAccepted)
+                    : m_target(&target), m_numAccepted(numAccepted) {}
+
+    CFailingOutput& operator=(const CJob &job)
+    {
+        if (static_cast<int>(m_target->size()) >= m_numAccepted)
+        {
+            throw runtime_error("output full");
+        }
+        m_target->push_back(job);
+        return *this;
+    }
+    CFailingOutput& operator*() { return *this; }
+    CFailingOutput& operator++() { return *this; }
+    CFailingOutput  operator++(int) { return *this; }
+
+private:
+    vector<CJob>    *m_target;
+    int             m_numAccepted;
+};
+
+// global variables
+int     g_numFailures = 0;
+
+
+// ==== Check =================================================================
+//
+// This function counts and reports a failed check.
+//
+// Input:
+//      passed      -- [IN]: the outcome of the check
+//      what        -- [IN]: a description of the check
+//
+// Output:
+//      bool -- [OUT]: passed
+// ============================================================================
+bool    Check(bool passed, const char *what)
+{
+    if (!passed)
+    {
+        cout << "FAILED: " << what << endl;
+        ++g_numFailures;
+    }
+
+    return passed;
+}
+// end of Check()
+
+
+// ==== WaitForChildren =======================================================
+//
+// This function waits for a number of child processes.
+//
+// Input:
+//      numChildren -- [IN]: the number of children to reap
+//
+// Output:
+//      bool -- [OUT]: true if every child exited with status 0
+// ============================================================================
+bool    WaitForChildren(int numChildren)
+{
+    bool allPassed = true;
+    int status;
+
+    for (int child = 0; child < numChildren; ++child)
+    {
+        if ((wait(&status) < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+        {
+            allPassed = false;
+        }
+    }
+
+    return allPassed;
+}
+// end of WaitForChildren()
+
+
+// ==== MapRawHeader ==========================================================
+//
+// This function maps a segment's header the way a process that bypasses
+// CShmMaxMinHeap would, to kill it mid-operation or corrupt it.
+//
+// Input:
+//      segmentDesc -- [IN]: a descriptor of the segment
+//
+// Output:
+//      CShmHeapHeader* -- [OUT]: the mapped header, or NULL
+// ============================================================================
+CShmHeapHeader* MapRawHeader(int segmentDesc)
+{
+    struct stat segmentStatus;
+
+    if (fstat(segmentDesc, &segmentStatus) != 0)
+    {
+        return NULL;
+    }
+
+    void *address = mmap(NULL, segmentStatus.st_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, segmentDesc, 0);
+
+    return (address == MAP_FAILED) ? NULL : static_cast<CShmHeapHeader *>(address);
+}
+// end of MapRawHeader()
+
+
+// ==== CheckProducersAndConsumers ============================================
+//
+// This function fills a MAX heap from forked producers, then drains it from
+// forked consumers; each consumer must see its jobs in priority order, and
+// together they must see every job exactly once.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckProducersAndConsumers(void)
+{
+    CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MAX, NUM_JOBS);
+    int pipeDescs[2];
+
+    for (int worker = 0; worker < NUM_WORKERS; ++worker)
+    {
+        if (fork() == 0)
+        {
+            CShmMaxMinHeap<CJob> producer(SEGMENT_NAME);
+            for (int id = worker; id < NUM_JOBS; id += NUM_WORKERS)
+            {
+                CJob job = { (id * 7919) % NUM_JOBS, id };
+                producer.Insert(job);
+            }
+            _exit(0);
+        }
+    }
+    Check(WaitForChildren(NUM_WORKERS), "the producers exit cleanly");
+    Check(heap.GetNumItems() == NUM_JOBS, "every produced job is in the heap");
+
+    try
+    {
+        CJob extra = { 1, 1 };
+        heap.Insert(extra);
+        Check(false, "Insert into a full segment throws");
+    }
+    catch (const CShmHeapException &exception)
+    {
+        Check(exception.GetException() == SHM_HEAP_FULL,
+              "Insert into a full segment throws SHM_HEAP_FULL");
+    }
+
+    if (pipe(pipeDescs) != 0)
+    {
+        Check(false, "pipe");
+        return;
+    }
+    for (int worker = 0; worker < NUM_WORKERS; ++worker)
+    {
+        if (fork() == 0)
+        {
+            CShmMaxMinHeap<CJob> consumer(SEGMENT_NAME);
+            CConsumerReport report = { 0, 0, 1 };
+            int lastPriority = NUM_JOBS;
+            CJob job;
+
+            while (consumer.TryPop(job))
+            {
+                if (job.m_priority > lastPriority)
+                {
+                    report.m_inOrder = 0;
+                }
+                lastPriority = job.m_priority;
+                report.m_numJobs++;
+                report.m_sumOfIds += job.m_id;
+            }
+            _exit((write(pipeDescs[1], &report, sizeof(report)) == sizeof(report))
+                  ? 0 : 1);
+        }
+    }
+
+    CConsumerReport total = { 0, 0, 1 };
+    for (int worker = 0; worker < NUM_WORKERS; ++worker)
+    {
+        CConsumerReport report;
+        if (read(pipeDescs[0], &report, sizeof(report)) != sizeof(report))
+        {
+            total.m_inOrder = 0;
+            break;
+        }
+        total.m_numJobs += report.m_numJobs;
+        total.m_sumOfIds += report.m_sumOfIds;
+        total.m_inOrder = total.m_inOrder && report.m_inOrder;
+    }
+    close(pipeDescs[0]);
+    close(pipeDescs[1]);
+
+    Check(WaitForChildren(NUM_WORKERS), "the consumers exit cleanly");
+    Check(total.m_inOrder != 0, "each consumer pops in priority order");
+    Check((total.m_numJobs == NUM_JOBS)
+          && (total.m_sumOfIds == static_cast<long>(NUM_JOBS) * (NUM_JOBS - 1) / 2),
+          "the consumers pop every job exactly once");
+    Check(heap.IsEmpty(), "the heap is empty after draining");
+}
+// end of CheckProducersAndConsumers()
+
+
+// ==== CheckDeadLockOwner ====================================================
+//
+// This function lets a child take the heap lock, break the heap order and
+// die; the next lock returns EOWNERDEAD, after which the heap must be
+// rebuilt and drain in order.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckDeadLockOwner(void)
+{
+    CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MAX, NUM_JOBS);
+
+    for (int id = 0; id < 100; ++id)
+    {
+        CJob job = { id, id };
+        heap.Insert(job);
+    }
+
+    if (fork() == 0)
+    {
+        int segmentDesc = shm_open(SEGMENT_NAME, O_RDWR, 0);
+        CShmHeapHeader *header = MapRawHeader(segmentDesc);
+        if (header == NULL)
+        {
+            _exit(1);
+        }
+        pthread_mutex_lock(&header->m_lock);
+        CJob *items = reinterpret_cast<CJob *>(header + 1);
+        swap(items[0], items[99]);
+        _exit(0);
+    }
+    Check(WaitForChildren(1), "the lock owner exits");
+
+    CJob job;
+    int lastPriority = 100;
+    int numPopped = 0;
+    bool inOrder = true;
+    while (heap.TryPop(job))
+    {
+        inOrder = inOrder && (job.m_priority <= lastPriority);
+        lastPriority = job.m_priority;
+        ++numPopped;
+    }
+    Check(inOrder, "the heap order is rebuilt after EOWNERDEAD");
+    Check(numPopped == 100, "no item is lost after EOWNERDEAD");
+}
+// end of CheckDeadLockOwner()
+
+
+// ==== CheckAbandonedCreation ================================================
+//
+// This function lets a child win the creation of the segment and die before
+// setting it up, at two points: holding the flock on an empty segment, and
+// after sizing it. An opener must then finish the segment itself instead of
+// failing for good.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckAbandonedCreation(void)
+{
+    for (int diesAfterSizing = 0; diesAfterSizing < 2; ++diesAfterSizing)
+    {
+        CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+
+        if (fork() == 0)
+        {
+            int segmentDesc = shm_open(SEGMENT_NAME, O_RDWR | O_CREAT | O_EXCL,
+                                       0600);
+            if ((segmentDesc < 0) || (flock(segmentDesc, LOCK_EX) != 0))
+            {
+                _exit(1);
+            }
+            if (diesAfterSizing
+                && (ftruncate(segmentDesc,
+                              ShmHeapSegmentSize(16, sizeof(CJob))) != 0))
+            {
+                _exit(1);
+            }
+            _exit(0);
+        }
+        Check(WaitForChildren(1), "the creator exits");
+
+        try
+        {
+            CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MIN, 50);
+            CJob job = { 3, 3 };
+
+            heap.Insert(job);
+            Check((heap.GetCapacity() == 50) && (heap.GetHeapType() == MIN),
+                  "an abandoned segment is set up by the next opener");
+            Check(heap.TryPop(job) && (job.m_id == 3),
+                  "a recovered segment works");
+        }
+        catch (const CShmHeapException &)
+        {
+            Check(false, "an abandoned creation does not wedge the name");
+        }
+    }
+
+    // a creator that is slow, not dead: the opener waits for it, and both
+    // end up on the one segment set up by whichever got the flock first
+    CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+    int pipeDescs[2];
+    char ready = 0;
+    int status = 0;
+    if (pipe(pipeDescs) != 0)
+    {
+        Check(false, "pipe");
+        return;
+    }
+    pid_t creatorId = fork();
+    if (creatorId == 0)
+    {
+        int segmentDesc = shm_open(SEGMENT_NAME, O_RDWR | O_CREAT | O_EXCL,
+                                   0600);
+        if ((segmentDesc < 0) || (flock(segmentDesc, LOCK_EX) != 0)
+            || (write(pipeDescs[1], "x", 1) != 1))
+        {
+            _exit(1);
+        }
+        usleep(300000);
+        flock(segmentDesc, LOCK_UN);
+        close(segmentDesc);
+
+        CShmMaxMinHeap<CJob> creator(SEGMENT_NAME, MAX, 20);
+        _exit(creator.GetCapacity());
+    }
+    if (read(pipeDescs[0], &ready, 1) == 1)
+    {
+        try
+        {
+            CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MAX, 30);
+            waitpid(creatorId, &status, 0);
+            Check(((heap.GetCapacity() == 20) || (heap.GetCapacity() == 30))
+                  && WIFEXITED(status)
+                  && (WEXITSTATUS(status) == heap.GetCapacity()),
+                  "an opener and a slow creator share one segment");
+        }
+        catch (const CShmHeapException &)
+        {
+            Check(false, "an opener waits for a slow creator");
+            waitpid(creatorId, &status, 0);
+        }
+    }
+    else
+    {
+        Check(false, "the slow creator starts");
+        waitpid(creatorId, &status, 0);
+    }
+    close(pipeDescs[0]);
+    close(pipeDescs[1]);
+}
+// end of CheckAbandonedCreation()
+
+
+// ==== CheckCorruptHeaders ===================================================
+//
+// This function corrupts a finished header in the ways that would make the
+// sifts run out of bounds, and checks that opening it is refused.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckCorruptHeaders(void)
+{
+    for (int corruption = 0; corruption < 3; ++corruption)
+    {
+        CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+        {
+            CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MAX, 10);
+        }
+
+        int segmentDesc = shm_open(SEGMENT_NAME, O_RDWR, 0);
+        CShmHeapHeader *header = MapRawHeader(segmentDesc);
+        if (header == NULL)
+        {
+            Check(false, "map the segment");
+            return;
+        }
+        switch (corruption)
+        {
+            case 0:  header->m_numItems = header->m_capacity + 1; break;
+            case 1:  header->m_heapType = 7; break;
+            default: header->m_capacity = 0; break;
+        }
+        munmap(header, ShmHeapSegmentSize(10, sizeof(CJob)));
+        close(segmentDesc);
+
+        try
+        {
+            CShmMaxMinHeap<CJob> heap(SEGMENT_NAME);
+            Check(false, "a corrupt header is refused");
+        }
+        catch (const CShmHeapException &exception)
+        {
+            Check(exception.GetException() == SHM_HEAP_BAD_FORMAT,
+                  "a corrupt header throws SHM_HEAP_BAD_FORMAT");
+        }
+    }
+}
+// end of CheckCorruptHeaders()
+
+
+// ==== CheckPopN =============================================================
+//
+// This function pops batches on both sides of the selection threshold, then
+// lets the output iterator throw halfway through a batch: the exception must
+// reach the caller and the shared heap must stay in order.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+void    CheckPopN(void)
+{
+    CShmMaxMinHeap<CJob> heap(SEGMENT_NAME, MAX, 1000);
+    vector<CJob> popped;
+
+    for (int id = 0; id < 1000; ++id)
+    {
+        CJob job = { id, id };
+        heap.Insert(job);
+    }
+
+    Check((heap.PopN(10, back_inserter(popped)) == 10)
+          && (popped.front().m_priority == 999) && (popped.back().m_priority == 990),
+          "a small PopN pops the best items in order");
+    popped.clear();
+    Check((heap.PopN(500, back_inserter(popped)) == 500)
+          && (popped.front().m_priority == 989) && (popped.back().m_priority == 490)
+          && (heap.GetNumItems() == 490) && (heap.PeekTop().m_priority == 489),
+          "a large PopN pops the best items in order");
+
+    for (int count : { 10, 300 })
+    {
+        bool caught = false;
+
+        popped.clear();
+        try
+        {
+            heap.PopN(count, CFailingOutput(popped, count / 2));
+        }
+        catch (const runtime_error &)
+        {
+            caught = true;
+        }
+        Check(caught && (static_cast<int>(popped.size()) == count / 2),
+              "an output iterator's exception reaches PopN's caller");
+    }
+
+    CJob job;
+    int lastPriority = 1000;
+    int numLeft = 0;
+    bool inOrder = true;
+    while (heap.TryPop(job))
+    {
+        inOrder = inOrder && (job.m_priority <= lastPriority);
+        lastPriority = job.m_priority;
+        ++numLeft;
+    }
+    Check(inOrder && (numLeft == 490 - 10 - 300),
+          "the heap stays in order when the output iterator throws");
+}
+// end of CheckPopN()
+
+
+// ==== main ==================================================================
+//
+// Input:
+//      void
+//
+// Output:
+//      int -- [OUT]: 0 if every check passed, 1 otherwise
+// ============================================================================
+int     main(void)
+{
+    CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+    CheckProducersAndConsumers();
+    CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+    CheckDeadLockOwner();
+    CheckAbandonedCreation();
+    CheckCorruptHeaders();
+    CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+    CheckPopN();
+    CShmMaxMinHeap<CJob>::Unlink(SEGMENT_NAME);
+
+    if (g_numFailures > 0)
+    {
+        cout << g_numFailures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "all shared-memory heap checks passed" << endl;
+    return 0;
+}
+// end of main()
@@ -0,0 +1,483 @@
+// ============================================================================
+// File: smallmaxminheap.h
+// ============================================================================
+// Header file for the SmallMaxMinHeap class, a growable heap with a small
+// buffer of N items inside the object.
+//
+// The first N items live in the inline buffer, so a queue that never holds
+// more than N items makes no allocation at all. Past N the items move to a
+// heap array that doubles as needed, exactly like CMaxMinHeap.
+// ============================================================================
+#ifndef SMALLMAXMINHEAP_H
+#define SMALLMAXMINHEAP_H
+
+#include    <optional>
+#include    <utility>
+#include    "cmaxminheap.h"
+#include    "heapsift.h"
+
+// constants
+const   int SMALL_HEAP_INLINE_ITEMS = 16;
+
+
+// class declaration
+template <class HeapItemType, int N = SMALL_HEAP_INLINE_ITEMS>
+class   SmallMaxMinHeap
+{
+    static_assert(N > 0, "SmallMaxMinHeap needs room for at least one item");
+
+public:
+    // constructors and destructor
+    SmallMaxMinHeap(int heapType = MAX);
+    SmallMaxMinHeap(const SmallMaxMinHeap &otherObj);
+    SmallMaxMinHeap(SmallMaxMinHeap &&otherObj);
+    virtual ~SmallMaxMinHeap();
+
+    // member functions
+    bool            Insert(const HeapItemType  &newItem);
+    bool            Remove(HeapItemType &item);
+    HeapItemType    PeekTop(void) const;
+
+    // exception-free versions of Insert, Remove and PeekTop
+    bool                        TryPush(const HeapItemType  &newItem) noexcept;
+    std::optional<HeapItemType> TryPop(void) noexcept;
+    const HeapItemType*         TryPeek(void) const noexcept;
+
+    // Helper functions
+    void            Clear(void);
+    int             GetCapacity(void) const;
+    int             GetHeapType(void) const;
+    int             GetNumItems(void) const;
+    bool            IsEmpty(void) const;
+    bool            IsInline(void) const;
+
+    // overloaded operator(s)
+    SmallMaxMinHeap&    operator=(const SmallMaxMinHeap &rhs);
+
+private:
+    // data members
+    int             m_heapType;         // MAX or MIN
+    int             m_numItems;         // number of items in use
+    int             m_capacity;         // N, or the size of the heap array
+    HeapItemType    *m_items;           // m_inlineItems or a heap array
+    HeapItemType    m_inlineItems[N];   // the first N items
+
+    // utility functions
+    void            SetCapacity(int capacity);
+};
+
+
+// ==== SmallMaxMinHeap::SmallMaxMinHeap ======================================
+//
+// This is the constructor. It does not allocate.
+//
+// ============================================================================
+template <class HeapItemType, int N>
+SmallMaxMinHeap<HeapItemType, N>::SmallMaxMinHeap(int heapType)
+: m_heapType(heapType), m_numItems(0), m_capacity(N), m_items(m_inlineItems),
+  m_inlineItems()
+{
+}
+// end of SmallMaxMinHeap::SmallMaxMinHeap()
+
+
+// ==== SmallMaxMinHeap::SmallMaxMinHeap (Copy) ===============================
+//
+// This is the copy constructor. It allocates only if the source holds more
+// than N items.
+//
+// ============================================================================
+template <class HeapItemType, int N>
+SmallMaxMinHeap<HeapItemType, N>::SmallMaxMinHeap(const SmallMaxMinHeap &otherObj)
+: m_heapType(otherObj.m_heapType), m_numItems(0), m_capacity(N),
+  m_items(m_inlineItems), m_inlineItems()
+{
+    *this = otherObj;
+}
+// end of SmallMaxMinHeap::SmallMaxMinHeap() (copy constructor)
+
+
+// ==== SmallMaxMinHeap::SmallMaxMinHeap (Move) ===============================
+//
+// This is the move constructor. A heap array is taken over; inline items are
+// moved one by one.
+//
+// ============================================================================
+template <class HeapItemType, int N>
+SmallMaxMinHeap<HeapItemType, N>::SmallMaxMinHeap(SmallMaxMinHeap &&otherObj)
+: m_heapType(otherObj.m_heapType), m_numItems(otherObj.m_numItems),
+  m_capacity(N), m_items(m_inlineItems), m_inlineItems()
+{
+    if (otherObj.IsInline())
+    {
+        for (int index = 0; index < m_numItems; ++index)
+        {
+            m_inlineItems[index] = std::move(otherObj.m_inlineItems[index]);
+        }
+    }
+    else
+    {
+        m_items = otherObj.m_items;
+        m_capacity = otherObj.m_capacity;
+        otherObj.m_items = otherObj.m_inlineItems;
+        otherObj.m_capacity = N;
+    }
+
+    otherObj.m_numItems = 0;
+}
+// end of SmallMaxMinHeap::SmallMaxMinHeap() (move constructor)
+
+
+// ==== SmallMaxMinHeap::~SmallMaxMinHeap =====================================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class HeapItemType, int N>
+SmallMaxMinHeap<HeapItemType, N>::~SmallMaxMinHeap()
+{
+    if (!IsInline())
+    {
+        delete [] m_items;
+    }
+}
+// end of SmallMaxMinHeap::~SmallMaxMinHeap()
+
+
+// ==== SmallMaxMinHeap::operator= ============================================
+//
+// This is the overloaded assignment operator.
+//
+// Input:
+//      rhs     -- [IN]: the heap to copy
+//
+// Output:
+//      A reference to the calling object.
+// ============================================================================
+template <class HeapItemType, int N>
+SmallMaxMinHeap<HeapItemType, N>&
+SmallMaxMinHeap<HeapItemType, N>::operator=(const SmallMaxMinHeap &rhs)
+{
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    m_numItems = 0;
+    if (rhs.m_numItems > m_capacity)
+    {
+        SetCapacity(rhs.m_numItems);
+    }
+
+    for (int index = 0; index < rhs.m_numItems; ++index)
+    {
+        m_items[index] = rhs.m_items[index];
+    }
+    m_numItems = rhs.m_numItems;
+    m_heapType = rhs.m_heapType;
+
+    return *this;
+}
+// end of SmallMaxMinHeap::operator=()
+
+
+// ==== SmallMaxMinHeap::SetCapacity ==========================================
+//
+// This function moves the items to a heap array of the given capacity. If
+// an item cannot be moved, the new array is freed and the heap keeps its
+// old one.
+//
+// Input:
+//      capacity    -- [IN]: the new capacity (larger than N)
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int N>
+void SmallMaxMinHeap<HeapItemType, N>::SetCapacity(int capacity)
+{
+    HeapItemType *newItems = new HeapItemType[capacity];
+
+    try
+    {
+        for (int index = 0; index < m_numItems; ++index)
+        {
+            newItems[index] = std::move(m_items[index]);
+        }
+    }
+    catch (...)
+    {
+        // the heap keeps its old array; only the new one is dropped
+        delete [] newItems;
+        throw;
+    }
+
+    if (!IsInline())
+    {
+        delete [] m_items;
+    }
+
+    m_items = newItems;
+    m_capacity = capacity;
+}
+// end of SmallMaxMinHeap::SetCapacity()
+
+
+// ==== SmallMaxMinHeap::TryPush ==============================================
+//
+// This function inserts an element without throwing. It spills to a heap
+// array when the inline buffer is full.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if there was no memory for the item
+// ============================================================================
+template <class HeapItemType, int N>
+bool SmallMaxMinHeap<HeapItemType, N>::TryPush(const HeapItemType  &newItem)
+noexcept
+{
+    try
+    {
+        if (m_numItems == m_capacity)
+        {
+            SetCapacity(2 * m_capacity);
+        }
+
+        m_items[m_numItems] = newItem;
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    if (m_heapType == MAX)
+    {
+        HeapSiftUp(m_items, m_numItems, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftUp(m_items, m_numItems, CHeapMinOrder<HeapItemType>());
+    }
+    m_numItems++;
+
+    return true;
+}
+// end of SmallMaxMinHeap::TryPush()
+
+
+// ==== SmallMaxMinHeap::TryPop ===============================================
+//
+// This function removes the top element without throwing.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no
+//                                     value if the heap is empty
+// ============================================================================
+template <class HeapItemType, int N>
+std::optional<HeapItemType> SmallMaxMinHeap<HeapItemType, N>::TryPop(void)
+noexcept
+{
+    if (m_numItems == 0)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<HeapItemType> item;
+    try
+    {
+        item = std::move(m_items[0]);
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+
+    m_numItems--;
+    if (m_numItems > 0)
+    {
+        m_items[0] = std::move(m_items[m_numItems]);
+
+        if (m_heapType == MAX)
+        {
+            HeapSiftDown(m_items, m_numItems, 0, CHeapMaxOrder<HeapItemType>());
+        }
+        else
+        {
+            HeapSiftDown(m_items, m_numItems, 0, CHeapMinOrder<HeapItemType>());
+        }
+    }
+
+    return item;
+}
+// end of SmallMaxMinHeap::TryPop()
+
+
+// ==== SmallMaxMinHeap::TryPeek ==============================================
+//
+// This function peeks the top element without copying it.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the top element, NULL if empty
+// ============================================================================
+template <class HeapItemType, int N>
+const HeapItemType* SmallMaxMinHeap<HeapItemType, N>::TryPeek(void) const
+noexcept
+{
+    return (m_numItems > 0) ? &m_items[0] : NULL;
+}
+// end of SmallMaxMinHeap::TryPeek()
+
+
+// ==== SmallMaxMinHeap::Insert ===============================================
+//
+// This function inserts an element.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_FULL) is thrown
+// ============================================================================
+template <class HeapItemType, int N>
+bool SmallMaxMinHeap<HeapItemType, N>::Insert(const HeapItemType  &newItem)
+{
+    if (!TryPush(newItem))
+    {
+        throw CMaxMinHeapException(HEAP_FULL);
+    }
+
+    return true;
+}
+// end of SmallMaxMinHeap::Insert()
+
+
+// ==== SmallMaxMinHeap::Remove ===============================================
+//
+// This function removes the top element.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_EMPTY) is thrown
+// ============================================================================
+template <class HeapItemType, int N>
+bool SmallMaxMinHeap<HeapItemType, N>::Remove(HeapItemType &item)
+{
+    std::optional<HeapItemType> top = TryPop();
+
+    if (!top)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    item = std::move(*top);
+
+    return true;
+}
+// end of SmallMaxMinHeap::Remove()
+
+
+// ==== SmallMaxMinHeap::PeekTop ==============================================
+//
+// This function peeks the top element.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType, int N>
+HeapItemType SmallMaxMinHeap<HeapItemType, N>::PeekTop(void) const
+{
+    if (m_numItems == 0)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return m_items[0];
+}
+// end of SmallMaxMinHeap::PeekTop()
+
+
+// ==== SmallMaxMinHeap::Clear ================================================
+//
+// This function removes every element. A heap array is kept for reuse.
+// ============================================================================
+template <class HeapItemType, int N>
+void SmallMaxMinHeap<HeapItemType, N>::Clear(void)
+{
+    m_numItems = 0;
+}
+// end of SmallMaxMinHeap::Clear()
+
+
+// ==== SmallMaxMinHeap::GetCapacity ==========================================
+//
+// This function returns the number of items that fit without allocating.
+// ============================================================================
+template <class HeapItemType, int N>
+int SmallMaxMinHeap<HeapItemType, N>::GetCapacity(void) const
+{
+    return m_capacity;
+}
+// end of SmallMaxMinHeap::GetCapacity()
+
+
+// ==== SmallMaxMinHeap::GetHeapType ==========================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType, int N>
+int SmallMaxMinHeap<HeapItemType, N>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of SmallMaxMinHeap::GetHeapType()
+
+
+// ==== SmallMaxMinHeap::GetNumItems ==========================================
+//
+// This function returns the number of elements.
+// ============================================================================
+template <class HeapItemType, int N>
+int SmallMaxMinHeap<HeapItemType, N>::GetNumItems(void) const
+{
+    return m_numItems;
+}
+// end of SmallMaxMinHeap::GetNumItems()
+
+
+// ==== SmallMaxMinHeap::IsEmpty ==============================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType, int N>
+bool SmallMaxMinHeap<HeapItemType, N>::IsEmpty(void) const
+{
+    return (m_numItems == 0);
+}
+// end of SmallMaxMinHeap::IsEmpty()
+
+
+// ==== SmallMaxMinHeap::IsInline =============================================
+//
+// This function returns true while the items live in the inline buffer.
+// ============================================================================
+template <class HeapItemType, int N>
+bool SmallMaxMinHeap<HeapItemType, N>::IsInline(void) const
+{
+    return (m_items == m_inlineItems);
+}
+// end of SmallMaxMinHeap::IsInline()
+
+#endif // SMALLMAXMINHEAP_H
@@ -0,0 +1,391 @@
+// ============================================================================
+// File: staticmaxminheap.h
+// ============================================================================
+// Header file for the StaticMaxMinHeap class, a heap with a fixed capacity
+// of N items stored inside the object.
+//
+// The heap never allocates: Insert throws CMaxMinHeapException(HEAP_FULL)
+// and TryPush returns false once N items are stored. It is meant for real
+// time paths and for small queues that can live on the stack or inside
+// another object.
+//
+// Under C++20 the heap is a literal type for literal item types: it can be
+// filled and drained in a constant expression, and MakeHeapOrderedTable
+// builds a priority-ordered std::array at compile time.
+// ============================================================================
+#ifndef STATICMAXMINHEAP_H
+#define STATICMAXMINHEAP_H
+
+#include    <array>
+#include    <optional>
+#include    <utility>
+#include    "cmaxminheap.h"
+#include    "heapsift.h"
+
+
+// class declaration
+template <class HeapItemType, int N>
+class   StaticMaxMinHeap
+{
+    static_assert(N > 0, "StaticMaxMinHeap needs room for at least one item");
+
+public:
+    // constructor
+    HEAP_CONSTEXPR  StaticMaxMinHeap(int heapType = MAX);
+
+    // member functions
+    HEAP_CONSTEXPR bool         Insert(const HeapItemType  &newItem);
+    HEAP_CONSTEXPR bool         Remove(HeapItemType &item);
+    HEAP_CONSTEXPR HeapItemType PeekTop(void) const;
+
+    // exception-free versions of Insert, Remove and PeekTop
+    HEAP_CONSTEXPR bool         TryPush(const HeapItemType  &newItem) noexcept;
+    std::optional<HeapItemType> TryPop(void) noexcept;
+    HEAP_CONSTEXPR const HeapItemType*  TryPeek(void) const noexcept;
+
+    // Helper functions
+    HEAP_CONSTEXPR void         Clear(void);
+    HEAP_CONSTEXPR int          GetCapacity(void) const;
+    HEAP_CONSTEXPR int          GetHeapType(void) const;
+    HEAP_CONSTEXPR int          GetNumItems(void) const;
+    HEAP_CONSTEXPR bool         IsEmpty(void) const;
+    HEAP_CONSTEXPR bool         IsFull(void) const;
+
+private:
+    // data members
+    int             m_heapType; // MAX or MIN
+    int             m_numItems; // number of items in use
+    HeapItemType    m_items[N]; // the items, in heap order
+
+    // utility functions
+    HEAP_CONSTEXPR void         PopTop(HeapItemType &item);
+};
+
+
+// ==== StaticMaxMinHeap::StaticMaxMinHeap ====================================
+//
+// This is the constructor.
+//
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR StaticMaxMinHeap<HeapItemType, N>::StaticMaxMinHeap(int heapType)
+: m_heapType(heapType), m_numItems(0), m_items()
+{
+}
+// end of StaticMaxMinHeap::StaticMaxMinHeap()
+
+
+// ==== StaticMaxMinHeap::TryPush =============================================
+//
+// This function inserts an element without throwing.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: false if the heap is full
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR bool StaticMaxMinHeap<HeapItemType, N>::TryPush(const HeapItemType  &newItem)
+noexcept
+{
+    if (m_numItems == N)
+    {
+        return false;
+    }
+
+    try
+    {
+        m_items[m_numItems] = newItem;
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    if (m_heapType == MAX)
+    {
+        HeapSiftUp(m_items, m_numItems, CHeapMaxOrder<HeapItemType>());
+    }
+    else
+    {
+        HeapSiftUp(m_items, m_numItems, CHeapMinOrder<HeapItemType>());
+    }
+    m_numItems++;
+
+    return true;
+}
+// end of StaticMaxMinHeap::TryPush()
+
+
+// ==== StaticMaxMinHeap::PopTop ==============================================
+//
+// This function moves the top element out and restores the heap order. The
+// heap must not be empty.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR void StaticMaxMinHeap<HeapItemType, N>::PopTop(HeapItemType &item)
+{
+    item = std::move(m_items[0]);
+
+    m_numItems--;
+    if (m_numItems > 0)
+    {
+        m_items[0] = std::move(m_items[m_numItems]);
+
+        if (m_heapType == MAX)
+        {
+            HeapSiftDown(m_items, m_numItems, 0, CHeapMaxOrder<HeapItemType>());
+        }
+        else
+        {
+            HeapSiftDown(m_items, m_numItems, 0, CHeapMinOrder<HeapItemType>());
+        }
+    }
+}
+// end of StaticMaxMinHeap::PopTop()
+
+
+// ==== StaticMaxMinHeap::TryPop ==============================================
+//
+// This function removes the top element without throwing.
+//
+// Input:
+//      void
+//
+// Output:
+//      std::optional<HeapItemType> -- [OUT]: the removed element, or no
+//                                     value if the heap is empty
+// ============================================================================
+template <class HeapItemType, int N>
+std::optional<HeapItemType> StaticMaxMinHeap<HeapItemType, N>::TryPop(void)
+noexcept
+{
+    if (m_numItems == 0)
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        HeapItemType item;
+
+        PopTop(item);
+
+        return item;
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+}
+// end of StaticMaxMinHeap::TryPop()
+
+
+// ==== StaticMaxMinHeap::TryPeek =============================================
+//
+// This function peeks the top element without copying it.
+//
+// Input:
+//      void
+//
+// Output:
+//      const HeapItemType* -- [OUT]: the top element, NULL if empty
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR const HeapItemType* StaticMaxMinHeap<HeapItemType, N>::TryPeek(void) const
+noexcept
+{
+    return (m_numItems > 0) ? &m_items[0] : NULL;
+}
+// end of StaticMaxMinHeap::TryPeek()
+
+
+// ==== StaticMaxMinHeap::Insert ==============================================
+//
+// This function inserts an element.
+//
+// Input:
+//      const HeapItemType  &newItem -- [IN]: the item to insert
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_FULL) is thrown
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR bool StaticMaxMinHeap<HeapItemType, N>::Insert(const HeapItemType  &newItem)
+{
+    if (!TryPush(newItem))
+    {
+        throw CMaxMinHeapException(HEAP_FULL);
+    }
+
+    return true;
+}
+// end of StaticMaxMinHeap::Insert()
+
+
+// ==== StaticMaxMinHeap::Remove ==============================================
+//
+// This function removes the top element.
+//
+// Input:
+//      HeapItemType  &item -- [OUT]: receives the removed element
+//
+// Output:
+//      bool -- [OUT]: true, or CMaxMinHeapException(HEAP_EMPTY) is thrown
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR bool StaticMaxMinHeap<HeapItemType, N>::Remove(HeapItemType &item)
+{
+    if (m_numItems == 0)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    PopTop(item);
+
+    return true;
+}
+// end of StaticMaxMinHeap::Remove()
+
+
+// ==== StaticMaxMinHeap::PeekTop =============================================
+//
+// This function peeks the top element.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the top element
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR HeapItemType StaticMaxMinHeap<HeapItemType, N>::PeekTop(void) const
+{
+    if (m_numItems == 0)
+    {
+        throw CMaxMinHeapException(HEAP_EMPTY);
+    }
+
+    return m_items[0];
+}
+// end of StaticMaxMinHeap::PeekTop()
+
+
+// ==== StaticMaxMinHeap::Clear ===============================================
+//
+// This function removes every element.
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR void StaticMaxMinHeap<HeapItemType, N>::Clear(void)
+{
+    m_numItems = 0;
+}
+// end of StaticMaxMinHeap::Clear()
+
+
+// ==== StaticMaxMinHeap::GetCapacity =========================================
+//
+// This function returns the fixed capacity N.
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR int StaticMaxMinHeap<HeapItemType, N>::GetCapacity(void) const
+{
+    return N;
+}
+// end of StaticMaxMinHeap::GetCapacity()
+
+
+// ==== StaticMaxMinHeap::GetHeapType =========================================
+//
+// This function returns the type of the heap (MAX or MIN).
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR int StaticMaxMinHeap<HeapItemType, N>::GetHeapType(void) const
+{
+    return m_heapType;
+}
+// end of StaticMaxMinHeap::GetHeapType()
+
+
+// ==== StaticMaxMinHeap::GetNumItems =========================================
+//
+// This function returns the number of elements.
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR int StaticMaxMinHeap<HeapItemType, N>::GetNumItems(void) const
+{
+    return m_numItems;
+}
+// end of StaticMaxMinHeap::GetNumItems()
+
+
+// ==== StaticMaxMinHeap::IsEmpty =============================================
+//
+// This function returns a boolean value if the heap is empty.
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR bool StaticMaxMinHeap<HeapItemType, N>::IsEmpty(void) const
+{
+    return (m_numItems == 0);
+}
+// end of StaticMaxMinHeap::IsEmpty()
+
+
+// ==== StaticMaxMinHeap::IsFull ==============================================
+//
+// This function returns a boolean value if the heap holds N elements.
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR bool StaticMaxMinHeap<HeapItemType, N>::IsFull(void) const
+{
+    return (m_numItems == N);
+}
+// end of StaticMaxMinHeap::IsFull()
+
+
+
+// ==== MakeHeapOrderedTable ==================================================
+//
+// This function returns the items in the order a StaticMaxMinHeap would hand
+// them out. Under C++20 it can initialize a constexpr table, so a fixed
+// priority schedule costs nothing at startup:
+//
+//      constexpr int priorities[] = { 3, 9, 1 };
+//      constexpr auto schedule = MakeHeapOrderedTable(priorities);
+//
+// Input:
+//      items       -- [IN]: the items, in any order
+//      heapType    -- [IN]: MAX for the highest first, MIN for the lowest
+//
+// Output:
+//      std::array<HeapItemType, N> -- [OUT]: the items in priority order
+// ============================================================================
+template <class HeapItemType, int N>
+HEAP_CONSTEXPR std::array<HeapItemType, N>
+MakeHeapOrderedTable(const HeapItemType (&items)[N], int heapType = MAX)
+{
+    StaticMaxMinHeap<HeapItemType, N> heap(heapType);
+    std::array<HeapItemType, N> table{};
+
+    for (int index = 0; index < N; ++index)
+    {
+        heap.Insert(items[index]);
+    }
+
+    for (int index = 0; index < N; ++index)
+    {
+        heap.Remove(table[index]);
+    }
+
+    return table;
+}
+// end of MakeHeapOrderedTable()
+
+#endif // STATICMAXMINHEAP_H
@@ -0,0 +1,306 @@
+// ============================================================================
+// File: windowedtopk.h
+// ============================================================================
+// Header file for the WindowedTopK class: the best K items among those that
+// arrived within the last windowLength time units, for example the top
+// priorities of the last five minutes.
+//
+// Items sit in one heap ordered by item, with their arrival times. Nothing
+// is removed when an item expires: a FIFO of arrival times counts how many
+// stored items are past the window, expired items are dropped when they
+// reach the top of the heap, and once expired items outnumber live ones
+// they are all removed in one RemoveIf pass. Each item is therefore
+// inserted and removed once, for amortised O(log n) per item.
+//
+// TopK walks the heap through a CHeapTopView and skips the expired items it
+// meets: O((K + E) log(K + E)) for E expired items above the K-th live one,
+// and O(K log K) right after Advance has dropped the expired tops. The rest
+// of the heap is not touched.
+// ============================================================================
+#ifndef WINDOWEDTOPK_H
+#define WINDOWEDTOPK_H
+
+#include    <cstdint>
+#include    <deque>
+#include    "cmaxminheap.h"
+#include    "heapkey.h"
+
+// constants
+const   int     TOPK_COMPACT_MIN = 64;  // expired items before compacting
+
+
+// an item and its arrival time
+template <class HeapItemType>
+struct  CTimedItem
+{
+    HeapItemType    m_item;
+    uint64_t        m_time;
+};
+
+
+// class declaration
+template <class HeapItemType>
+class   WindowedTopK
+{
+public:
+    // constructor and destructor
+    WindowedTopK(uint64_t windowLength, int heapType = MAX);
+    virtual ~WindowedTopK();
+
+    // member functions
+    bool            Insert(const HeapItemType &item, uint64_t time);
+    int             Advance(uint64_t now);
+    HeapItemType    PeekTop(void) const;
+    template <class OutputIt>
+    int             TopK(int count, OutputIt output) const;
+
+    // Helper functions
+    uint64_t        GetWindowLength(void) const { return m_windowLength; }
+    int             GetNumItems(void) const;
+    int             GetNumExpired(void) const;
+    bool            IsEmpty(void) const;
+
+private:
+    typedef CTimedItem<HeapItemType>                    EntryType;
+    typedef CMaxMinHeap<EntryType, CImplicitHeapLayout,
+                        CHeapMemberKey<&EntryType::m_item> >    HeapType;
+
+    // data members
+    uint64_t                m_windowLength; // in the caller's time unit
+    uint64_t                m_cutoff;       // items before it are expired
+    uint64_t                m_lastTime;     // latest arrival time
+    HeapType                m_heap;         // live and expired items
+    std::deque<uint64_t>    m_liveTimes;    // arrival times of live items
+    int                     m_numExpired;   // expired items still stored
+
+    // utility functions
+    void            DropExpiredTops(void);
+};
+
+
+// ==== WindowedTopK::WindowedTopK ============================================
+//
+// This is the constructor.
+//
+// Input:
+//      windowLength    -- [IN]: how long an item stays, in the time unit
+//                         of Insert and Advance
+//      heapType        -- [IN]: MAX for the K largest items, MIN for the K
+//                         smallest
+//
+// ============================================================================
+template <class HeapItemType>
+WindowedTopK<HeapItemType>::WindowedTopK(uint64_t windowLength, int heapType)
+: m_windowLength(windowLength), m_cutoff(0), m_lastTime(0),
+  m_heap(heapType), m_numExpired(0)
+{
+}
+// end of WindowedTopK::WindowedTopK()
+
+
+// ==== WindowedTopK::~WindowedTopK ===========================================
+//
+// This is the destructor.
+//
+// ============================================================================
+template <class HeapItemType>
+WindowedTopK<HeapItemType>::~WindowedTopK()
+{
+}
+// end of WindowedTopK::~WindowedTopK()
+
+
+// ==== WindowedTopK::DropExpiredTops =========================================
+//
+// This function removes expired items from the top of the heap.
+//
+// Input:
+//      void
+//
+// Output:
+//      void
+// ============================================================================
+template <class HeapItemType>
+void WindowedTopK<HeapItemType>::DropExpiredTops(void)
+{
+    EntryType entry;
+
+    while (!m_heap.IsEmpty() && (m_heap.TryPeek()->m_time < m_cutoff))
+    {
+        m_heap.Remove(entry);
+        m_numExpired--;
+    }
+}
+// end of WindowedTopK::DropExpiredTops()
+
+
+// ==== WindowedTopK::Insert ==================================================
+//
+// This function adds an item in O(log n).
+//
+// Input:
+//      item    -- [IN]: the item
+//      time    -- [IN]: its arrival time; times must not decrease, and an
+//                 earlier time counts as the latest one seen
+//
+// Output:
+//      bool -- [OUT]: false if the item is already past the window
+// ============================================================================
+template <class HeapItemType>
+bool WindowedTopK<HeapItemType>::Insert(const HeapItemType &item, uint64_t time)
+{
+    if (time < m_cutoff)
+    {
+        return false;
+    }
+
+    EntryType entry;
+    entry.m_item = item;
+    entry.m_time = (time > m_lastTime) ? time : m_lastTime;
+
+    m_heap.Insert(entry);
+    m_liveTimes.push_back(entry.m_time);
+    m_lastTime = entry.m_time;
+
+    return true;
+}
+// end of WindowedTopK::Insert()
+
+
+// ==== WindowedTopK::Advance =================================================
+//
+// This function moves the window to end at now: items that arrived before
+// now - windowLength expire. Expired items at the top are dropped at once
+// and the rest when they outnumber the live items.
+//
+// Input:
+//      now     -- [IN]: the current time; it must not decrease
+//
+// Output:
+//      int -- [OUT]: the number of items that expired
+// ============================================================================
+template <class HeapItemType>
+int WindowedTopK<HeapItemType>::Advance(uint64_t now)
+{
+    int numExpired = 0;
+    uint64_t cutoff = (now > m_windowLength) ? now - m_windowLength : 0;
+
+    if (cutoff > m_cutoff)
+    {
+        m_cutoff = cutoff;
+    }
+
+    while (!m_liveTimes.empty() && (m_liveTimes.front() < m_cutoff))
+    {
+        m_liveTimes.pop_front();
+        numExpired++;
+    }
+    m_numExpired += numExpired;
+
+    DropExpiredTops();
+
+    if ((m_numExpired > TOPK_COMPACT_MIN)
+        && (m_numExpired > static_cast<int>(m_liveTimes.size())))
+    {
+        uint64_t oldest = m_cutoff;
+
+        m_heap.RemoveIf([oldest](const EntryType &entry)
+                        { return (entry.m_time < oldest); });
+        m_numExpired = 0;
+    }
+
+    return numExpired;
+}
+// end of WindowedTopK::Advance()
+
+
+// ==== WindowedTopK::PeekTop =================================================
+//
+// This function returns the best live item.
+//
+// Input:
+//      void
+//
+// Output:
+//      HeapItemType -- [OUT]: the item; CMaxMinHeapException(HEAP_EMPTY) is
+//                      thrown if the window is empty
+// ============================================================================
+template <class HeapItemType>
+HeapItemType WindowedTopK<HeapItemType>::PeekTop(void) const
+{
+    return m_heap.PeekTop().m_item;
+}
+// end of WindowedTopK::PeekTop()
+
+
+// ==== WindowedTopK::TopK ====================================================
+//
+// This function writes the best live items, best first, without changing
+// the structure.
+//
+// Input:
+//      count   -- [IN]: the number of items wanted, K
+//      output  -- [IN]: output iterator receiving HeapItemType values
+//
+// Output:
+//      int -- [OUT]: the number of items written, at most count
+// ============================================================================
+template <class HeapItemType>
+template <class OutputIt>
+int WindowedTopK<HeapItemType>::TopK(int count, OutputIt output) const
+{
+    int numWritten = 0;
+
+    // at most m_numExpired of the items walked are skipped
+    auto view = m_heap.TopView(count + m_numExpired);
+
+    for (auto it = view.begin(); (it != view.end()) && (numWritten < count); ++it)
+    {
+        if (it->m_time >= m_cutoff)
+        {
+            *output++ = it->m_item;
+            numWritten++;
+        }
+    }
+
+    return numWritten;
+}
+// end of WindowedTopK::TopK()
+
+
+// ==== WindowedTopK::GetNumItems =============================================
+//
+// This function returns the number of live items in the window.
+// ============================================================================
+template <class HeapItemType>
+int WindowedTopK<HeapItemType>::GetNumItems(void) const
+{
+    return static_cast<int>(m_liveTimes.size());
+}
+// end of WindowedTopK::GetNumItems()
+
+
+// ==== WindowedTopK::GetNumExpired ===========================================
+//
+// This function returns the number of expired items not yet removed.
+// ============================================================================
+template <class HeapItemType>
+int WindowedTopK<HeapItemType>::GetNumExpired(void) const
+{
+    return m_numExpired;
+}
+// end of WindowedTopK::GetNumExpired()
+
+
+// ==== WindowedTopK::IsEmpty =================================================
+//
+// This function returns a boolean value if the window holds no live item.
+// ============================================================================
+template <class HeapItemType>
+bool WindowedTopK<HeapItemType>::IsEmpty(void) const
+{
+    return m_liveTimes.empty();
+}
+// end of WindowedTopK::IsEmpty()
+
+#endif // WINDOWEDTOPK_H